@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+  File: BatchEngineBenchmark.cpp
+  Responsibility: Compare rendering N independent stereo streams through one
+                  dsp::BatchEngine against N DustboxProcessor instances, one
+                  block of every stream per iteration, and check both render
+                  each stream at about the same level.
+  Assumptions: Both sides get the same per-stream settings. Input is rendered
+               once and only copied inside the timed region, so the ratio is
+               not diluted by sin(). The processors still run their noise
+               generator (at its -60 dB minimum) and parameter smoothing,
+               which the batch engine leaves out, so the ratio is an upper
+               bound on what batching alone buys. The features the batch
+               engine leaves out are at their defaults (off) on the processors,
+               so the level check only allows for the noise floor, the phasor
+               wow and the per-block tone ramp.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/batch/BatchEngine.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int streamCounts[] { 8, 64, 256 };
+
+// Streams 0-15 cover every setting getStreamParameters() spreads. Levels are compared over whole
+// pump cycles (a quarter note at 120 bpm is 0.5 s) after the delay lines have filled.
+constexpr int comparedStreams = 16;
+constexpr int warmUpBlocks = 48;
+constexpr int comparedBlocks = 375;
+constexpr double levelToleranceDb = 1.5;
+
+dsp::BatchStreamParameters getStreamParameters(int stream)
+{
+    // Spread the settings so neighbouring lanes never share a parameter set.
+    const auto spread = static_cast<float>(stream % 16) / 15.0f;
+    dsp::BatchStreamParameters parameters;
+    parameters.tape.wowDepth = 0.05f + 0.4f * spread;
+    parameters.tape.wowRateHz = 0.3f + 2.0f * spread;
+    parameters.tape.toneLowpassHz = 4000.0f + 12000.0f * spread;
+    parameters.dirt.saturationAmount = 0.1f + 0.6f * spread;
+    parameters.dirt.bitDepth = 8 + stream % 9;
+    parameters.dirt.sampleRateDiv = 1 + stream % 3;
+    parameters.pump.amount = 0.2f + 0.5f * spread;
+    parameters.wetMix = 0.4f + 0.5f * spread;
+    return parameters;
+}
+
+void setPlainValue(DustboxProcessor& processor, const char* id, float value)
+{
+    auto* parameter = processor.getValueTreeState().getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+void applyToProcessor(DustboxProcessor& processor, const dsp::BatchStreamParameters& parameters)
+{
+    setPlainValue(processor, params::ids::tapeWowDepth, parameters.tape.wowDepth);
+    setPlainValue(processor, params::ids::tapeWowRateHz, parameters.tape.wowRateHz);
+    setPlainValue(processor, params::ids::tapeToneLowpassHz, parameters.tape.toneLowpassHz);
+    setPlainValue(processor, params::ids::tapeNoiseLevelDb, -60.0f);
+    setPlainValue(processor, params::ids::dirtSaturationAmt, parameters.dirt.saturationAmount);
+    setPlainValue(processor, params::ids::dirtBitDepthBits, static_cast<float>(parameters.dirt.bitDepth));
+    setPlainValue(processor, params::ids::dirtSampleRateDiv, static_cast<float>(parameters.dirt.sampleRateDiv));
+    setPlainValue(processor, params::ids::pumpAmount, parameters.pump.amount);
+    setPlainValue(processor, params::ids::mixWet, parameters.wetMix);
+}
+
+/** One block of each stream's sine, starting firstSample samples into the stream. */
+void fillInput(std::vector<juce::AudioBuffer<float>>& buffers, int64_t firstSample)
+{
+    for (size_t stream = 0; stream < buffers.size(); ++stream)
+    {
+        const auto frequency = 110.0 * (1.0 + static_cast<double>(stream % 7));
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffers[stream].getWritePointer(channel);
+            for (int sample = 0; sample < blockSize; ++sample)
+                data[sample] = static_cast<float>(0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency
+                                                                 * static_cast<double>(firstSample + sample) / sampleRate));
+        }
+    }
+}
+
+void copyInput(std::vector<juce::AudioBuffer<float>>& buffers, const std::vector<juce::AudioBuffer<float>>& sources)
+{
+    for (size_t stream = 0; stream < buffers.size(); ++stream)
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffers[stream].copyFrom(channel, 0, sources[stream], channel, 0, blockSize);
+}
+
+std::vector<juce::AudioBuffer<float>> makeBuffers(int numStreams)
+{
+    std::vector<juce::AudioBuffer<float>> buffers;
+    for (int stream = 0; stream < numStreams; ++stream)
+        buffers.emplace_back(numChannels, blockSize);
+
+    return buffers;
+}
+
+std::vector<std::unique_ptr<DustboxProcessor>> makeProcessors(int numStreams)
+{
+    std::vector<std::unique_ptr<DustboxProcessor>> processors;
+    for (int stream = 0; stream < numStreams; ++stream)
+    {
+        processors.push_back(std::make_unique<DustboxProcessor>());
+        applyToProcessor(*processors.back(), getStreamParameters(stream));
+        processors.back()->prepareToPlay(sampleRate, blockSize);
+    }
+
+    return processors;
+}
+
+void prepareEngine(dsp::BatchEngine& engine, int numStreams)
+{
+    engine.prepare(sampleRate, blockSize, numStreams, numChannels);
+    for (int stream = 0; stream < numStreams; ++stream)
+        engine.setParameters(stream, getStreamParameters(stream));
+}
+
+std::vector<float*> getChannelPointers(std::vector<juce::AudioBuffer<float>>& buffers)
+{
+    std::vector<float*> channels;
+    for (auto& buffer : buffers)
+        for (int channel = 0; channel < numChannels; ++channel)
+            channels.push_back(buffer.getWritePointer(channel));
+
+    return channels;
+}
+
+void accumulateEnergy(const std::vector<juce::AudioBuffer<float>>& buffers, std::vector<double>& energy)
+{
+    for (size_t stream = 0; stream < buffers.size(); ++stream)
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < blockSize; ++sample)
+                energy[stream] += juce::square(static_cast<double>(buffers[stream].getSample(channel, sample)));
+}
+
+void runStreamCount(Reporter& reporter, int numStreams)
+{
+    const auto iterations = juce::jmax(20, 4096 / numStreams);
+    const auto label = juce::String(numStreams) + " streams";
+
+    auto sources = makeBuffers(numStreams);
+    auto buffers = makeBuffers(numStreams);
+    fillInput(sources, 0);
+
+    Statistics processorStatistics;
+    {
+        auto processors = makeProcessors(numStreams);
+
+        juce::MidiBuffer midi;
+        processorStatistics = measure(iterations, [&]
+        {
+            copyInput(buffers, sources);
+            for (int stream = 0; stream < numStreams; ++stream)
+                processors[static_cast<size_t>(stream)]->processBlock(buffers[static_cast<size_t>(stream)], midi);
+        });
+        reporter.add("processors, " + label, processorStatistics);
+
+        for (auto& processor : processors)
+            processor->releaseResources();
+    }
+
+    dsp::BatchEngine engine;
+    prepareEngine(engine, numStreams);
+    const auto channels = getChannelPointers(buffers);
+
+    const auto batchStatistics = measure(iterations, [&]
+    {
+        copyInput(buffers, sources);
+        engine.process(channels.data(), blockSize);
+    });
+    reporter.add("batch engine, " + label, batchStatistics);
+
+    if (batchStatistics.meanMicros > 0.0)
+        reporter.note("batch engine, " + label, juce::String(processorStatistics.meanMicros / batchStatistics.meanMicros, 2)
+                                                    + "x the processors' throughput, "
+                                                    + juce::String(dsp::BatchEngine::streamsPerVector) + " streams per vector");
+}
+
+/** Renders the same continuous input through both and compares each stream's output level. */
+void runLevelComparison(Reporter& reporter)
+{
+    const juce::String caseName { "batch vs processors, output level" };
+
+    auto processors = makeProcessors(comparedStreams);
+    auto processorBuffers = makeBuffers(comparedStreams);
+    std::vector<double> processorEnergy(static_cast<size_t>(comparedStreams), 0.0);
+
+    dsp::BatchEngine engine;
+    prepareEngine(engine, comparedStreams);
+    auto batchBuffers = makeBuffers(comparedStreams);
+    const auto channels = getChannelPointers(batchBuffers);
+    std::vector<double> batchEnergy(static_cast<size_t>(comparedStreams), 0.0);
+
+    juce::MidiBuffer midi;
+    for (int block = 0; block < warmUpBlocks + comparedBlocks; ++block)
+    {
+        const auto firstSample = static_cast<int64_t>(block) * blockSize;
+        fillInput(processorBuffers, firstSample);
+        fillInput(batchBuffers, firstSample);
+
+        for (int stream = 0; stream < comparedStreams; ++stream)
+            processors[static_cast<size_t>(stream)]->processBlock(processorBuffers[static_cast<size_t>(stream)], midi);
+
+        engine.process(channels.data(), blockSize);
+
+        if (block >= warmUpBlocks)
+        {
+            accumulateEnergy(processorBuffers, processorEnergy);
+            accumulateEnergy(batchBuffers, batchEnergy);
+        }
+    }
+
+    for (auto& processor : processors)
+        processor->releaseResources();
+
+    double worstDifferenceDb = 0.0;
+    int worstStream = 0;
+    for (size_t stream = 0; stream < processorEnergy.size(); ++stream)
+    {
+        // Energy ratio to dB; the floor keeps a silent stream from dividing by zero.
+        const auto differenceDb = 10.0 * std::log10((batchEnergy[stream] + 1.0e-12) / (processorEnergy[stream] + 1.0e-12));
+        if (std::abs(differenceDb) > std::abs(worstDifferenceDb) || ! std::isfinite(differenceDb))
+        {
+            worstDifferenceDb = differenceDb;
+            worstStream = static_cast<int>(stream);
+        }
+    }
+
+    reporter.note(caseName, "largest level difference " + juce::String(worstDifferenceDb, 2) + " dB (stream "
+                                + juce::String(worstStream) + ")");
+
+    if (! std::isfinite(worstDifferenceDb) || std::abs(worstDifferenceDb) > levelToleranceDb)
+        reporter.fail(caseName, "stream " + juce::String(worstStream) + " differs by " + juce::String(worstDifferenceDb, 2)
+                                    + " dB, more than " + juce::String(levelToleranceDb, 1) + " dB");
+}
+
+void runBatchEngine(Reporter& reporter)
+{
+    for (const auto numStreams : streamCounts)
+        runStreamCount(reporter, numStreams);
+
+    runLevelComparison(reporter);
+}
+
+const Registration registration { "batch-engine", &runBatchEngine };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+  File: BenchmarkHarness.cpp
+  Responsibility: Implement benchmark registration and result reporting.
+  Assumptions: Registrations happen during static initialisation, before main().
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include <cstdio>
+
+namespace dustbox::bench
+{
+namespace
+{
+std::vector<RegisteredBenchmark>& getMutableRegistry()
+{
+    static std::vector<RegisteredBenchmark> registry;
+    return registry;
+}
+
+int numFailures = 0;
+} // namespace
+
+Registration::Registration(const char* suiteName, BenchmarkFunction function)
+{
+    getMutableRegistry().push_back({ suiteName, function });
+}
+
+const std::vector<RegisteredBenchmark>& getRegisteredBenchmarks()
+{
+    return getMutableRegistry();
+}
+
+int getNumFailures()
+{
+    return numFailures;
+}
+
+void Reporter::add(const juce::String& caseName, const Statistics& statistics)
+{
+    const auto fullName = suiteName + "/" + caseName;
+    std::printf("%-56s %8d it  mean %10.2f us  p99 %10.2f us  worst %10.2f us\n",
+                fullName.toRawUTF8(),
+                statistics.iterations,
+                statistics.meanMicros,
+                statistics.p99Micros,
+                statistics.worstMicros);
+    std::fflush(stdout);
+}
+
+void Reporter::note(const juce::String& caseName, const juce::String& text)
+{
+    const auto fullName = suiteName + "/" + caseName;
+    std::printf("%-56s %s\n", fullName.toRawUTF8(), text.toRawUTF8());
+    std::fflush(stdout);
+}
+
+void Reporter::fail(const juce::String& caseName, const juce::String& text)
+{
+    ++numFailures;
+    const auto fullName = suiteName + "/" + caseName;
+    std::printf("%-56s FAILED: %s\n", fullName.toRawUTF8(), text.toRawUTF8());
+    std::fflush(stdout);
+}
+} // namespace dustbox::bench
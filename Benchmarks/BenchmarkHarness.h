@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+  File: BenchmarkHarness.h
+  Responsibility: Provide timing, statistics, and suite registration helpers for
+                  the headless Dustbox benchmark runner.
+  Assumptions: Benchmarks run single-threaded on the calling thread with the
+               JUCE message manager initialised by BenchmarkMain.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace dustbox::bench
+{
+struct Statistics
+{
+    int iterations { 0 };
+    double meanMicros { 0.0 };
+    double p99Micros { 0.0 };
+    double worstMicros { 0.0 };
+};
+
+/** Collects named results and prints them as an aligned table. */
+class Reporter
+{
+public:
+    void add(const juce::String& caseName, const Statistics& statistics);
+    void note(const juce::String& caseName, const juce::String& text);
+    /** Prints a failure; the runner exits non-zero if any suite reported one. */
+    void fail(const juce::String& caseName, const juce::String& text);
+
+    void setSuiteName(juce::String name) { suiteName = std::move(name); }
+
+private:
+    juce::String suiteName;
+};
+
+/** Mean, 99th percentile and worst of a set of per-call timings in microseconds. */
+inline Statistics summarise(std::vector<double> samples)
+{
+    Statistics statistics;
+    statistics.iterations = static_cast<int>(samples.size());
+
+    if (samples.empty())
+        return statistics;
+
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const auto sample : samples)
+        sum += sample;
+
+    const auto p99Index = juce::jmin(samples.size() - 1, (samples.size() * 99) / 100);
+    statistics.meanMicros = sum / static_cast<double>(samples.size());
+    statistics.p99Micros = samples[p99Index];
+    statistics.worstMicros = samples.back();
+    return statistics;
+}
+
+/** Runs the function once per iteration after a short warm-up and returns per-call timings. */
+template <typename Function>
+Statistics measure(int iterations, Function&& function)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int warmUpIterations = juce::jmax(1, iterations / 10);
+    for (int i = 0; i < warmUpIterations; ++i)
+        function();
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto start = Clock::now();
+        function();
+        const auto end = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    return summarise(std::move(samples));
+}
+
+/** Fills every channel with the same 220 Hz sine at half scale, continuing from phase. */
+template <typename SampleType>
+void fillWithSine(juce::AudioBuffer<SampleType>& buffer, double& phase, double sampleRate)
+{
+    const auto increment = juce::MathConstants<double>::twoPi * 220.0 / sampleRate;
+
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    {
+        const auto value = static_cast<SampleType>(0.5 * std::sin(phase));
+        phase += increment;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.setSample(channel, sample, value);
+    }
+}
+
+/** Gives the processor one input and one output bus of the same layout; false if it refuses. */
+inline bool setMatchingBuses(juce::AudioProcessor& processor, const juce::AudioChannelSet& layout)
+{
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout);
+    buses.outputBuses.add(layout);
+    return processor.setBusesLayout(buses);
+}
+
+using BenchmarkFunction = void (*)(Reporter&);
+
+/** Static registration hook; each benchmark translation unit declares one instance. */
+struct Registration
+{
+    Registration(const char* suiteName, BenchmarkFunction function);
+};
+
+struct RegisteredBenchmark
+{
+    const char* suiteName;
+    BenchmarkFunction function;
+};
+
+const std::vector<RegisteredBenchmark>& getRegisteredBenchmarks();
+
+/** Failures reported through any Reporter so far. */
+int getNumFailures();
+} // namespace dustbox::bench
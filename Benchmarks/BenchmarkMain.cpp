@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+  File: BenchmarkMain.cpp
+  Responsibility: Entry point for the headless Dustbox benchmark runner.
+  Assumptions: Runs without a display; editors are painted into offscreen images.
+  Usage: DustboxBenchmarks [--list] [--trace <file.json>] [suite-filter ...]
+         DustboxBenchmarks --replay <capture.dbxcap> [--trace <file.json>]
+         --trace records every selected suite into one Chrome trace-event
+         file that chrome://tracing or ui.perfetto.dev opens. --replay feeds
+         a session capture through a fresh processor instead of running the
+         suites.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+#include "SessionReplay.h"
+
+#include "Core/TraceRecorder.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <juce_events/juce_events.h>
+
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray filters;
+    juce::String tracePath;
+    juce::String replayPath;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument { argv[i] };
+        if (argument == "--list")
+            listOnly = true;
+        else if (argument == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (argument == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else
+            filters.add(argument);
+    }
+
+    // Held for the whole run so every processor the suites create shares this recorder.
+    const juce::SharedResourcePointer<dustbox::TraceRecorder> traceRecorder;
+    const auto traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(tracePath);
+
+    if (tracePath.isNotEmpty() && ! listOnly && ! traceRecorder->start(traceFile))
+    {
+        std::fprintf(stderr, "Cannot write trace file %s\n", traceFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    if (replayPath.isNotEmpty() && ! listOnly)
+    {
+        const auto replayFile = juce::File::getCurrentWorkingDirectory().getChildFile(replayPath);
+        dustbox::DustboxProcessor processor;
+        dustbox::bench::Reporter reporter;
+        reporter.setSuiteName("replay");
+        dustbox::bench::reportReplay(reporter, replayFile.getFileName(), dustbox::bench::replaySession(replayFile, processor));
+    }
+    else
+    {
+        for (const auto& benchmark : dustbox::bench::getRegisteredBenchmarks())
+        {
+            const juce::String suiteName { benchmark.suiteName };
+
+            if (listOnly)
+            {
+                std::printf("%s\n", suiteName.toRawUTF8());
+                continue;
+            }
+
+            bool selected = filters.isEmpty();
+            for (const auto& filter : filters)
+                selected = selected || suiteName.containsIgnoreCase(filter);
+
+            if (! selected)
+                continue;
+
+            dustbox::bench::Reporter reporter;
+            reporter.setSuiteName(suiteName);
+            benchmark.function(reporter);
+        }
+    }
+
+    if (traceRecorder->isRecording())
+    {
+        traceRecorder->stop();
+        std::printf("Trace written to %s (%llu events dropped)\n", traceFile.getFullPathName().toRawUTF8(),
+                    static_cast<unsigned long long>(traceRecorder->getDroppedEventCount()));
+    }
+
+    return dustbox::bench::getNumFailures() > 0 ? 1 : 0;
+}
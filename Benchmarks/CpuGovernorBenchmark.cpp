@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+  File: CpuGovernorBenchmark.cpp
+  Responsibility: Show what each governed quality tier saves on the most
+                  expensive Dirt settings, and what load the processor itself
+                  reports for them.
+  Assumptions: The tier cases mirror the caps the processor applies (reduced:
+               2x oversampling and the balanced resampler; minimal: neither),
+               padded back to the uncapped latency as the processor does.
+               Benchmark machines are usually far inside the deadline, so the
+               processor case reports load rather than forcing a step down.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/modules/DirtModule.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 5000;
+
+dsp::DirtParameters makeTierParameters(int oversamplingStages, dsp::ResamplerQuality quality)
+{
+    dsp::DirtParameters requested;
+    requested.saturationAmount = 0.8f;
+    requested.targetSampleRate = 11025.0;
+    requested.resamplerQuality = dsp::ResamplerQuality::high;
+    requested.oversamplingStages = 3;
+
+    auto capped = requested;
+    capped.oversamplingStages = oversamplingStages;
+    capped.resamplerQuality = quality;
+    capped.latencyCompensation = dsp::DirtModule<float>::getLatencySamples(requested, sampleRate)
+                                 - dsp::DirtModule<float>::getLatencySamples(capped, sampleRate);
+    return capped;
+}
+
+void measureDirtTier(Reporter& reporter, const juce::String& caseName, const dsp::DirtParameters& parameters)
+{
+    dsp::DirtModule<float> dirt;
+    dirt.prepare(sampleRate, blockSize, numChannels);
+    dirt.setParameters(parameters);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    double phase = 0.0;
+
+    const auto statistics = measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        dirt.processBlock(buffer, blockSize);
+    });
+    reporter.add(caseName, statistics);
+
+    const auto deadlineMicros = 1.0e6 * blockSize / sampleRate;
+    reporter.note(caseName, "latency " + juce::String(dsp::DirtModule<float>::getLatencySamples(parameters, sampleRate))
+                                + " samples, " + juce::String(100.0 * statistics.meanMicros / deadlineMicros, 2)
+                                + " % of the deadline");
+}
+
+void measureGovernedProcessor(Reporter& reporter, const juce::String& caseName)
+{
+    DustboxProcessor processor;
+
+    auto& state = processor.getValueTreeState();
+    auto setChoice = [&state](const char* id, int index)
+    {
+        auto* parameter = state.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(index)));
+    };
+    setChoice(params::ids::dirtOversampling, 3);    // 8x
+    setChoice(params::ids::dirtTargetRate, 2);      // 11025
+    setChoice(params::ids::dirtResampleQuality, 2); // high
+    setChoice(params::ids::cpuBudget, 1);           // 10%
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    const auto tier = processor.getQualityTier();
+    const auto tierName = tier == dsp::QualityTier::minimal ? "minimal" : (tier == dsp::QualityTier::reduced ? "reduced" : "standard");
+    reporter.note(caseName, "reported load " + juce::String(100.0f * processor.getCpuLoad(), 2) + " %, tier " + tierName
+                                + ", latency " + juce::String(processor.getLatencySamples()) + " samples");
+
+    processor.releaseResources();
+}
+
+void runCpuGovernorBenchmark(Reporter& reporter)
+{
+    measureDirtTier(reporter, "dirt-standard", makeTierParameters(3, dsp::ResamplerQuality::high));
+    measureDirtTier(reporter, "dirt-reduced", makeTierParameters(1, dsp::ResamplerQuality::balanced));
+    measureDirtTier(reporter, "dirt-minimal", makeTierParameters(0, dsp::ResamplerQuality::fast));
+    measureGovernedProcessor(reporter, "processor-10%-budget");
+}
+
+const Registration registration { "cpu-governor", &runCpuGovernorBenchmark };
+} // namespace
+} // namespace dustbox::bench
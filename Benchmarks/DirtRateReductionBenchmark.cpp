@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+  File: DirtRateReductionBenchmark.cpp
+  Responsibility: Compare the cost and the alias rejection of DirtModule's
+                  integer sample-and-hold divider with the fractional
+                  target-rate resampler at each quality.
+  Assumptions: Leakage is the output level of a tone above the reduced rate's
+               Nyquist relative to its input level, so lower is better; an
+               unfiltered hold folds it back almost unattenuated.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/modules/DirtModule.h"
+
+#include <cmath>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 20000;
+
+constexpr double targetRate = 11025.0;
+constexpr int divider = 4; // 12 kHz at 48 kHz, the divider setting closest to the target.
+constexpr double outOfBandHz = 8000.0;
+
+dsp::DirtParameters makeParameters(double target, dsp::ResamplerQuality quality)
+{
+    dsp::DirtParameters parameters;
+    parameters.saturationAmount = 0.0f;
+    parameters.bitDepth = 24; // Shaper and quantiser off, so only rate reduction is measured.
+    parameters.sampleRateDiv = divider;
+    parameters.targetSampleRate = target;
+    parameters.resamplerQuality = quality;
+    return parameters;
+}
+
+void fillWithTone(juce::AudioBuffer<float>& buffer, double& phase)
+{
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    {
+        const auto value = static_cast<float>(0.5 * std::sin(phase));
+        phase += juce::MathConstants<double>::twoPi * outOfBandHz / sampleRate;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.setSample(channel, sample, value);
+    }
+}
+
+/** Output over input RMS in dB, measured after the filters have settled. */
+double measureLeakage(const dsp::DirtParameters& parameters)
+{
+    dsp::DirtModule<float> dirt;
+    dirt.prepare(sampleRate, blockSize, 1);
+    dirt.setParameters(parameters);
+
+    juce::AudioBuffer<float> buffer(1, blockSize);
+    double phase = 0.0;
+    double inputEnergy = 0.0;
+    double outputEnergy = 0.0;
+
+    for (int block = 0; block < 64; ++block)
+    {
+        fillWithTone(buffer, phase);
+        const auto input = buffer.getRMSLevel(0, 0, blockSize);
+        dirt.processBlock(buffer, blockSize);
+
+        if (block >= 16)
+        {
+            inputEnergy += static_cast<double>(input) * input;
+            outputEnergy += static_cast<double>(buffer.getRMSLevel(0, 0, blockSize)) * buffer.getRMSLevel(0, 0, blockSize);
+        }
+    }
+
+    return 10.0 * std::log10(juce::jmax(outputEnergy, 1.0e-20) / inputEnergy);
+}
+
+void measureSetting(Reporter& reporter, const juce::String& caseName, const dsp::DirtParameters& parameters)
+{
+    dsp::DirtModule<float> dirt;
+    dirt.prepare(sampleRate, blockSize, numChannels);
+    dirt.setParameters(parameters);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithTone(buffer, phase);
+        dirt.processBlock(buffer, blockSize);
+    }));
+
+    reporter.note(caseName, "leakage " + juce::String(measureLeakage(parameters), 1) + " dB, latency "
+                                + juce::String(dsp::DirtModule<float>::getLatencySamples(parameters, sampleRate))
+                                + " samples");
+}
+
+void runDirtRateReductionBenchmark(Reporter& reporter)
+{
+    measureSetting(reporter, "divider-4", makeParameters(0.0, dsp::ResamplerQuality::fast));
+    measureSetting(reporter, "target-11025-fast", makeParameters(targetRate, dsp::ResamplerQuality::fast));
+    measureSetting(reporter, "target-11025-balanced", makeParameters(targetRate, dsp::ResamplerQuality::balanced));
+    measureSetting(reporter, "target-11025-high", makeParameters(targetRate, dsp::ResamplerQuality::high));
+}
+
+const Registration registration { "dirt-rate-reduction", &runDirtRateReductionBenchmark };
+} // namespace
+} // namespace dustbox::bench
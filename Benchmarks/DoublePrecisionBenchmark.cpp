@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+  File: DoublePrecisionBenchmark.cpp
+  Responsibility: Compare the float and double processBlock paths, and the
+                  double path against a host converting around the float one.
+  Assumptions: Each case uses its own prepared processor so the precision is
+               fixed before prepareToPlay, as hosts do.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 20000;
+
+void runDoublePrecisionBenchmark(Reporter& reporter)
+{
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    {
+        DustboxProcessor processor;
+        processor.setProcessingPrecision(juce::AudioProcessor::singlePrecision);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        reporter.add("float-block", measure(iterations, [&]
+        {
+            fillWithSine(buffer, phase, sampleRate);
+            processor.processBlock(buffer, midi);
+        }));
+
+        // What a 64-bit host does for a float-only plugin: convert in, process, convert back.
+        juce::AudioBuffer<double> hostBuffer(numChannels, blockSize);
+        reporter.add("double-host-converting-to-float", measure(iterations, [&]
+        {
+            fillWithSine(hostBuffer, phase, sampleRate);
+            buffer.makeCopyOf(hostBuffer, true);
+            processor.processBlock(buffer, midi);
+            hostBuffer.makeCopyOf(buffer, true);
+        }));
+
+        processor.releaseResources();
+    }
+
+    {
+        DustboxProcessor processor;
+        processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<double> buffer(numChannels, blockSize);
+        reporter.add("double-block", measure(iterations, [&]
+        {
+            fillWithSine(buffer, phase, sampleRate);
+            processor.processBlock(buffer, midi);
+        }));
+
+        processor.releaseResources();
+    }
+}
+
+const Registration registration { "double-precision", &runDoublePrecisionBenchmark };
+} // namespace
+} // namespace dustbox::bench
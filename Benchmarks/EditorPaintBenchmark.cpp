@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+  File: EditorPaintBenchmark.cpp
+  Responsibility: Measure per-frame paint cost of the Dustbox editor and its
+                  animated widgets by rendering into offscreen images, both
+                  whole frames and the dirty-rect repaints the meters and the
+                  profiler overlay cause while the editor is open.
+  Assumptions: No native peer is created; paintEntireComponent() drives the
+               same paint() paths the host window would. A dirty-rect frame
+               clips the editor to the animated widgets' bounds, as a peer
+               does when only they called repaint(), so the editor's own
+               paint() and any overlapping siblings are part of its cost.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxEditor.h"
+#include "Plugin/DustboxProcessor.h"
+#include "Ui/GenericControls.h"
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <memory>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int frameIterations = 600;
+
+template <typename Component>
+Statistics measureWidgetFrames(Component& component, float scale, void (*advance)(Component&, int))
+{
+    juce::Image target(juce::Image::ARGB,
+                       juce::roundToInt(static_cast<float>(component.getWidth()) * scale),
+                       juce::roundToInt(static_cast<float>(component.getHeight()) * scale),
+                       true);
+    int frame = 0;
+
+    return measure(frameIterations, [&]
+    {
+        advance(component, frame++);
+        juce::Graphics g(target);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        component.paintEntireComponent(g, false);
+    });
+}
+
+void advanceMeter(ui::LevelMeter& meter, int frame)
+{
+    const auto t = static_cast<float>(frame % 60) / 60.0f;
+    meter.setLevels(t, t * 0.7f, frame % 120 == 0);
+}
+
+void advanceTempo(ui::HostTempoDisplay& display, int frame)
+{
+    display.setTempo(120.0, "1/8", static_cast<double>(frame % 90) / 90.0);
+}
+
+/** Visible descendants of type Widget, in depth-first order. */
+template <typename Widget>
+void findVisibleWidgets(juce::Component& parent, juce::Array<Widget*>& widgets)
+{
+    for (auto* child : parent.getChildren())
+    {
+        if (! child->isVisible())
+            continue;
+
+        if (auto* widget = dynamic_cast<Widget*>(child))
+            widgets.add(widget);
+
+        findVisibleWidgets(*child, widgets);
+    }
+}
+
+/** Repaints only the given editor-space region each frame, after advance() updates its widgets. */
+template <typename Advance>
+Statistics measureDirtyFrames(juce::Component& editor, const juce::RectangleList<int>& dirty, float scale, Advance&& advance)
+{
+    juce::Image target(juce::Image::ARGB,
+                       juce::roundToInt(static_cast<float>(editor.getWidth()) * scale),
+                       juce::roundToInt(static_cast<float>(editor.getHeight()) * scale),
+                       true);
+    int frame = 0;
+
+    return measure(frameIterations, [&]
+    {
+        advance(frame++);
+        juce::Graphics g(target);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        g.reduceClipRegion(dirty);
+        editor.paintEntireComponent(g, false);
+    });
+}
+
+/** Runs a few blocks with the stage profiler on, so the overlay has real bars to draw. */
+void fillProfilerHistory(DustboxProcessor& processor)
+{
+    processor.getStageProfiler().setEnabled(true);
+
+    juce::AudioBuffer<float> buffer { 2, 512 };
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+    for (int block = 0; block < 64; ++block)
+    {
+        fillWithSine(buffer, phase, 48000.0);
+        processor.processBlock(buffer, midi);
+    }
+
+    // The history is kept while disabled, and the editor's profile button starts off.
+    processor.getStageProfiler().setEnabled(false);
+}
+
+void noteShareOfFullFrame(Reporter& reporter, const juce::String& caseName, const Statistics& dirty, const Statistics& full)
+{
+    if (full.meanMicros > 0.0)
+        reporter.note(caseName, juce::String(100.0 * dirty.meanMicros / full.meanMicros, 1) + " % of a full frame");
+}
+
+void runEditorPaintBenchmark(Reporter& reporter)
+{
+    DustboxProcessor processor;
+    processor.prepareToPlay(48000.0, 512);
+
+    fillProfilerHistory(processor);
+
+    auto editor = std::make_unique<DustboxEditor>(processor);
+    editor->ensureSectionsBuilt();
+    editor->setSize(820, 640);
+
+    juce::Array<ui::LevelMeter*> meters;
+    findVisibleWidgets(*editor, meters);
+
+    juce::RectangleList<int> meterBounds;
+    for (auto* meter : meters)
+        meterBounds.add(editor->getLocalArea(meter, meter->getLocalBounds()));
+
+    // Hidden until profiling is switched on, so it is looked up directly rather than by visibility.
+    ui::ProfilerOverlay* overlay = nullptr;
+    for (auto* child : editor->getChildren())
+        if (overlay == nullptr)
+            overlay = dynamic_cast<ui::ProfilerOverlay*>(child);
+
+    for (const auto scale : { 1.0f, 2.0f })
+    {
+        const auto suffix = "@" + juce::String(scale, 0) + "x";
+
+        juce::Image target(juce::Image::ARGB,
+                           juce::roundToInt(static_cast<float>(editor->getWidth()) * scale),
+                           juce::roundToInt(static_cast<float>(editor->getHeight()) * scale),
+                           true);
+
+        const auto fullFrame = measure(120, [&]
+        {
+            juce::Graphics g(target);
+            g.addTransform(juce::AffineTransform::scale(scale));
+            editor->paintEntireComponent(g, false);
+        });
+        reporter.add("editor-full-frame" + suffix, fullFrame);
+
+        // What the meter timer costs on its own: every meter moves, only their bounds repaint.
+        const auto meterFrames = measureDirtyFrames(*editor, meterBounds, scale, [&](int frame)
+        {
+            for (auto* meter : meters)
+                advanceMeter(*meter, frame);
+        });
+        reporter.add("editor-dirty-meters" + suffix, meterFrames);
+        noteShareOfFullFrame(reporter, "editor-dirty-meters" + suffix, meterFrames, fullFrame);
+
+        if (meters.isEmpty())
+            reporter.fail("editor-dirty-meters" + suffix, "the editor shows no level meters");
+
+        if (overlay == nullptr)
+        {
+            reporter.fail("editor-dirty-overlay" + suffix, "the editor has no profiler overlay");
+        }
+        else
+        {
+            // Shown as if the profile button were on; every frame gets a fresh snapshot, as the timer does.
+            overlay->setVisible(true);
+
+            const juce::RectangleList<int> overlayBounds { overlay->getBounds() };
+            const auto snapshot = processor.getStageProfiler().getSnapshot();
+            const auto overlayFrames = measureDirtyFrames(*editor, overlayBounds, scale, [&](int)
+            {
+                overlay->setSnapshot(snapshot);
+            });
+            reporter.add("editor-dirty-overlay" + suffix, overlayFrames);
+            noteShareOfFullFrame(reporter, "editor-dirty-overlay" + suffix, overlayFrames, fullFrame);
+
+            overlay->setVisible(false);
+        }
+
+        ui::LevelMeter meter;
+        meter.setSize(40, 180);
+        reporter.add("level-meter-frame" + suffix, measureWidgetFrames(meter, scale, &advanceMeter));
+
+        ui::HostTempoDisplay tempo;
+        tempo.setSize(220, 90);
+        reporter.add("tempo-display-frame" + suffix, measureWidgetFrames(tempo, scale, &advanceTempo));
+    }
+
+    editor.reset();
+    processor.releaseResources();
+}
+
+const Registration registration { "editor-paint", &runEditorPaintBenchmark };
+} // namespace
+} // namespace dustbox::bench
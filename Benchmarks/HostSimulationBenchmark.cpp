@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+  File: HostSimulationBenchmark.cpp
+  Responsibility: Drive the processor the way real hosts do: changing block
+                  sizes (including empty and oversized blocks), sample-rate
+                  changes through prepare/release cycles, bypass toggles,
+                  program changes, state reloads and parameter storms. Record
+                  the worst block time and fail on non-finite output or on any
+                  allocation or lock inside processBlock.
+  Assumptions: One thread plays both host roles; message-thread work happens
+               between blocks, and only processBlock runs marked as the audio
+               callback. Scenarios also run on surround buses, whose lanes go
+               through the lane worker pool slice by slice when a block is
+               oversized; the workers' shares inherit the callback's mark. The
+               random scenario uses a fixed seed so a failure can be replayed.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+#include "RealtimeSafetyChecker.h"
+
+#include "Core/RealtimeSafety.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int maxChannels = 12;
+constexpr int maxHostBlockSize = 8192;
+constexpr juce::int64 randomSeed = 0x0d57b0c5;
+constexpr int randomSessions = 24;
+constexpr int blocksPerSession = 400;
+constexpr int maxReportedTraces = 8;
+
+constexpr double sampleRates[] { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+constexpr int preparedBlockSizes[] { 16, 64, 128, 256, 441, 512, 1024, 2048 };
+
+/** Buses a host may hand the plugin; the surround ones split into lanes. */
+std::vector<juce::AudioChannelSet> getHostLayouts()
+{
+    return { juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create5point1(),
+             juce::AudioChannelSet::create7point1(), juce::AudioChannelSet::create7point1point4() };
+}
+
+bool hasNonFiniteSample(const juce::AudioBuffer<float>& buffer)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            if (! std::isfinite(buffer.getSample(channel, sample)))
+                return true;
+
+    return false;
+}
+
+class HostSimulation
+{
+public:
+    HostSimulation()
+        : storage(maxChannels, maxHostBlockSize)
+    {
+    }
+
+    /** Hosts only change the bus layout while the plugin is released. */
+    bool prepare(double sampleRate, int blockSize, const juce::AudioChannelSet& layout)
+    {
+        if (layout != currentLayout)
+        {
+            if (! setMatchingBuses(processor, layout))
+                return false;
+
+            currentLayout = layout;
+        }
+
+        currentSampleRate = sampleRate;
+        processor.prepareToPlay(sampleRate, blockSize);
+        return true;
+    }
+
+    void release() { processor.releaseResources(); }
+
+    /** Runs one audio callback of numSamples as the host's audio thread. */
+    void processBlock(int numSamples)
+    {
+        view.setDataToReferTo(storage.getArrayOfWritePointers(), currentLayout.size(), numSamples);
+        fillWithSine(view, phase, currentSampleRate);
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            const auto audioCallback = ScopedRealtimeSection::always();
+            processor.processBlock(view, midi);
+        }
+        const auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        blockMicros.push_back(micros);
+        if (numSamples > 0)
+            worstDeadlineShare = juce::jmax(worstDeadlineShare, micros * 1.0e-6 * currentSampleRate / numSamples);
+
+        if (hasNonFiniteSample(view))
+            ++nonFiniteBlocks;
+    }
+
+    void changeProgram(int index) { processor.setCurrentProgram(index % processor.getNumPrograms()); }
+
+    void reloadState()
+    {
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+        processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+
+    void toggleBypass()
+    {
+        auto* bypass = processor.getValueTreeState().getParameter(params::ids::hardBypass);
+        bypass->setValueNotifyingHost(bypass->getValue() > 0.5f ? 0.0f : 1.0f);
+    }
+
+    /** Every parameter jumps to a random value at once, as a host automating all lanes would. */
+    void parameterStorm(juce::Random& random)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    void report(Reporter& reporter, const juce::String& caseName)
+    {
+        const auto violations = getRealtimeViolations();
+        reporter.add(caseName, summarise(blockMicros));
+        reporter.note(caseName, "worst block used " + juce::String(100.0 * worstDeadlineShare, 1) + " % of its deadline");
+
+        if (violations.allocations + violations.deallocations > 0)
+            reporter.fail(caseName, juce::String(static_cast<juce::int64>(violations.allocations)) + " allocations and "
+                                        + juce::String(static_cast<juce::int64>(violations.deallocations))
+                                        + " frees inside processBlock");
+
+        if (violations.locks > 0)
+            reporter.fail(caseName, juce::String(static_cast<juce::int64>(violations.locks)) + " mutex locks inside processBlock");
+        else if (! canDetectLocks())
+            reporter.note(caseName, "lock detection is not available on this platform");
+
+        if (nonFiniteBlocks > 0)
+            reporter.fail(caseName, juce::String(nonFiniteBlocks) + " blocks with non-finite output");
+
+        for (const auto& trace : describeRealtimeViolations(maxReportedTraces))
+            reporter.note(caseName, trace);
+    }
+
+private:
+    DustboxProcessor processor;
+    juce::AudioBuffer<float> storage;
+    juce::AudioBuffer<float> view;
+    juce::MidiBuffer midi;
+    std::vector<double> blockMicros;
+    juce::AudioChannelSet currentLayout { juce::AudioChannelSet::stereo() };
+    double currentSampleRate { 48000.0 };
+    double phase { 0.0 };
+    double worstDeadlineShare { 0.0 };
+    int nonFiniteBlocks { 0 };
+};
+
+void runScripted(Reporter& reporter, const juce::AudioChannelSet& layout)
+{
+    const auto caseName = "scripted-" + juce::String(layout.size()) + "ch";
+    resetRealtimeViolations();
+    HostSimulation host;
+
+    // Block sizes hosts really send: the announced size, empty flushes, single samples, odd
+    // remainders, and blocks larger than announced.
+    constexpr int blockSizes[] { 512, 0, 1, 37, 511, 512, 1024, 4096, 3, 512 };
+
+    if (! host.prepare(48000.0, 512, layout))
+    {
+        reporter.fail(caseName, "layout rejected");
+        return;
+    }
+
+    for (const auto size : blockSizes)
+        host.processBlock(size);
+
+    host.toggleBypass();
+    for (int block = 0; block < 40; ++block)
+        host.processBlock(block % 2 == 0 ? 512 : 128);
+
+    host.toggleBypass();
+    host.changeProgram(1);
+    for (int block = 0; block < 40; ++block)
+        host.processBlock(256);
+
+    host.reloadState();
+    for (int block = 0; block < 40; ++block)
+        host.processBlock(512);
+
+    // The host switches to a higher rate with a smaller block, then back.
+    host.release();
+    host.prepare(96000.0, 128, layout);
+    for (const auto size : blockSizes)
+        host.processBlock(size);
+
+    host.release();
+    host.prepare(44100.0, 441, layout);
+    for (int block = 0; block < 40; ++block)
+        host.processBlock(441);
+
+    host.release();
+    host.report(reporter, caseName);
+}
+
+void runRandomised(Reporter& reporter)
+{
+    resetRealtimeViolations();
+    HostSimulation host;
+    juce::Random random { randomSeed };
+    const auto layouts = getHostLayouts();
+
+    for (int session = 0; session < randomSessions; ++session)
+    {
+        const auto sampleRate = sampleRates[random.nextInt(static_cast<int>(std::size(sampleRates)))];
+        const auto blockSize = preparedBlockSizes[random.nextInt(static_cast<int>(std::size(preparedBlockSizes)))];
+        const auto& layout = layouts[static_cast<size_t>(random.nextInt(static_cast<int>(layouts.size())))];
+        if (! host.prepare(sampleRate, blockSize, layout))
+        {
+            reporter.fail("randomised", juce::String(layout.size()) + "-channel layout rejected");
+            return;
+        }
+
+        for (int block = 0; block < blocksPerSession; ++block)
+        {
+            const auto roll = random.nextInt(100);
+            if (roll < 5)
+                host.parameterStorm(random);
+            else if (roll < 8)
+                host.toggleBypass();
+            else if (roll < 10)
+                host.changeProgram(random.nextInt(1000));
+            else if (roll < 11)
+                host.reloadState();
+
+            // Mostly the announced size, sometimes a partial block, now and then a larger one.
+            const auto shape = random.nextInt(10);
+            const auto numSamples = shape < 6 ? blockSize
+                                              : (shape < 9 ? random.nextInt(blockSize + 1)
+                                                           : juce::jmin(maxHostBlockSize, blockSize * (2 + random.nextInt(3))));
+            host.processBlock(numSamples);
+        }
+
+        host.release();
+    }
+
+    host.report(reporter, "randomised");
+    reporter.note("randomised", "seed " + juce::String::toHexString(randomSeed) + ", " + juce::String(randomSessions)
+                                    + " sessions of " + juce::String(blocksPerSession)
+                                    + " blocks, mono to 7.1.4");
+}
+
+void runHostSimulation(Reporter& reporter)
+{
+    runScripted(reporter, juce::AudioChannelSet::stereo());
+    runScripted(reporter, juce::AudioChannelSet::create5point1());
+    runScripted(reporter, juce::AudioChannelSet::create7point1point4());
+    runRandomised(reporter);
+}
+
+const Registration registration { "host-simulation", &runHostSimulation };
+} // namespace
+} // namespace dustbox::bench
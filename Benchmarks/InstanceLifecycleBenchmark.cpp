@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+  File: InstanceLifecycleBenchmark.cpp
+  Responsibility: Measure processor construction/destruction and editor
+                  open/close latency, including the deferred first-show and
+                  first-program-query costs.
+  Assumptions: Runs headless; editors are never attached to a native peer.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxEditor.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <memory>
+#include <vector>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int sessionInstanceCount = 300;
+
+void runInstanceLifecycleBenchmark(Reporter& reporter)
+{
+    reporter.add("processor-construct-destroy", measure(200, []
+    {
+        DustboxProcessor processor;
+    }));
+
+    reporter.add("processor-first-program-query", measure(200, []
+    {
+        DustboxProcessor processor;
+        juce::ignoreUnused(processor.getNumPrograms());
+    }));
+
+    juce::MemoryBlock savedState;
+    {
+        DustboxProcessor source;
+        source.getStateInformation(savedState);
+    }
+
+    reporter.add("session-load-" + juce::String(sessionInstanceCount) + "-instances", measure(5, [&]
+    {
+        std::vector<std::unique_ptr<DustboxProcessor>> session;
+        session.reserve(static_cast<size_t>(sessionInstanceCount));
+
+        for (int i = 0; i < sessionInstanceCount; ++i)
+        {
+            auto& instance = session.emplace_back(std::make_unique<DustboxProcessor>());
+            instance->setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+            instance->prepareToPlay(48000.0, 512);
+        }
+    }));
+
+    DustboxProcessor processor;
+    processor.prepareToPlay(48000.0, 512);
+
+    reporter.add("editor-create-destroy", measure(200, [&]
+    {
+        DustboxEditor editor(processor);
+    }));
+
+    reporter.add("editor-create-first-show-destroy", measure(200, [&]
+    {
+        DustboxEditor editor(processor);
+        editor.ensureSectionsBuilt();
+    }));
+
+    processor.releaseResources();
+}
+
+const Registration registration { "instance-lifecycle", &runInstanceLifecycleBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+  File: MultichannelScalingBenchmark.cpp
+  Responsibility: Measure how block cost scales with bus width, serially and
+                  with stereo lanes spread over the lane worker pool.
+  Assumptions: Lane cases mirror the processor's split (stereo lanes from six
+               channels up); results depend on the number of free cores, so
+               the worker count is reported alongside the timings.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/modules/DirtModule.h"
+#include "Dsp/modules/NoiseModule.h"
+#include "Dsp/modules/PumpModule.h"
+#include "Dsp/modules/TapeModule.h"
+#include "Dsp/routing/ProcessingGraph.h"
+#include "Dsp/utils/LaneWorkerPool.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <memory>
+#include <vector>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int iterations = 10000;
+constexpr int maxWorkers = 3;
+
+struct Lane
+{
+    Lane(int firstChannelIndex, int numChannels) : firstChannel(firstChannelIndex), channels(numChannels)
+    {
+        tape.prepare(sampleRate, blockSize, numChannels);
+        dirt.prepare(sampleRate, blockSize, numChannels);
+        pump.prepare(sampleRate, blockSize, numChannels);
+        noise.prepare(sampleRate, blockSize, numChannels, firstChannelIndex);
+        pump.setSync(sampleRate * 0.5, 0.0f);
+    }
+
+    dsp::TapeModule<float> tape;
+    dsp::DirtModule<float> dirt;
+    dsp::PumpModule<float> pump;
+    dsp::NoiseModule<float> noise;
+    dsp::ProcessingGraph<dsp::TapeModule<float>, dsp::DirtModule<float>, dsp::PumpModule<float>, dsp::NoiseModule<float>> graph {
+        tape, dirt, pump, noise
+    };
+    juce::AudioBuffer<float> view;
+    int firstChannel;
+    int channels;
+};
+
+struct LaneBlock
+{
+    std::vector<std::unique_ptr<Lane>>* lanes;
+    juce::AudioBuffer<float>* buffer;
+};
+
+void processLane(void* context, int laneIndex) noexcept
+{
+    auto& block = *static_cast<LaneBlock*>(context);
+    auto& lane = *(*block.lanes)[static_cast<size_t>(laneIndex)];
+
+    lane.view.setDataToReferTo(block.buffer->getArrayOfWritePointers() + lane.firstChannel, lane.channels, blockSize);
+    lane.noise.generate(blockSize);
+    lane.graph.process(dsp::ModuleOrder::tapeDirtPump, dsp::NoisePlacement::postTape, lane.view, blockSize);
+}
+
+void measureLanes(Reporter& reporter, int numChannels)
+{
+    const int channelsPerLane = numChannels >= 6 ? 2 : numChannels;
+    const int numLanes = numChannels / channelsPerLane;
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+    for (int index = 0; index < numLanes; ++index)
+        lanes.push_back(std::make_unique<Lane>(index * channelsPerLane, channelsPerLane));
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    LaneBlock block { &lanes, &buffer };
+    double phase = 0.0;
+
+    const auto caseName = juce::String(numChannels) + "ch-";
+    dsp::LaneWorkerPool pool;
+
+    reporter.add(caseName + "serial", measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        pool.run(numLanes, &processLane, &block);
+    }));
+
+    const auto numWorkers = juce::jmin(numLanes - 1, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+    if (numWorkers <= 0)
+        return;
+
+    pool.start(numWorkers, sampleRate, blockSize);
+    reporter.add(caseName + "pooled", measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        pool.run(numLanes, &processLane, &block);
+    }));
+    reporter.note(caseName + "pooled", juce::String(numLanes) + " lanes on " + juce::String(pool.getNumWorkers() + 1) + " threads");
+}
+
+void measureProcessor(Reporter& reporter, const juce::AudioChannelSet& layout, const juce::String& caseName)
+{
+    DustboxProcessor processor;
+    if (! setMatchingBuses(processor, layout))
+    {
+        reporter.note(caseName, "layout rejected");
+        return;
+    }
+
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(layout.size(), blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    processor.releaseResources();
+}
+
+void runMultichannelScalingBenchmark(Reporter& reporter)
+{
+    for (const auto numChannels : { 2, 8, 12 })
+        measureLanes(reporter, numChannels);
+
+    measureProcessor(reporter, juce::AudioChannelSet::stereo(), "processor-2ch");
+    measureProcessor(reporter, juce::AudioChannelSet::create7point1(), "processor-8ch");
+    measureProcessor(reporter, juce::AudioChannelSet::create7point1point4(), "processor-12ch");
+}
+
+const Registration registration { "multichannel-scaling", &runMultichannelScalingBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+  File: PrepareLatencyBenchmark.cpp
+  Responsibility: Measure how long a re-prepare blocks the host when the block
+                  size, sample rate or bus width changes, with and without
+                  reserveCapacity().
+  Assumptions: Each iteration alternates between two configurations, so every
+               call is a genuine reconfiguration rather than a repeat.
+  Notes: Without a reservation, growing the block or rate reallocates the arena
+         and recompiles the routing plan; with one, both are reused.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int iterations = 2000;
+constexpr double maxSampleRate = 96000.0;
+constexpr int maxBlockSize = 2048;
+
+struct Configuration
+{
+    double sampleRate;
+    int blockSize;
+};
+
+void setLayout(DustboxProcessor& processor, const juce::AudioChannelSet& layout)
+{
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout);
+    buses.outputBuses.add(layout);
+    const auto accepted = processor.setBusesLayout(buses);
+    jassert(accepted);
+    juce::ignoreUnused(accepted);
+}
+
+void measureReprepare(Reporter& reporter,
+                      const juce::String& caseName,
+                      const juce::AudioChannelSet& layout,
+                      Configuration first,
+                      Configuration second)
+{
+    for (const auto reserved : { false, true })
+    {
+        DustboxProcessor processor;
+        setLayout(processor, layout);
+        processor.setRouting("noise > tape | dirt > pump");
+
+        if (reserved)
+            processor.reserveCapacity(maxSampleRate, maxBlockSize, layout.size());
+
+        bool useFirst = true;
+        reporter.add(caseName + (reserved ? "-reserved" : "-unreserved"), measure(iterations, [&]
+        {
+            const auto& configuration = useFirst ? first : second;
+            processor.prepareToPlay(configuration.sampleRate, configuration.blockSize);
+            useFirst = ! useFirst;
+        }));
+
+        processor.releaseResources();
+    }
+}
+
+void runPrepareLatencyBenchmark(Reporter& reporter)
+{
+    const auto stereo = juce::AudioChannelSet::stereo();
+    const auto surround = juce::AudioChannelSet::create7point1point4();
+
+    measureReprepare(reporter, "stereo-block-256-1024", stereo, { 48000.0, 256 }, { 48000.0, 1024 });
+    measureReprepare(reporter, "stereo-rate-44k-96k", stereo, { 44100.0, 512 }, { 96000.0, 512 });
+    measureReprepare(reporter, "12ch-block-256-1024", surround, { 48000.0, 256 }, { 48000.0, 1024 });
+    measureReprepare(reporter, "12ch-rate-44k-96k", surround, { 44100.0, 512 }, { 96000.0, 512 });
+
+    reporter.note("12ch-block-256-1024-reserved", "reserved for " + juce::String(maxSampleRate / 1000.0) + " kHz, "
+                                                      + juce::String(maxBlockSize) + " samples");
+}
+
+const Registration registration { "prepare-latency", &runPrepareLatencyBenchmark };
+} // namespace
+} // namespace dustbox::bench
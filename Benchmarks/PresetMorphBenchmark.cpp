@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+  File: PresetMorphBenchmark.cpp
+  Responsibility: Measure the preset morph engine on its own and the processor
+                  block cost with morphing off, across two presets, and across
+                  four presets while the position is automated.
+  Assumptions: Runs on one thread; automation is written through the APVTS as
+               a host would between blocks.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+#include "Presets/PresetMorph.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+
+void setParameter(DustboxProcessor& processor, const char* id, float plainValue)
+{
+    auto* parameter = processor.getValueTreeState().getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(plainValue));
+}
+
+void runPresetMorphBenchmark(Reporter& reporter)
+{
+    juce::SharedResourcePointer<presets::FactoryPresetTable> table;
+    presets::PresetMorphEngine engine;
+    params::ParameterValues values {};
+    float position = 0.0f;
+
+    auto nextPosition = [&position]
+    {
+        position += 0.0137f;
+        if (position > 1.0f)
+            position -= 1.0f;
+        return position;
+    };
+
+    engine.setSources(*table, { 0, 1, 2, 3 }, 2);
+    reporter.add("evaluate-two-presets", measure(100000, [&] { engine.evaluate(nextPosition(), values); }));
+
+    engine.setSources(*table, { 0, 1, 2, 3 }, 4);
+    reporter.add("evaluate-four-presets", measure(100000, [&] { engine.evaluate(nextPosition(), values); }));
+
+    int rotation = 0;
+    reporter.add("set-sources-four-presets", measure(100000, [&]
+    {
+        ++rotation;
+        engine.setSources(*table, { rotation % 4, (rotation + 1) % 4, (rotation + 2) % 4, (rotation + 3) % 4 }, 4);
+    }));
+
+    DustboxProcessor processor;
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    auto renderAutomatedBlocks = [&](float mode)
+    {
+        setParameter(processor, params::ids::morphMode, mode);
+        return measure(8000, [&]
+        {
+            setParameter(processor, params::ids::morphPosition, nextPosition());
+            fillWithSine(buffer, phase, sampleRate);
+            processor.processBlock(buffer, midi);
+        });
+    };
+
+    reporter.add("block-morph-off", renderAutomatedBlocks(0.0f));
+    reporter.add("block-morph-two-presets", renderAutomatedBlocks(1.0f));
+    reporter.add("block-morph-four-presets", renderAutomatedBlocks(2.0f));
+
+    processor.releaseResources();
+}
+
+const Registration registration { "preset-morph", &runPresetMorphBenchmark };
+} // namespace
+} // namespace dustbox::bench
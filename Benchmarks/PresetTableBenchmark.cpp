@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+  File: PresetTableBenchmark.cpp
+  Responsibility: Measure factory preset lookup, program switching, and state
+                  restore costs that scale with the number of instances.
+  Assumptions: The shared preset table is already alive while a processor is.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+void runPresetTableBenchmark(Reporter& reporter)
+{
+    DustboxProcessor processor;
+    processor.prepareToPlay(48000.0, 512);
+
+    const juce::SharedResourcePointer<presets::FactoryPresetTable> table;
+    const auto lastPreset = table->getPreset(table->size() - 1).values;
+    auto unmatched = lastPreset;
+    unmatched[params::toIndex(params::ParameterIndex::mixWet)] = 0.123f;
+
+    reporter.add("find-matching-preset-hit", measure(100000, [&]
+    {
+        juce::ignoreUnused(table->findMatchingPreset(lastPreset));
+    }));
+
+    reporter.add("find-matching-preset-miss", measure(100000, [&]
+    {
+        juce::ignoreUnused(table->findMatchingPreset(unmatched));
+    }));
+
+    int program = 0;
+    reporter.add("set-current-program", measure(2000, [&]
+    {
+        processor.setCurrentProgram(program);
+        program = (program + 1) % processor.getNumPrograms();
+    }));
+
+    processor.setCurrentProgram(2);
+    juce::MemoryBlock savedState;
+    processor.getStateInformation(savedState);
+
+    reporter.add("set-state-information-preset-match", measure(2000, [&]
+    {
+        processor.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    }));
+
+    processor.releaseResources();
+}
+
+const Registration registration { "preset-table", &runPresetTableBenchmark };
+} // namespace
+} // namespace dustbox::bench
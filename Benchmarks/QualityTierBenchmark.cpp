@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+  File: QualityTierBenchmark.cpp
+  Responsibility: Measure what the offline quality tier costs against realtime
+                  playback, so the price of a final bounce is known, and check
+                  that playback drops back to the realtime tier afterwards.
+  Assumptions: Each tier gets its own processor, told whether it renders
+               offline before prepareToPlay, as hosts do. Both run with a
+               two-preset morph active so the finer control rate is exercised.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/modules/TapeModule.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int numChannels = 2;
+constexpr int iterations = 5000;
+
+void measureTier(Reporter& reporter, const juce::String& caseName, bool offline)
+{
+    DustboxProcessor processor;
+    processor.setNonRealtime(offline);
+
+    auto& state = processor.getValueTreeState();
+    state.getParameter(params::ids::morphMode)->setValueNotifyingHost(0.5f); // two_presets
+    state.getParameter(params::ids::morphPosition)->setValueNotifyingHost(0.5f);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    const auto statistics = measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    });
+    reporter.add(caseName, statistics);
+
+    // Render time for one minute of stereo audio, single-threaded.
+    const auto blocksPerMinute = 60.0 * sampleRate / blockSize;
+    reporter.note(caseName, "latency " + juce::String(processor.getLatencySamples()) + " samples, "
+                                + juce::String(statistics.meanMicros * blocksPerMinute * 1.0e-3, 1)
+                                + " ms per minute rendered");
+
+    processor.releaseResources();
+}
+
+// A bounce followed by playback without a new prepareToPlay, as some hosts do: the upgrades that
+// switch at block boundaries must switch back.
+void measureOfflineThenRealtime(Reporter& reporter)
+{
+    const juce::String caseName { "offline-then-realtime" };
+
+    DustboxProcessor processor;
+    processor.setNonRealtime(true);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    for (int block = 0; block < 100; ++block)
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }
+
+    if (processor.getQualityTier() != dsp::QualityTier::high
+        || processor.getTapeInterpolation() != dsp::TapeInterpolation::cubic)
+        reporter.fail(caseName, "offline render did not run at the high tier with cubic interpolation");
+
+    processor.setNonRealtime(false);
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    if (processor.getQualityTier() != dsp::QualityTier::standard
+        || processor.getTapeInterpolation() != dsp::TapeInterpolation::linear)
+        reporter.fail(caseName, "playback after the render kept the offline tier or cubic interpolation");
+
+    processor.releaseResources();
+}
+
+void measureTapeInterpolation(Reporter& reporter, const juce::String& caseName, dsp::TapeInterpolation interpolation)
+{
+    dsp::TapeModule<float> tape;
+    tape.prepare(sampleRate, blockSize, numChannels);
+
+    dsp::TapeParameters parameters;
+    parameters.wowDepth = 0.6f;
+    parameters.flutterDepth = 0.4f;
+    parameters.interpolation = interpolation;
+    tape.setParameters(parameters);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        tape.processBlock(buffer, blockSize);
+    }));
+}
+
+void runQualityTierBenchmark(Reporter& reporter)
+{
+    measureTier(reporter, "realtime-tier", false);
+    measureTier(reporter, "offline-tier", true);
+    measureOfflineThenRealtime(reporter);
+    measureTapeInterpolation(reporter, "tape-linear", dsp::TapeInterpolation::linear);
+    measureTapeInterpolation(reporter, "tape-cubic", dsp::TapeInterpolation::cubic);
+}
+
+const Registration registration { "quality-tiers", &runQualityTierBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+  File: RealtimeSafetyBenchmark.cpp
+  Responsibility: Run every program, bypass transitions and rapid program
+                  changes under the realtime-safety checker, and fail with a
+                  stack trace for any allocation, free or mutex lock inside
+                  processBlock.
+  Assumptions: The suite marks each processBlock call itself, so it checks the
+               calling thread in any build, including its wake-ups of parked
+               lane workers, and the lane workers' shares inherit the mark.
+               Every case runs on stereo, 5.1 and 7.1.4 buses, so the lane
+               worker pool is covered.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+#include "RealtimeSafetyChecker.h"
+
+#include "Core/RealtimeSafety.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <chrono>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int maxReportedTraces = 8;
+
+class CheckedRenderer
+{
+public:
+    explicit CheckedRenderer(const juce::AudioChannelSet& layout)
+        : buffer(layout.size(), blockSize)
+    {
+        layoutAccepted = setMatchingBuses(processor, layout);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    ~CheckedRenderer() { processor.releaseResources(); }
+
+    DustboxProcessor& getProcessor() noexcept { return processor; }
+    bool isLayoutAccepted() const noexcept { return layoutAccepted; }
+
+    void render(int numBlocks)
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithSine(buffer, phase, sampleRate);
+
+            const auto start = std::chrono::steady_clock::now();
+            {
+                const auto realtimeSection = ScopedRealtimeSection::always();
+                processor.processBlock(buffer, midi);
+            }
+            blockMicros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    void setBypass(bool shouldBypass)
+    {
+        processor.getValueTreeState().getParameter(params::ids::hardBypass)->setValueNotifyingHost(shouldBypass ? 1.0f : 0.0f);
+    }
+
+    const std::vector<double>& getBlockMicros() const noexcept { return blockMicros; }
+
+private:
+    DustboxProcessor processor;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+    std::vector<double> blockMicros;
+    double phase { 0.0 };
+    bool layoutAccepted { false };
+};
+
+void reportViolations(Reporter& reporter, const juce::String& caseName, const CheckedRenderer& renderer)
+{
+    reporter.add(caseName, summarise(renderer.getBlockMicros()));
+
+    const auto violations = getRealtimeViolations();
+    if (violations.total() == 0)
+    {
+        reporter.note(caseName, "no allocations, frees or locks inside processBlock");
+        return;
+    }
+
+    reporter.fail(caseName, juce::String(static_cast<juce::int64>(violations.allocations)) + " allocations, "
+                                + juce::String(static_cast<juce::int64>(violations.deallocations)) + " frees, "
+                                + juce::String(static_cast<juce::int64>(violations.locks)) + " locks");
+
+    for (const auto& trace : describeRealtimeViolations(maxReportedTraces))
+        reporter.note(caseName, trace);
+}
+
+juce::String getCaseName(const char* check, const juce::AudioChannelSet& layout)
+{
+    return check + juce::String("-") + juce::String(layout.size()) + "ch";
+}
+
+void checkPrograms(Reporter& reporter, const juce::AudioChannelSet& layout)
+{
+    const auto caseName = getCaseName("programs-and-bypass", layout);
+    resetRealtimeViolations();
+    CheckedRenderer renderer { layout };
+    auto& processor = renderer.getProcessor();
+
+    if (! renderer.isLayoutAccepted())
+    {
+        reporter.fail(caseName, "layout rejected");
+        return;
+    }
+
+    // Each program gets its dip, swap and dry hold, then a bypass round trip.
+    for (int program = 0; program < processor.getNumPrograms(); ++program)
+    {
+        processor.setCurrentProgram(program);
+        renderer.render(48);
+
+        renderer.setBypass(true);
+        renderer.render(24);
+        renderer.setBypass(false);
+        renderer.render(24);
+    }
+
+    reportViolations(reporter, caseName, renderer);
+}
+
+void checkRapidProgramChanges(Reporter& reporter, const juce::AudioChannelSet& layout)
+{
+    const auto caseName = getCaseName("rapid-program-changes", layout);
+    resetRealtimeViolations();
+    CheckedRenderer renderer { layout };
+    auto& processor = renderer.getProcessor();
+
+    if (! renderer.isLayoutAccepted())
+    {
+        reporter.fail(caseName, "layout rejected");
+        return;
+    }
+
+    // Changes land while the previous one is still fading, and bypass flips mid-ramp.
+    for (int change = 0; change < 200; ++change)
+    {
+        processor.setCurrentProgram(change % processor.getNumPrograms());
+        if (change % 7 == 0)
+            renderer.setBypass(change % 14 == 0);
+
+        renderer.render(2);
+    }
+
+    reportViolations(reporter, caseName, renderer);
+}
+
+void runRealtimeSafetyBenchmark(Reporter& reporter)
+{
+    if (! canDetectLocks())
+        reporter.note("setup", "lock detection is not available on this platform");
+
+    for (const auto& layout : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create5point1(),
+                                juce::AudioChannelSet::create7point1point4() })
+    {
+        checkPrograms(reporter, layout);
+        checkRapidProgramChanges(reporter, layout);
+    }
+}
+
+const Registration registration { "realtime-safety", &runRealtimeSafetyBenchmark };
+} // namespace
+} // namespace dustbox::bench
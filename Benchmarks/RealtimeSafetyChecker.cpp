@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+  File: RealtimeSafetyChecker.cpp
+  Responsibility: Interpose the allocator and mutex functions, record calls made
+                  inside realtime sections, and symbolise their stack traces.
+  Assumptions: glibc exports __libc_malloc and friends, so the C allocator hooks
+               forward without dlsym (which itself allocates). The mutex hooks
+               find the next definition with dlsym(RTLD_NEXT) on first use. A
+               thread-local guard keeps the checker's own work (taking a stack
+               trace can allocate and lock) out of the counts.
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+
+#include "Core/RealtimeSafety.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+ #include <cerrno>
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__)
+ #define DUSTBOX_HOOK_C_ALLOCATOR 1
+#else
+ #define DUSTBOX_HOOK_C_ALLOCATOR 0
+#endif
+
+namespace dustbox::bench
+{
+namespace
+{
+enum class ViolationKind
+{
+    allocation,
+    deallocation,
+    lock
+};
+
+constexpr int maxRecordedTraces = 64;
+constexpr int maxFrames = 32;
+constexpr int hookFrames = 2; // record() and the hook itself.
+
+struct RecordedTrace
+{
+    std::atomic<bool> ready { false };
+    ViolationKind kind { ViolationKind::allocation };
+    void* frames[maxFrames] {};
+    int numFrames { 0 };
+};
+
+std::atomic<uint64_t> allocationCount { 0 };
+std::atomic<uint64_t> deallocationCount { 0 };
+std::atomic<uint64_t> lockCount { 0 };
+RecordedTrace recordedTraces[maxRecordedTraces];
+std::atomic<int> numRecordedTraces { 0 };
+
+thread_local bool insideChecker = false;
+
+void record(ViolationKind kind) noexcept
+{
+    if (insideChecker || ! isInRealtimeSection())
+        return;
+
+    insideChecker = true;
+
+    auto& count = kind == ViolationKind::allocation ? allocationCount
+                                                    : (kind == ViolationKind::deallocation ? deallocationCount : lockCount);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+#if defined(__linux__)
+    const auto index = numRecordedTraces.fetch_add(1, std::memory_order_relaxed);
+    if (index < maxRecordedTraces)
+    {
+        auto& trace = recordedTraces[index];
+        trace.kind = kind;
+        trace.numFrames = backtrace(trace.frames, maxFrames);
+        trace.ready.store(true, std::memory_order_release);
+    }
+#endif
+
+    insideChecker = false;
+}
+
+#if defined(__linux__)
+// backtrace() loads its unwinder on first use, which allocates; do that before anything is marked.
+const bool unwinderLoaded = []
+{
+    void* frames[1];
+    return backtrace(frames, 1) >= 0;
+}();
+
+juce::String demangle(const char* symbol)
+{
+    // glibc formats frames as "module(mangled+offset) [address]".
+    const juce::String text { symbol };
+    const auto open = text.indexOfChar('(');
+    const auto plus = text.indexOfChar(open, '+');
+    if (open < 0 || plus <= open + 1)
+        return text;
+
+    const auto mangled = text.substring(open + 1, plus);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.toRawUTF8(), nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr)
+        return text;
+
+    const auto result = juce::String(demangled) + " " + text.fromFirstOccurrenceOf(")", false, false).trim();
+    std::free(demangled);
+    return result;
+}
+#endif
+
+const char* getKindName(ViolationKind kind) noexcept
+{
+    switch (kind)
+    {
+        case ViolationKind::allocation: return "allocation";
+        case ViolationKind::deallocation: return "free";
+        case ViolationKind::lock: return "mutex lock";
+    }
+
+    return "";
+}
+} // namespace
+
+RealtimeViolations getRealtimeViolations() noexcept
+{
+    RealtimeViolations violations;
+    violations.allocations = allocationCount.load(std::memory_order_relaxed);
+    violations.deallocations = deallocationCount.load(std::memory_order_relaxed);
+    violations.locks = lockCount.load(std::memory_order_relaxed);
+    return violations;
+}
+
+void resetRealtimeViolations() noexcept
+{
+    allocationCount.store(0, std::memory_order_relaxed);
+    deallocationCount.store(0, std::memory_order_relaxed);
+    lockCount.store(0, std::memory_order_relaxed);
+
+    for (auto& trace : recordedTraces)
+        trace.ready.store(false, std::memory_order_relaxed);
+
+    numRecordedTraces.store(0, std::memory_order_release);
+}
+
+juce::StringArray describeRealtimeViolations(int maxTraces)
+{
+    juce::StringArray descriptions;
+
+#if defined(__linux__)
+    const auto numTraces = juce::jmin(numRecordedTraces.load(std::memory_order_acquire), maxRecordedTraces);
+
+    for (int index = 0; index < numTraces && descriptions.size() < maxTraces; ++index)
+    {
+        const auto& trace = recordedTraces[index];
+        if (! trace.ready.load(std::memory_order_acquire) || trace.numFrames <= hookFrames)
+            continue;
+
+        // The same call site usually fires every block; report it once.
+        bool seen = false;
+        for (int earlier = 0; earlier < index && ! seen; ++earlier)
+        {
+            const auto& other = recordedTraces[earlier];
+            seen = other.kind == trace.kind && other.numFrames == trace.numFrames
+                   && std::memcmp(other.frames, trace.frames, sizeof(void*) * static_cast<size_t>(trace.numFrames)) == 0;
+        }
+
+        if (seen)
+            continue;
+
+        juce::String description { getKindName(trace.kind) };
+        description << " inside a realtime section:";
+
+        if (char** symbols = backtrace_symbols(trace.frames, trace.numFrames))
+        {
+            for (int frame = hookFrames; frame < trace.numFrames; ++frame)
+                description << "\n    #" << (frame - hookFrames) << " " << demangle(symbols[frame]);
+
+            std::free(symbols);
+        }
+
+        descriptions.add(description);
+    }
+#else
+    juce::ignoreUnused(maxTraces);
+#endif
+
+    return descriptions;
+}
+
+bool canDetectLocks() noexcept
+{
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+} // namespace dustbox::bench
+
+#if DUSTBOX_HOOK_C_ALLOCATOR
+// operator new and delete (aligned ones included) go through these in libstdc++.
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size)
+{
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size)
+{
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    dustbox::bench::record(dustbox::bench::ViolationKind::allocation);
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr ? 0 : ENOMEM;
+}
+
+void free(void* pointer)
+{
+    if (pointer != nullptr)
+        dustbox::bench::record(dustbox::bench::ViolationKind::deallocation);
+
+    __libc_free(pointer);
+}
+}
+#else
+namespace dustbox::bench
+{
+namespace
+{
+void* allocate(std::size_t size) noexcept
+{
+    record(ViolationKind::allocation);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void deallocate(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        record(ViolationKind::deallocation);
+
+    std::free(pointer);
+}
+} // namespace
+} // namespace dustbox::bench
+
+void* operator new(std::size_t size)
+{
+    if (auto* pointer = dustbox::bench::allocate(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (auto* pointer = dustbox::bench::allocate(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return dustbox::bench::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return dustbox::bench::allocate(size); }
+
+void operator delete(void* pointer) noexcept { dustbox::bench::deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { dustbox::bench::deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { dustbox::bench::deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { dustbox::bench::deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { dustbox::bench::deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { dustbox::bench::deallocate(pointer); }
+#endif
+
+#if defined(__linux__)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static const auto next = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+
+    dustbox::bench::record(dustbox::bench::ViolationKind::lock);
+    return next(mutex);
+}
+
+extern "C" int pthread_mutex_trylock(pthread_mutex_t* mutex)
+{
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static const auto next = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+
+    dustbox::bench::record(dustbox::bench::ViolationKind::lock);
+    return next(mutex);
+}
+#endif
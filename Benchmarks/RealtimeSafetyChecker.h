@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+  File: RealtimeSafetyChecker.h
+  Responsibility: Count heap allocations, frees and mutex locks made inside a
+                  realtime section (see Core/RealtimeSafety.h), and keep a
+                  stack trace of the first few for the report.
+  Assumptions: Only linked into the benchmark runner. On Linux (glibc) the C
+               allocator (malloc, calloc, realloc, free and the aligned
+               variants) and pthread_mutex_lock/trylock are interposed, which
+               also catches operator new and std::mutex. Elsewhere only the
+               global operator new/delete are replaced, locks go unseen and no
+               stack traces are taken.
+  Notes: Recording is lock-free and allocation-free: counts are atomics and
+         traces go into a fixed table. Symbolising happens when the report is
+         built, outside any realtime section.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cstdint>
+
+namespace dustbox::bench
+{
+struct RealtimeViolations
+{
+    uint64_t allocations { 0 };
+    uint64_t deallocations { 0 };
+    uint64_t locks { 0 };
+
+    uint64_t total() const noexcept { return allocations + deallocations + locks; }
+};
+
+RealtimeViolations getRealtimeViolations() noexcept;
+/** Clears the counts and the recorded stack traces. */
+void resetRealtimeViolations() noexcept;
+
+/** One entry per distinct call stack recorded since the last reset, symbolised, at most maxTraces. */
+juce::StringArray describeRealtimeViolations(int maxTraces);
+
+/** False where locks cannot be intercepted; their count then stays at zero. */
+bool canDetectLocks() noexcept;
+} // namespace dustbox::bench
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+  File: RoutingPlanBenchmark.cpp
+  Responsibility: Compare runtime routing plans against the compile-time chain,
+                  and measure plan compilation and live routing swaps.
+  Assumptions: Chain comparisons drive the same prepared modules on the same
+               buffer; swap timings render audio on a second thread the way a
+               host would while the benchmark thread acts as the message thread.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Dsp/modules/DirtModule.h"
+#include "Dsp/modules/NoiseModule.h"
+#include "Dsp/modules/PumpModule.h"
+#include "Dsp/modules/TapeModule.h"
+#include "Dsp/routing/ProcessingGraph.h"
+#include "Dsp/routing/RoutingGraph.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <atomic>
+#include <thread>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 20000;
+
+struct Modules
+{
+    Modules()
+    {
+        tape.prepare(sampleRate, blockSize, numChannels);
+        dirt.prepare(sampleRate, blockSize, numChannels);
+        pump.prepare(sampleRate, blockSize, numChannels);
+        noise.prepare(sampleRate, blockSize, numChannels);
+        pump.setSync(sampleRate * 0.5, 0.0f);
+    }
+
+    dsp::TapeModule<float> tape;
+    dsp::DirtModule<float> dirt;
+    dsp::PumpModule<float> pump;
+    dsp::NoiseModule<float> noise;
+};
+
+std::unique_ptr<dsp::RoutingPlan> compilePlan(const char* text)
+{
+    dsp::RoutingGraph graph;
+    const auto parsed = dsp::RoutingGraph::parse(text, graph);
+    jassert(parsed);
+    juce::ignoreUnused(parsed);
+    return graph.compile(1, numChannels, blockSize);
+}
+
+void runRoutingPlanBenchmark(Reporter& reporter)
+{
+    Modules modules;
+    dsp::ProcessingGraph<dsp::TapeModule<float>, dsp::DirtModule<float>, dsp::PumpModule<float>, dsp::NoiseModule<float>> fixedChain {
+        modules.tape, modules.dirt, modules.pump, modules.noise
+    };
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    double phase = 0.0;
+
+    auto renderWith = [&](auto&& processChain)
+    {
+        return measure(iterations, [&]
+        {
+            fillWithSine(buffer, phase, sampleRate);
+            modules.noise.generate(blockSize);
+            processChain();
+        });
+    };
+
+    reporter.add("fixed-chain-tape-noise-dirt-pump", renderWith([&]
+    {
+        fixedChain.process(dsp::ModuleOrder::tapeDirtPump, dsp::NoisePlacement::postTape, buffer, blockSize);
+    }));
+
+    auto serial = compilePlan("tape > noise > dirt > pump");
+    reporter.add("plan-tape-noise-dirt-pump", renderWith([&]
+    {
+        serial->process(0, modules.tape, modules.dirt, modules.pump, modules.noise, buffer, blockSize);
+    }));
+
+    auto parallel = compilePlan("noise > tape | dirt > pump");
+    reporter.add("plan-noise-then-tape-parallel-dirt", renderWith([&]
+    {
+        parallel->process(0, modules.tape, modules.dirt, modules.pump, modules.noise, buffer, blockSize);
+    }));
+
+    reporter.add("compile-parallel-plan", measure(2000, [&]
+    {
+        juce::ignoreUnused(compilePlan("noise > tape | dirt > pump"));
+    }));
+
+    DustboxProcessor processor;
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const char* routings[] { "noise > tape | dirt > pump", "pump > dirt > noise > tape", "default" };
+    int routingIndex = 0;
+    int block = 0;
+
+    reporter.add("block-with-routing-swap-every-8-blocks", measure(8000, [&]
+    {
+        if (++block % 8 == 0)
+            processor.setRouting(routings[routingIndex++ % 3]);
+
+        juce::MidiBuffer midi;
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    std::atomic<bool> running { true };
+    std::thread audioThread([&]
+    {
+        juce::AudioBuffer<float> audioBuffer(numChannels, blockSize);
+        juce::MidiBuffer audioMidi;
+        double audioPhase = 0.0;
+
+        while (running.load(std::memory_order_relaxed))
+        {
+            fillWithSine(audioBuffer, audioPhase, sampleRate);
+            processor.processBlock(audioBuffer, audioMidi);
+        }
+    });
+
+    reporter.add("set-routing-while-rendering", measure(2000, [&]
+    {
+        processor.setRouting(routings[routingIndex++ % 3]);
+    }));
+
+    running.store(false, std::memory_order_relaxed);
+    audioThread.join();
+
+    processor.releaseResources();
+}
+
+const Registration registration { "routing-plan", &runRoutingPlanBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+  File: SessionCaptureBenchmark.cpp
+  Responsibility: Measure what session capture adds to processBlock, with and
+                  without audio, and check a captured session replays block
+                  for block, with the parameter-driven order and with custom
+                  routings.
+  Assumptions: Capture files go to the temp folder and are deleted afterwards.
+               Recording runs inside a realtime section, so the checker fails
+               the suite if capturing ever allocates or locks on the audio
+               thread.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+#include "RealtimeSafetyChecker.h"
+#include "SessionReplay.h"
+
+#include "Core/RealtimeSafety.h"
+#include "Dsp/routing/RoutingGraph.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+#include "Plugin/SessionCapture.h"
+
+#include <array>
+#include <cmath>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 2000;
+
+enum class CaptureMode
+{
+    off,
+    parameters,
+    withAudio
+};
+
+void fillSine(juce::AudioBuffer<float>& buffer, double& phase)
+{
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    {
+        const auto value = static_cast<float>(0.5 * std::sin(phase));
+        phase += juce::MathConstants<double>::twoPi * 220.0 / sampleRate;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.setSample(channel, sample, value);
+    }
+}
+
+void runOverhead(Reporter& reporter, const juce::String& caseName, CaptureMode mode)
+{
+    DustboxProcessor processor;
+    juce::AudioBuffer<float> buffer { numChannels, blockSize };
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const juce::TemporaryFile file { ".dbxcap" };
+    if (mode != CaptureMode::off && ! processor.startSessionCapture(file.getFile(), mode == CaptureMode::withAudio))
+    {
+        reporter.fail(caseName, "cannot write " + file.getFile().getFullPathName());
+        return;
+    }
+
+    resetRealtimeViolations();
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillSine(buffer, phase);
+        const auto audioCallback = ScopedRealtimeSection::always();
+        processor.processBlock(buffer, midi);
+    }));
+
+    if (getRealtimeViolations().total() > 0)
+        reporter.fail(caseName, "capturing allocated or locked on the audio thread");
+
+    processor.stopSessionCapture();
+    processor.releaseResources();
+
+    if (mode != CaptureMode::off)
+        reporter.note(caseName, juce::String(file.getFile().getSize() / 1024) + " KiB written");
+}
+
+/** A short session with a rate change, odd block sizes, automation and a bypass round trip.
+    Each prepare runs with the matching routing; empty ones follow the parameters. */
+int recordSession(const juce::File& file, const std::array<juce::String, 2>& routings)
+{
+    DustboxProcessor processor;
+    juce::AudioBuffer<float> storage { numChannels, 1024 };
+    juce::AudioBuffer<float> view;
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+    int numBlocks = 0;
+
+    auto play = [&](int numSamples)
+    {
+        view.setDataToReferTo(storage.getArrayOfWritePointers(), numChannels, numSamples);
+        fillSine(view, phase);
+        processor.processBlock(view, midi);
+        ++numBlocks;
+    };
+
+    processor.setRouting(routings[0]);
+    processor.startSessionCapture(file, false);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto* saturation = processor.getValueTreeState().getParameter(params::ids::dirtSaturationAmt);
+    auto* bypass = processor.getValueTreeState().getParameter(params::ids::hardBypass);
+    for (int block = 0; block < 400; ++block)
+    {
+        saturation->setValueNotifyingHost(static_cast<float>(block % 100) / 100.0f);
+        if (block == 200 || block == 240)
+            bypass->setValueNotifyingHost(block == 200 ? 1.0f : 0.0f);
+
+        play(block % 7 == 0 ? 37 : blockSize);
+    }
+
+    processor.releaseResources();
+    processor.setRouting(routings[1]);
+    processor.prepareToPlay(96000.0, 1024);
+    for (int block = 0; block < 200; ++block)
+        play(block % 5 == 0 ? 1024 : 512);
+
+    processor.releaseResources();
+    processor.stopSessionCapture();
+    return numBlocks;
+}
+
+/** The routing each prepare in the file carries, in order. */
+juce::StringArray readCapturedRoutings(const juce::File& file)
+{
+    juce::StringArray routings;
+    SessionCaptureReader reader;
+    SessionCaptureReader::Record record;
+    if (reader.open(file))
+        while (reader.readNext(record))
+            if (record.type == capture::RecordType::prepare)
+                routings.add(record.prepare.routing);
+
+    return routings;
+}
+
+void runRoundTrip(Reporter& reporter, const juce::String& caseName, const std::array<juce::String, 2>& routings)
+{
+    const juce::TemporaryFile file { ".dbxcap" };
+    const auto recordedBlocks = recordSession(file.getFile(), routings);
+
+    DustboxProcessor processor;
+    const auto result = replaySession(file.getFile(), processor);
+    reportReplay(reporter, caseName, result);
+
+    if (result.error.isEmpty() && static_cast<int>(result.blockMicros.size()) != recordedBlocks)
+        reporter.fail(caseName, "replayed " + juce::String(static_cast<int>(result.blockMicros.size())) + " of "
+                                    + juce::String(recordedBlocks) + " recorded blocks");
+
+    // Compared in canonical form, which is what the processor reports back.
+    juce::StringArray expected;
+    for (const auto& routing : routings)
+    {
+        dsp::RoutingGraph graph;
+        dsp::RoutingGraph::parse(routing, graph);
+        expected.add(graph.toString());
+    }
+
+    const auto captured = readCapturedRoutings(file.getFile());
+    if (captured != expected)
+        reporter.fail(caseName, "captured routings [" + captured.joinIntoString(", ") + "], expected ["
+                                    + expected.joinIntoString(", ") + "]");
+
+    if (result.error.isEmpty() && processor.getRouting() != expected[expected.size() - 1])
+        reporter.fail(caseName, "replay ended with routing \"" + processor.getRouting() + "\", expected \""
+                                    + expected[expected.size() - 1] + "\"");
+}
+
+void runSessionCapture(Reporter& reporter)
+{
+    runOverhead(reporter, "capture off", CaptureMode::off);
+    runOverhead(reporter, "capture parameters", CaptureMode::parameters);
+    runOverhead(reporter, "capture with audio", CaptureMode::withAudio);
+    runRoundTrip(reporter, "replay", {});
+    runRoundTrip(reporter, "replay routed", { "noise > tape | dirt > pump", "pump > dirt > noise > tape" });
+}
+
+const Registration registration { "session-capture", &runSessionCapture };
+} // namespace
+} // namespace dustbox::bench
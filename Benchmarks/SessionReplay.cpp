@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+  File: SessionReplay.cpp
+  Responsibility: Replay session captures through a processor and report the
+                  per-block cost.
+  Assumptions: Buffers are grown between blocks, outside the timed and checked
+               region, so a capture with blocks larger than announced costs
+               the processor exactly what the host's did.
+  ==============================================================================
+*/
+
+#include "SessionReplay.h"
+#include "RealtimeSafetyChecker.h"
+
+#include "Core/RealtimeSafety.h"
+#include "Plugin/DustboxProcessor.h"
+#include "Plugin/SessionCapture.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int maxReportedTraces = 8;
+
+class ReplayPlayHead : public juce::AudioPlayHead
+{
+public:
+    juce::Optional<PositionInfo> getPosition() const override { return state.toPositionInfo(); }
+
+    capture::PlayHeadState state;
+};
+
+juce::AudioChannelSet getChannelSet(int numChannels)
+{
+    switch (numChannels)
+    {
+        case 1: return juce::AudioChannelSet::mono();
+        case 2: return juce::AudioChannelSet::stereo();
+        case 6: return juce::AudioChannelSet::create5point1();
+        case 8: return juce::AudioChannelSet::create7point1();
+        case 12: return juce::AudioChannelSet::create7point1point4();
+        default: return juce::AudioChannelSet::discreteChannels(numChannels);
+    }
+}
+
+template <typename SampleType>
+bool hasNonFiniteSample(const juce::AudioBuffer<SampleType>& buffer)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            if (! std::isfinite(buffer.getSample(channel, sample)))
+                return true;
+
+    return false;
+}
+
+class Replayer
+{
+public:
+    Replayer(DustboxProcessor& processorToDrive, ReplayResult& resultToFill)
+        : processor(processorToDrive), result(resultToFill)
+    {
+        processor.setPlayHead(&playHead);
+    }
+
+    ~Replayer()
+    {
+        if (prepared)
+            processor.releaseResources();
+
+        processor.setPlayHead(nullptr);
+    }
+
+    void mapParameters(const juce::StringArray& ids)
+    {
+        parameters.assign(static_cast<size_t>(ids.size()), nullptr);
+
+        for (int index = 0; index < ids.size(); ++index)
+        {
+            for (auto* parameter : processor.getParameters())
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter); ranged != nullptr && ranged->getParameterID() == ids[index])
+                    parameters[static_cast<size_t>(index)] = ranged;
+
+            if (parameters[static_cast<size_t>(index)] == nullptr)
+                ++result.unknownParameters;
+        }
+    }
+
+    bool prepare(const capture::PrepareInfo& info)
+    {
+        if (prepared)
+            processor.releaseResources();
+
+        const auto channels = getChannelSet(info.numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channels);
+        layout.outputBuses.add(channels);
+        if (! processor.setBusesLayout(layout))
+        {
+            result.error = "the processor does not accept " + juce::String(info.numChannels) + " channels";
+            return false;
+        }
+
+        // Set while released, as a host restoring a session would, so prepare compiles the plan.
+        if (! processor.setRouting(info.routing))
+        {
+            result.error = "the processor cannot parse the captured routing \"" + info.routing + "\"";
+            return false;
+        }
+
+        doublePrecision = info.doublePrecision;
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+        processor.setNonRealtime(info.nonRealtime);
+        processor.prepareToPlay(info.sampleRate, info.maxBlockSize);
+
+        sampleRate = info.sampleRate;
+        numChannels = info.numChannels;
+        ensureCapacity(info.maxBlockSize);
+        prepared = true;
+        ++result.numPrepares;
+        return true;
+    }
+
+    void release()
+    {
+        if (prepared)
+            processor.releaseResources();
+
+        prepared = false;
+    }
+
+    void processBlock(const SessionCaptureReader::BlockRecord& block)
+    {
+        for (const auto& [index, value] : block.changedValues)
+            if (index < parameters.size() && parameters[index] != nullptr)
+                parameters[index]->setValueNotifyingHost(parameters[index]->convertTo0to1(value));
+
+        if (! prepared)
+        {
+            ++result.blocksBeforePrepare;
+            return;
+        }
+
+        playHead.state = block.playHead;
+        ensureCapacity(block.numSamples);
+
+        if (doublePrecision)
+            render(doubleStorage, doubleView, block);
+        else
+            render(floatStorage, floatView, block);
+    }
+
+private:
+    void ensureCapacity(int numSamples)
+    {
+        if (floatStorage.getNumChannels() < numChannels || floatStorage.getNumSamples() < numSamples)
+        {
+            const auto samples = juce::jmax(numSamples, floatStorage.getNumSamples());
+            floatStorage.setSize(numChannels, samples);
+            doubleStorage.setSize(numChannels, samples);
+        }
+    }
+
+    template <typename SampleType>
+    void render(juce::AudioBuffer<SampleType>& storage, juce::AudioBuffer<SampleType>& view, const SessionCaptureReader::BlockRecord& block)
+    {
+        const auto numSamples = block.numSamples;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = storage.getWritePointer(channel);
+            if (channel < block.numAudioChannels)
+            {
+                const auto* recorded = block.audio.data() + static_cast<size_t>(channel) * static_cast<size_t>(numSamples);
+                for (int sample = 0; sample < numSamples; ++sample)
+                    data[sample] = static_cast<SampleType>(recorded[sample]);
+            }
+            else
+            {
+                auto channelPhase = phase;
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    data[sample] = static_cast<SampleType>(0.5 * std::sin(channelPhase));
+                    channelPhase += juce::MathConstants<double>::twoPi * 110.0 / sampleRate;
+                }
+            }
+        }
+
+        phase = std::fmod(phase + juce::MathConstants<double>::twoPi * 110.0 * numSamples / sampleRate,
+                          juce::MathConstants<double>::twoPi);
+        view.setDataToReferTo(storage.getArrayOfWritePointers(), numChannels, numSamples);
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            const auto audioCallback = ScopedRealtimeSection::always();
+            processor.processBlock(view, midi);
+        }
+        const auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        result.blockMicros.push_back(micros);
+        if (numSamples > 0)
+        {
+            const auto share = micros * 1.0e-6 * sampleRate / numSamples;
+            if (share > result.worstDeadlineShare)
+            {
+                result.worstDeadlineShare = share;
+                result.worstBlock = static_cast<int>(result.blockMicros.size()) - 1;
+                result.worstBlockSamples = numSamples;
+            }
+        }
+
+        if (hasNonFiniteSample(view))
+            ++result.nonFiniteBlocks;
+    }
+
+    DustboxProcessor& processor;
+    ReplayResult& result;
+    ReplayPlayHead playHead;
+    std::vector<juce::RangedAudioParameter*> parameters;
+    juce::AudioBuffer<float> floatStorage;
+    juce::AudioBuffer<float> floatView;
+    juce::AudioBuffer<double> doubleStorage;
+    juce::AudioBuffer<double> doubleView;
+    juce::MidiBuffer midi;
+    double sampleRate { 48000.0 };
+    double phase { 0.0 };
+    int numChannels { 2 };
+    bool doublePrecision { false };
+    bool prepared { false };
+};
+} // namespace
+
+ReplayResult replaySession(const juce::File& file, DustboxProcessor& processor)
+{
+    ReplayResult result;
+    SessionCaptureReader reader;
+    if (! reader.open(file))
+    {
+        result.error = "cannot read " + file.getFullPathName() + " as a session capture";
+        return result;
+    }
+
+    resetRealtimeViolations();
+
+    Replayer replayer { processor, result };
+    replayer.mapParameters(reader.getParameterIds());
+
+    SessionCaptureReader::Record record;
+    while (reader.readNext(record))
+    {
+        switch (record.type)
+        {
+            case capture::RecordType::prepare:
+                if (! replayer.prepare(record.prepare))
+                    return result;
+                break;
+
+            case capture::RecordType::block: replayer.processBlock(record.block); break;
+            case capture::RecordType::release: replayer.release(); break;
+            case capture::RecordType::dropped: result.droppedBlocks += record.droppedBlocks; break;
+        }
+    }
+
+    return result;
+}
+
+void reportReplay(Reporter& reporter, const juce::String& caseName, const ReplayResult& result)
+{
+    if (result.error.isNotEmpty())
+    {
+        reporter.fail(caseName, result.error);
+        return;
+    }
+
+    const auto violations = getRealtimeViolations();
+    reporter.add(caseName, summarise(result.blockMicros));
+    reporter.note(caseName, juce::String(static_cast<int>(result.blockMicros.size())) + " blocks over "
+                                + juce::String(result.numPrepares) + " prepares");
+
+    if (result.worstBlock >= 0)
+        reporter.note(caseName, "worst block #" + juce::String(result.worstBlock) + " (" + juce::String(result.worstBlockSamples)
+                                    + " samples) used " + juce::String(100.0 * result.worstDeadlineShare, 1) + " % of its deadline");
+
+    if (result.droppedBlocks > 0)
+        reporter.note(caseName, juce::String(static_cast<juce::int64>(result.droppedBlocks)) + " blocks were dropped while capturing");
+
+    if (result.unknownParameters > 0)
+        reporter.note(caseName, juce::String(result.unknownParameters) + " captured parameters are unknown to this build");
+
+    if (result.blocksBeforePrepare > 0)
+        reporter.note(caseName, juce::String(result.blocksBeforePrepare) + " blocks arrived before any prepare and were skipped");
+
+    if (violations.allocations + violations.deallocations > 0)
+        reporter.fail(caseName, juce::String(static_cast<juce::int64>(violations.allocations)) + " allocations and "
+                                    + juce::String(static_cast<juce::int64>(violations.deallocations))
+                                    + " frees inside processBlock");
+
+    if (violations.locks > 0)
+        reporter.fail(caseName, juce::String(static_cast<juce::int64>(violations.locks)) + " mutex locks inside processBlock");
+
+    if (result.nonFiniteBlocks > 0)
+        reporter.fail(caseName, juce::String(result.nonFiniteBlocks) + " blocks with non-finite output");
+
+    for (const auto& trace : describeRealtimeViolations(maxReportedTraces))
+        reporter.note(caseName, trace);
+}
+} // namespace dustbox::bench
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+  File: SessionReplay.h
+  Responsibility: Feed a session capture (see Plugin/SessionCapture.h) back
+                  through a processor: the same prepare/release calls, block
+                  sizes, routing, parameter values and playhead, in order,
+                  timing each block and checking it under the realtime-safety
+                  checker.
+  Assumptions: Runs on one thread, which plays both host roles. Parameters are
+               matched by ID, so a capture from an older build still replays;
+               IDs this build does not know are counted and skipped. Captures
+               without audio are fed a 110 Hz sine.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BenchmarkHarness.h"
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace dustbox
+{
+class DustboxProcessor;
+}
+
+namespace dustbox::bench
+{
+struct ReplayResult
+{
+    juce::String error; // Empty when the whole file replayed.
+    std::vector<double> blockMicros;
+    int numPrepares { 0 };
+    int worstBlock { -1 }; // Index into blockMicros of the largest deadline share.
+    int worstBlockSamples { 0 };
+    double worstDeadlineShare { 0.0 };
+    uint64_t droppedBlocks { 0 }; // Lost while capturing, not while replaying.
+    int unknownParameters { 0 };
+    int blocksBeforePrepare { 0 };
+    int nonFiniteBlocks { 0 };
+};
+
+/** Replays the capture through the processor, which must be freshly constructed or released. */
+ReplayResult replaySession(const juce::File& file, DustboxProcessor& processor);
+
+/** Adds the timings and notes to the report; fails on a read error, non-finite output, or any
+    allocation or lock inside processBlock. */
+void reportReplay(Reporter& reporter, const juce::String& caseName, const ReplayResult& result);
+} // namespace dustbox::bench
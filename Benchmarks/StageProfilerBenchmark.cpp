@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+  File: StageProfilerBenchmark.cpp
+  Responsibility: Measure what the per-stage processBlock timers cost while the
+                  profiling overlay is closed and while it is open, and print
+                  the per-stage breakdown they collect.
+  Assumptions: A stereo processor at factory defaults with 2x Dirt
+               oversampling, so every stage has some work to report.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 10000;
+
+void measureProfiling(Reporter& reporter, const juce::String& caseName, bool profilingEnabled)
+{
+    DustboxProcessor processor;
+
+    auto* oversampling = processor.getValueTreeState().getParameter(params::ids::dirtOversampling);
+    oversampling->setValueNotifyingHost(oversampling->convertTo0to1(1.0f)); // 2x
+    processor.getStageProfiler().setEnabled(profilingEnabled);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    if (profilingEnabled)
+    {
+        const auto snapshot = processor.getStageProfiler().getSnapshot();
+        for (size_t stage = 0; stage < dsp::numProfiledStages; ++stage)
+        {
+            const auto& statistics = snapshot.stages[stage];
+            reporter.note(caseName, juce::String(dsp::profiledStageNames[stage]) + ": mean "
+                                        + juce::String(statistics.meanMicros, 2) + " us, p99 "
+                                        + juce::String(statistics.p99Micros, 2) + " us, worst "
+                                        + juce::String(statistics.worstMicros, 2) + " us");
+        }
+    }
+
+    processor.releaseResources();
+}
+
+void runStageProfilerBenchmark(Reporter& reporter)
+{
+    measureProfiling(reporter, "profiling-off", false);
+    measureProfiling(reporter, "profiling-on", true);
+}
+
+const Registration registration { "stage-profiler", &runStageProfilerBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+  File: StateSerialisationBenchmark.cpp
+  Responsibility: Compare session save/load cost of the compact binary state
+                  against the legacy APVTS XML round trip.
+  Assumptions: Legacy blobs are produced the way pre-binary builds wrote them.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Plugin/DustboxProcessor.h"
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int roundTripIterations = 5000;
+
+void runStateSerialisationBenchmark(Reporter& reporter)
+{
+    DustboxProcessor processor;
+    processor.prepareToPlay(48000.0, 512);
+    processor.setCurrentProgram(1);
+
+    juce::MemoryBlock binaryState;
+    reporter.add("binary-save", measure(roundTripIterations, [&]
+    {
+        processor.getStateInformation(binaryState);
+    }));
+
+    reporter.add("binary-load", measure(roundTripIterations, [&]
+    {
+        processor.setStateInformation(binaryState.getData(), static_cast<int>(binaryState.getSize()));
+    }));
+
+    reporter.add("binary-round-trip", measure(roundTripIterations, [&]
+    {
+        processor.getStateInformation(binaryState);
+        processor.setStateInformation(binaryState.getData(), static_cast<int>(binaryState.getSize()));
+    }));
+
+    juce::MemoryBlock legacyState;
+    reporter.add("legacy-xml-save", measure(roundTripIterations, [&]
+    {
+        auto state = processor.getValueTreeState().state;
+        if (auto xml = state.createXml())
+            juce::AudioProcessor::copyXmlToBinary(*xml, legacyState);
+    }));
+
+    reporter.add("legacy-xml-load", measure(roundTripIterations, [&]
+    {
+        processor.setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize()));
+    }));
+
+    reporter.note("state-size",
+                  juce::String(binaryState.getSize()) + " bytes binary vs " + juce::String(legacyState.getSize())
+                      + " bytes legacy XML");
+
+    processor.releaseResources();
+}
+
+const Registration registration { "state-serialisation", &runStateSerialisationBenchmark };
+} // namespace
+} // namespace dustbox::bench
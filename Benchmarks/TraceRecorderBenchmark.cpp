@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+  File: TraceRecorderBenchmark.cpp
+  Responsibility: Measure what recording a trace adds to processBlock, and
+                  record a session with the events worth inspecting in Perfetto:
+                  prepareToPlay, program changes, an automation burst and an
+                  offline render.
+  Assumptions: When the runner was started with --trace, the suites record
+               into that file and this one does too; otherwise it records into
+               a temporary file and prints its path. The ring is sized so the
+               writer keeps up; dropped events are reported if it does not.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Core/TraceRecorder.h"
+#include "Parameters/ParameterIDs.h"
+#include "Plugin/DustboxProcessor.h"
+
+#include <cmath>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+constexpr int numChannels = 2;
+constexpr int iterations = 10000;
+
+void setChoice(DustboxProcessor& processor, const char* id, int index)
+{
+    auto* parameter = processor.getValueTreeState().getParameter(id);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(index)));
+}
+
+void measureBlocks(Reporter& reporter, const juce::String& caseName)
+{
+    DustboxProcessor processor;
+    setChoice(processor, params::ids::dirtOversampling, 1); // 2x
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    reporter.add(caseName, measure(iterations, [&]
+    {
+        fillWithSine(buffer, phase, sampleRate);
+        processor.processBlock(buffer, midi);
+    }));
+
+    processor.releaseResources();
+}
+
+void recordSession()
+{
+    DustboxProcessor processor;
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    double phase = 0.0;
+
+    auto render = [&](int numBlocks)
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithSine(buffer, phase, sampleRate);
+            processor.processBlock(buffer, midi);
+        }
+    };
+
+    render(200);
+
+    for (int program = 1; program <= 4; ++program)
+    {
+        processor.setCurrentProgram(program % processor.getNumPrograms());
+        render(100);
+    }
+
+    // An automation burst: several continuous parameters move on every block.
+    const char* automated[] { params::ids::tapeWowDepth, params::ids::dirtSaturationAmt, params::ids::mixWet,
+                              params::ids::outputGainDb, params::ids::pumpAmount };
+    for (int block = 0; block < 200; ++block)
+    {
+        const auto value = 0.5f + 0.5f * std::sin(static_cast<float>(block) * 0.2f);
+        for (const auto* id : automated)
+            processor.getValueTreeState().getParameter(id)->setValueNotifyingHost(value);
+
+        render(1);
+    }
+
+    render(200);
+
+    // Offline renders prepare again at the high tier.
+    processor.releaseResources();
+    processor.setNonRealtime(true);
+    processor.prepareToPlay(sampleRate, blockSize);
+    render(200);
+    processor.releaseResources();
+}
+
+void runTraceRecorderBenchmark(Reporter& reporter)
+{
+    const juce::SharedResourcePointer<TraceRecorder> recorder;
+    const auto ownsRecording = ! recorder->isRecording();
+
+    if (ownsRecording)
+        measureBlocks(reporter, "block-not-recording");
+
+    const auto file = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("DustboxBenchmarkTrace.json");
+    if (ownsRecording && ! recorder->start(file))
+    {
+        reporter.note("block-recording", "could not write " + file.getFullPathName());
+        return;
+    }
+
+    measureBlocks(reporter, "block-recording");
+    recordSession();
+    reporter.note("session", juce::String(static_cast<juce::int64>(recorder->getDroppedEventCount())) + " events dropped");
+
+    if (ownsRecording)
+    {
+        recorder->stop();
+        reporter.note("session", "trace written to " + file.getFullPathName() + " (" + juce::File::descriptionOfSizeInBytes(file.getSize()) + ")");
+    }
+}
+
+const Registration registration { "trace-recorder", &runTraceRecorderBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+  File: UserPresetLibraryBenchmark.cpp
+  Responsibility: Measure cold start, listing, search, and recall on a user
+                  preset library holding 10k presets.
+  Assumptions: The library lives in a temporary folder that is deleted when
+               the suite finishes; "cold" means a fresh open and mapping, not
+               an empty OS page cache.
+  ==============================================================================
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "Presets/UserPresetLibrary.h"
+
+#include <vector>
+
+namespace dustbox::bench
+{
+namespace
+{
+constexpr int numPresets = 10000;
+
+std::vector<presets::UserPreset> makePresets()
+{
+    const juce::StringArray adjectives { "Warm", "Dusty", "Crushed", "Wobbly", "Glued", "Hazy", "Broken", "Soft" };
+    const juce::StringArray nouns { "Keys", "Drums", "Bass", "Pad", "Vocal", "Bus", "Guitar", "Loop" };
+    const juce::StringArray tagPool { "lofi", "tape", "pump", "subtle", "extreme", "drums", "mix", "vintage" };
+
+    juce::Random random { 1234 };
+    std::vector<presets::UserPreset> result;
+    result.reserve(numPresets);
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        presets::UserPreset preset;
+        preset.name = adjectives[i % adjectives.size()] + " " + nouns[(i / adjectives.size()) % nouns.size()] + " "
+                      + juce::String(i);
+        preset.tags.add(tagPool[random.nextInt(tagPool.size())]);
+        preset.tags.add(tagPool[random.nextInt(tagPool.size())]);
+
+        for (auto& value : preset.values)
+            value = random.nextFloat();
+
+        result.push_back(std::move(preset));
+    }
+
+    return result;
+}
+
+void runUserPresetLibraryBenchmark(Reporter& reporter)
+{
+    const juce::TemporaryFile folder;
+    if (! folder.getFile().createDirectory())
+    {
+        reporter.note("setup", "could not create " + folder.getFile().getFullPathName());
+        return;
+    }
+
+    const auto libraryFile = folder.getFile().getChildFile("Bench.dbxlib");
+    const auto indexFile = presets::UserPresetLibrary::getIndexFileFor(libraryFile);
+
+    const auto source = makePresets();
+    reporter.add("append-10k-presets", measure(1, [&]
+    {
+        libraryFile.deleteFile();
+        indexFile.deleteFile();
+        presets::UserPresetLibrary library { libraryFile };
+        library.append(source);
+    }));
+
+    reporter.add("cold-open-with-index", measure(50, [&]
+    {
+        presets::UserPresetLibrary library { libraryFile };
+        jassert(library.size() == numPresets);
+    }));
+
+    reporter.add("cold-open-rebuilding-index", measure(10, [&]
+    {
+        indexFile.deleteFile();
+        presets::UserPresetLibrary library { libraryFile };
+        jassert(library.size() == numPresets);
+    }));
+
+    presets::UserPresetLibrary library { libraryFile };
+    reporter.note("library-size", juce::String(libraryFile.getSize() / 1024) + " KiB records, "
+                                      + juce::String(indexFile.getSize() / 1024) + " KiB index");
+
+    reporter.add("list-all-names", measure(20, [&]
+    {
+        for (int i = 0; i < library.size(); ++i)
+            juce::ignoreUnused(library.getName(i));
+    }));
+
+    std::vector<int> results;
+    results.reserve(numPresets);
+
+    reporter.add("search-one-term", measure(200, [&]
+    {
+        results.clear();
+        library.search("dusty", results);
+    }));
+
+    reporter.add("search-two-terms-with-tag", measure(200, [&]
+    {
+        results.clear();
+        library.search("Warm vintage", results);
+    }));
+
+    reporter.add("search-no-match", measure(200, [&]
+    {
+        results.clear();
+        library.search("nothing-matches-this", results);
+    }));
+
+    params::ParameterValues values {};
+    int next = 0;
+    reporter.add("read-values", measure(100000, [&]
+    {
+        library.readValues(next, values);
+        next = (next + 7919) % numPresets;
+    }));
+
+    folder.getFile().deleteRecursively();
+}
+
+const Registration registration { "user-preset-library", &runUserPresetLibraryBenchmark };
+} // namespace
+} // namespace dustbox::bench
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+  File: DustboxC.cpp
+  Responsibility: Implement the C API declared in include/dustbox.h on top of
+                  embed::Engine.
+  Assumptions: No C++ exception crosses the C boundary; the only ones possible
+               are allocation failures in create and prepare.
+  ==============================================================================
+*/
+
+#include "dustbox.h"
+
+#include "DustboxEngine.h"
+
+#include <new>
+
+struct dustbox_engine
+{
+    dustbox::embed::Engine engine;
+};
+
+namespace
+{
+bool isParameterIndex(int32_t index) noexcept
+{
+    return index >= 0 && static_cast<size_t>(index) < dustbox::params::numParameters;
+}
+} // namespace
+
+uint32_t dustbox_get_api_version(void)
+{
+    return DUSTBOX_API_VERSION;
+}
+
+dustbox_engine* dustbox_create(void)
+{
+    try
+    {
+        return new dustbox_engine;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void dustbox_destroy(dustbox_engine* engine)
+{
+    delete engine;
+}
+
+dustbox_result dustbox_prepare(dustbox_engine* engine, double sampleRate, int32_t maxBlockSize, int32_t numChannels)
+{
+    if (engine == nullptr)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    try
+    {
+        return engine->engine.prepare(sampleRate, maxBlockSize, numChannels) ? DUSTBOX_OK : DUSTBOX_ERROR_INVALID_ARGUMENT;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return DUSTBOX_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+dustbox_result dustbox_reset(dustbox_engine* engine)
+{
+    if (engine == nullptr)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    if (! engine->engine.isPrepared())
+        return DUSTBOX_ERROR_NOT_PREPARED;
+
+    engine->engine.reset();
+    return DUSTBOX_OK;
+}
+
+int32_t dustbox_get_parameter_count(void)
+{
+    return static_cast<int32_t>(dustbox::params::numParameters);
+}
+
+dustbox_result dustbox_get_parameter_info(const dustbox_engine* engine, int32_t index, dustbox_parameter_info* info)
+{
+    if (engine == nullptr || info == nullptr || ! isParameterIndex(index))
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    const auto range = engine->engine.getParameterRange(static_cast<size_t>(index));
+    info->id = dustbox::params::parameterIdsByIndex[static_cast<size_t>(index)];
+    info->min_value = range.minValue;
+    info->max_value = range.maxValue;
+    info->default_value = range.defaultValue;
+    info->is_discrete = range.isDiscrete ? 1 : 0;
+    return DUSTBOX_OK;
+}
+
+dustbox_result dustbox_set_parameter(dustbox_engine* engine, int32_t index, float value)
+{
+    if (engine == nullptr || ! isParameterIndex(index))
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    return engine->engine.setParameter(static_cast<size_t>(index), value) ? DUSTBOX_OK : DUSTBOX_ERROR_INVALID_ARGUMENT;
+}
+
+dustbox_result dustbox_get_parameter(const dustbox_engine* engine, int32_t index, float* value)
+{
+    if (engine == nullptr || value == nullptr || ! isParameterIndex(index))
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    *value = engine->engine.getParameter(static_cast<size_t>(index));
+    return DUSTBOX_OK;
+}
+
+dustbox_result dustbox_set_tempo(dustbox_engine* engine, double bpm)
+{
+    if (engine == nullptr)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    return engine->engine.setTempo(bpm) ? DUSTBOX_OK : DUSTBOX_ERROR_INVALID_ARGUMENT;
+}
+
+dustbox_result dustbox_process(dustbox_engine* engine, float* const* channels, int32_t numSamples)
+{
+    if (engine == nullptr || channels == nullptr || numSamples < 0)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    if (! engine->engine.isPrepared())
+        return DUSTBOX_ERROR_NOT_PREPARED;
+
+    engine->engine.process(channels, numSamples);
+    return DUSTBOX_OK;
+}
+
+int32_t dustbox_get_latency_samples(const dustbox_engine* engine)
+{
+    return engine != nullptr ? engine->engine.getLatencySamples() : 0;
+}
+
+size_t dustbox_get_state_size(void)
+{
+    return dustbox::embed::Engine::getStateSize();
+}
+
+dustbox_result dustbox_get_state(const dustbox_engine* engine, void* data, size_t* size)
+{
+    if (engine == nullptr || size == nullptr)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    const auto needed = dustbox::embed::Engine::getStateSize();
+    if (data == nullptr || *size < needed)
+    {
+        *size = needed;
+        return DUSTBOX_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    *size = engine->engine.getState(data, *size);
+    return DUSTBOX_OK;
+}
+
+dustbox_result dustbox_set_state(dustbox_engine* engine, const void* data, size_t size)
+{
+    if (engine == nullptr || data == nullptr)
+        return DUSTBOX_ERROR_INVALID_ARGUMENT;
+
+    return engine->engine.setState(data, size) ? DUSTBOX_OK : DUSTBOX_ERROR_INVALID_STATE;
+}
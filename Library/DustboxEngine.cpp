@@ -0,0 +1,336 @@
+/*
+  ==============================================================================
+  File: DustboxEngine.cpp
+  Responsibility: Implement the embeddable engine's preparation, parameter
+                  mapping and per-block signal flow.
+  Assumptions: Parameter values map onto the modules exactly as in
+               DustboxProcessor::applyParameterSnapshot(), so a state blob
+               sounds the same in the plugin and in the library.
+  ==============================================================================
+*/
+
+#include "DustboxEngine.h"
+
+#include "Dsp/utils/DenormalGuard.h"
+#include "Dsp/utils/MathHelpers.h"
+#include "Parameters/BinaryState.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace dustbox::embed
+{
+namespace
+{
+using P = params::ParameterIndex;
+
+constexpr double minSampleRate = 8000.0;
+constexpr double maxSampleRate = 384000.0;
+constexpr float gainSmoothingMs = 30.0f;
+constexpr double bypassRampSeconds = 0.002;
+constexpr double morphRampSeconds = 0.02;
+
+// pumpSyncNote choices (1/4, 1/8, 1/16) as fractions of a quarter note.
+constexpr std::array<double, 3> syncNoteQuarters { 1.0, 0.5, 0.25 };
+} // namespace
+
+params::ParameterRange Engine::getParameterRange(size_t index) const noexcept
+{
+    jassert(index < params::numParameters);
+    auto range = params::parameterRanges[index];
+
+    if (params::isMorphSource(static_cast<P>(index)))
+    {
+        range.maxValue = static_cast<float>(juce::jmax(0, factoryPresets->size() - 1));
+        range.defaultValue = juce::jmin(range.defaultValue, range.maxValue);
+    }
+
+    return range;
+}
+
+size_t Engine::getArenaBytes(double sampleRate, int maxBlockSize, int numChannels) noexcept
+{
+    return dsp::DspArena::bytesForBuffer<float>(numChannels, maxBlockSize)
+           + dsp::LatencyDelay<float>::getArenaBytes(Dirt::getMaxLatencySamples(sampleRate), numChannels)
+           + Tape::getArenaBytes(sampleRate, numChannels)
+           + Noise::getArenaBytes(maxBlockSize, numChannels)
+           + Dirt::getArenaBytes(sampleRate, maxBlockSize, numChannels);
+}
+
+bool Engine::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    if (! (sampleRate >= minSampleRate && sampleRate <= maxSampleRate) || maxBlockSize < 1
+        || ! juce::isPositiveAndNotGreaterThan(numChannels, maxChannels))
+        return false;
+
+    currentSampleRate = sampleRate;
+    preparedBlockSize = maxBlockSize;
+    preparedChannels = numChannels;
+
+    arena.reserve(getArenaBytes(sampleRate, maxBlockSize, numChannels));
+    arena.allocateBuffer(dryBuffer, numChannels, maxBlockSize);
+    dryDelay.prepare(Dirt::getMaxLatencySamples(sampleRate), numChannels, arena);
+
+    tape.prepare(sampleRate, maxBlockSize, numChannels, arena);
+    noise.prepare(sampleRate, maxBlockSize, numChannels, arena);
+    dirt.prepare(sampleRate, maxBlockSize, numChannels, arena);
+    pump.prepare(sampleRate, maxBlockSize, numChannels);
+
+    wetMixSmoother.reset(sampleRate, gainSmoothingMs);
+    outputGainSmoother.reset(sampleRate, gainSmoothingMs);
+    bypassSmoother.reset(sampleRate, bypassRampSeconds);
+    morphPositionSmoother.reset(sampleRate, morphRampSeconds);
+
+    reset();
+    return true;
+}
+
+void Engine::reset() noexcept
+{
+    if (! isPrepared())
+        return;
+
+    morphPositionSmoother.setCurrentAndTargetValue(values[params::toIndex(P::morphPosition)]);
+    parametersChanged = true;
+    updateParameters(0);
+
+    tape.reset();
+    noise.reset();
+    dirt.reset();
+    pump.reset();
+    dryDelay.reset();
+    dryDelay.setDelay(latencySamples);
+
+    wetMixSmoother.setImmediate(wetMix);
+    outputGainSmoother.setImmediate(outputGain);
+    bypassSmoother.setCurrentAndTargetValue(hardBypass ? 1.0f : 0.0f);
+    bypassTransitionActive = false;
+}
+
+bool Engine::setParameter(size_t index, float plainValue) noexcept
+{
+    if (index >= params::numParameters || ! std::isfinite(plainValue))
+        return false;
+
+    const auto range = getParameterRange(index);
+    auto value = juce::jlimit(range.minValue, range.maxValue, plainValue);
+    if (range.isDiscrete)
+        value = std::round(value);
+
+    values[index] = value;
+    parametersChanged = true;
+    return true;
+}
+
+float Engine::getParameter(size_t index) const noexcept
+{
+    return index < params::numParameters ? values[index] : 0.0f;
+}
+
+bool Engine::setTempo(double bpm) noexcept
+{
+    if (! (bpm > 0.0 && std::isfinite(bpm)))
+        return false;
+
+    tempoBpm = bpm;
+    return true;
+}
+
+size_t Engine::getStateSize() noexcept
+{
+    return params::getBinaryStateSize(params::numParameters);
+}
+
+size_t Engine::getState(void* destination, size_t capacity) const noexcept
+{
+    return params::writeBinaryState(values, destination, capacity);
+}
+
+bool Engine::setState(const void* data, size_t numBytes) noexcept
+{
+    if (numBytes > static_cast<size_t>(std::numeric_limits<int>::max()))
+        return false;
+
+    // Decoded into a copy so a rejected blob leaves the current values alone; the plugin's routing
+    // chunk, if present, is ignored.
+    auto decoded = values;
+    if (params::readBinaryState(data, static_cast<int>(numBytes), decoded) < 0)
+        return false;
+
+    for (size_t index = 0; index < params::numParameters; ++index)
+        setParameter(index, decoded[index]);
+
+    return true;
+}
+
+void Engine::updateParameters(int numSamples) noexcept
+{
+    if (! parametersChanged && ! morphPositionSmoother.isSmoothing())
+        return;
+
+    parametersChanged = false;
+    auto snapshot = values;
+
+    auto getFloat = [&snapshot](P index) {
+        return snapshot[params::toIndex(index)];
+    };
+    auto getChoice = [&snapshot](P index) {
+        return static_cast<int>(snapshot[params::toIndex(index)]);
+    };
+
+    const auto morphMode = getChoice(P::morphMode);
+    const auto numSources = morphMode == 2 ? 4 : (morphMode == 1 ? 2 : 0);
+
+    if (numSources == 0)
+    {
+        morphPositionSmoother.setCurrentAndTargetValue(getFloat(P::morphPosition));
+    }
+    else
+    {
+        const presets::PresetMorphEngine::SourceIndices sourceIndices {
+            getChoice(P::morphPresetA), getChoice(P::morphPresetB), getChoice(P::morphPresetC), getChoice(P::morphPresetD)
+        };
+
+        if (numSources != morphEngine.getNumSources() || sourceIndices != morphEngine.getSourceIndices())
+            morphEngine.setSources(*factoryPresets, sourceIndices, numSources);
+
+        morphPositionSmoother.setTargetValue(getFloat(P::morphPosition));
+        morphPositionSmoother.skip(numSamples);
+        morphEngine.evaluate(morphPositionSmoother.getCurrentValue(), snapshot);
+    }
+
+    tapeParams.wowDepth = getFloat(P::tapeWowDepth);
+    tapeParams.wowRateHz = getFloat(P::tapeWowRateHz);
+    tapeParams.flutterDepth = getFloat(P::tapeFlutterDepth);
+    tapeParams.toneLowpassHz = getFloat(P::tapeToneLowpassHz);
+
+    noiseParams.levelDb = getFloat(P::tapeNoiseLevelDb);
+    noisePlacement = static_cast<dsp::NoisePlacement>(juce::jlimit(0, 2, getChoice(P::noiseRouting)));
+
+    dirtParams.saturationAmount = getFloat(P::dirtSaturationAmt);
+    dirtParams.bitDepth = getChoice(P::dirtBitDepthBits);
+    dirtParams.sampleRateDiv = getChoice(P::dirtSampleRateDiv);
+    dirtParams.targetSampleRate =
+        dsp::dirtTargetSampleRates[static_cast<size_t>(juce::jlimit(0, static_cast<int>(dsp::dirtTargetSampleRates.size()) - 1, getChoice(P::dirtTargetRate)))];
+    dirtParams.resamplerQuality = static_cast<dsp::ResamplerQuality>(juce::jlimit(0, 2, getChoice(P::dirtResampleQuality)));
+    dirtParams.oversamplingStages = juce::jlimit(0, dsp::oversampling::maxStages, getChoice(P::dirtOversampling));
+    dirtParams.saturationMode = static_cast<dsp::SaturationMode>(juce::jlimit(0, 1, getChoice(P::dirtSaturationMode)));
+
+    pumpParams.amount = getFloat(P::pumpAmount);
+    pumpParams.syncNoteIndex = juce::jlimit(0, 2, getChoice(P::pumpSyncNote));
+    pumpParams.phaseOffset = getFloat(P::pumpPhase);
+
+    tape.setParameters(tapeParams);
+    noise.setParameters(noiseParams);
+    dirt.setParameters(dirtParams);
+    pump.setParameters(pumpParams);
+
+    wetMix = getFloat(P::mixWet);
+    outputGain = juce::Decibels::decibelsToGain(getFloat(P::outputGainDb));
+    hardBypass = getFloat(P::hardBypass) > 0.5f;
+    moduleOrder = static_cast<dsp::ModuleOrder>(juce::jlimit(0, 2, getChoice(P::chainOrder)));
+
+    latencySamples = Dirt::getLatencySamples(dirtParams, currentSampleRate);
+}
+
+void Engine::process(float* const* channels, int numSamples) noexcept
+{
+    jassert(isPrepared());
+    if (! isPrepared() || channels == nullptr)
+        return;
+
+    std::array<float*, maxChannels> slice {};
+    for (int offset = 0; offset < numSamples; offset += preparedBlockSize)
+    {
+        for (int channel = 0; channel < preparedChannels; ++channel)
+            slice[static_cast<size_t>(channel)] = channels[channel] + offset;
+
+        processSlice(slice.data(), juce::jmin(preparedBlockSize, numSamples - offset));
+    }
+}
+
+void Engine::processSlice(float* const* channels, int numSamples) noexcept
+{
+    dsp::DenormalGuard guard;
+
+    updateParameters(numSamples);
+
+    for (int channel = 0; channel < preparedChannels; ++channel)
+        dryBuffer.copyFrom(channel, 0, channels[channel], numSamples);
+
+    dryDelay.setDelay(latencySamples);
+    dryDelay.process(dryBuffer, numSamples);
+
+    const float bypassTarget = hardBypass ? 1.0f : 0.0f;
+    if (bypassSmoother.getTargetValue() != bypassTarget)
+    {
+        bypassSmoother.setTargetValue(bypassTarget);
+        bypassTransitionActive = true;
+    }
+
+    // Bypassed output keeps the reported latency, as in the plugin.
+    if (hardBypass && ! bypassSmoother.isSmoothing())
+    {
+        if (dryDelay.getDelay() > 0)
+            for (int channel = 0; channel < preparedChannels; ++channel)
+                juce::FloatVectorOperations::copy(channels[channel], dryBuffer.getReadPointer(channel), numSamples);
+
+        return;
+    }
+
+    // Refers to the caller's channel pointers; fewer than 32 channels never allocates.
+    view.setDataToReferTo(channels, preparedChannels, numSamples);
+
+    const auto samplesPerCycle = juce::jmax(1.0, 60.0 / tempoBpm * currentSampleRate
+                                                     * syncNoteQuarters[static_cast<size_t>(pumpParams.syncNoteIndex)]);
+    pump.setSync(samplesPerCycle, pumpParams.phaseOffset);
+
+    noise.generate(numSamples);
+    graph.process(moduleOrder, noisePlacement, view, numSamples);
+
+    wetMixSmoother.setTarget(wetMix);
+    outputGainSmoother.setTarget(outputGain);
+
+    const auto& noiseBuffer = noise.getNoiseBuffer();
+    const bool noiseParallel = noisePlacement == dsp::NoisePlacement::parallel;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const auto gains = dsp::equalPowerMixGains(wetMixSmoother.getNextValue());
+        const auto sampleGain = outputGainSmoother.getNextValue();
+
+        for (int channel = 0; channel < preparedChannels; ++channel)
+        {
+            auto& wetSample = channels[channel][sample];
+            auto mixed = (dryBuffer.getSample(channel, sample) * gains.dry + wetSample * gains.wet) * sampleGain;
+
+            if (noiseParallel)
+                mixed += noiseBuffer.getSample(channel, sample) * sampleGain;
+
+            wetSample = mixed;
+        }
+    }
+
+    applyBypassRamp(numSamples);
+}
+
+void Engine::applyBypassRamp(int numSamples) noexcept
+{
+    if (! bypassTransitionActive && ! hardBypass)
+        return;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const auto bypassValue = bypassSmoother.getNextValue();
+        for (int channel = 0; channel < preparedChannels; ++channel)
+        {
+            auto* wet = view.getWritePointer(channel);
+            wet[sample] = dryBuffer.getSample(channel, sample) * bypassValue + wet[sample] * (1.0f - bypassValue);
+        }
+    }
+
+    if (! bypassSmoother.isSmoothing())
+        bypassTransitionActive = false;
+}
+} // namespace dustbox::embed
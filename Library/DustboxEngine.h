@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+  File: DustboxEngine.h
+  Responsibility: Run the Dustbox module chain for one stream outside any
+                  plugin wrapper, behind the C API in include/dustbox.h.
+  Assumptions: The owner serialises every call on one engine. prepare() is the
+               only call that allocates; parameter, state and process calls
+               are allocation-free and lock-free afterwards. Float only.
+  Notes: Follows DustboxProcessor's default signal path: chainOrder and
+         noiseRouting through the compile-time ProcessingGraph, preset morph,
+         equal-power wet mix, output gain and a click-free hard bypass, with
+         the dry path delayed to match Dirt's latency. Custom routings, the CPU
+         governor and the offline quality tier are plugin features and are
+         left out; cpuBudget is stored but has no effect. Without a host
+         playhead the pump runs free at the tempo given to setTempo().
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "Dsp/modules/DirtModule.h"
+#include "Dsp/modules/NoiseModule.h"
+#include "Dsp/modules/PumpModule.h"
+#include "Dsp/modules/TapeModule.h"
+#include "Dsp/routing/ProcessingGraph.h"
+#include "Dsp/utils/DspArena.h"
+#include "Dsp/utils/LatencyDelay.h"
+#include "Dsp/utils/ParameterSmoother.h"
+#include "Parameters/ParameterIndex.h"
+#include "Parameters/ParameterRanges.h"
+#include "Presets/FactoryPresets.h"
+#include "Presets/PresetMorph.h"
+
+namespace dustbox::embed
+{
+class Engine
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    Engine() = default;
+
+    /** The range and default of a parameter; morph sources are bounded by the factory presets. */
+    params::ParameterRange getParameterRange(size_t index) const noexcept;
+
+    /** Sizes every buffer for blocks of up to maxBlockSize samples and resets the signal state.
+        Parameters are kept. Returns false for arguments outside the supported ranges. */
+    bool prepare(double sampleRate, int maxBlockSize, int numChannels);
+    bool isPrepared() const noexcept { return preparedChannels > 0; }
+    /** Clears delay lines, filters and ramps, as if the stream started again. */
+    void reset() noexcept;
+
+    /** Takes a plain value, clamped to the parameter's range and rounded for discrete ones. */
+    bool setParameter(size_t index, float plainValue) noexcept;
+    float getParameter(size_t index) const noexcept;
+    /** Tempo the pump syncs to; 120 BPM until set. Returns false for a non-positive tempo. */
+    bool setTempo(double bpm) noexcept;
+
+    /** Processes numChannels non-interleaved channels in place. Blocks longer than the prepared
+        size run in prepared-size slices. */
+    void process(float* const* channels, int numSamples) noexcept;
+
+    /** Samples the output lags the input by, for the current Dirt settings. */
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+    /** Writes the plugin's binary state format (parameters only) into destination. Returns the
+        bytes written, or 0 if capacity is below getStateSize(). */
+    size_t getState(void* destination, size_t capacity) const noexcept;
+    static size_t getStateSize() noexcept;
+    /** Accepts state from getState() or from the plugin; entries the blob lacks keep their values. */
+    bool setState(const void* data, size_t numBytes) noexcept;
+
+private:
+    using Tape = dsp::TapeModule<float>;
+    using Noise = dsp::NoiseModule<float>;
+    using Dirt = dsp::DirtModule<float>;
+    using Pump = dsp::PumpModule<float>;
+
+    static size_t getArenaBytes(double sampleRate, int maxBlockSize, int numChannels) noexcept;
+
+    void updateParameters(int numSamples) noexcept;
+    void processSlice(float* const* channels, int numSamples) noexcept;
+    void applyBypassRamp(int numSamples) noexcept;
+
+    // One immutable table per process, shared with any plugin instances loaded alongside.
+    juce::SharedResourcePointer<presets::FactoryPresetTable> factoryPresets;
+
+    params::ParameterValues values { params::getDefaultParameterValues() };
+    bool parametersChanged { true };
+
+    Tape tape;
+    Noise noise;
+    Dirt dirt;
+    Pump pump;
+    dsp::ProcessingGraph<Tape, Dirt, Pump, Noise> graph { tape, dirt, pump, noise };
+
+    // Backs the dry copy, its delay and every module buffer; carved in prepare().
+    dsp::DspArena arena;
+    juce::AudioBuffer<float> dryBuffer;
+    dsp::LatencyDelay<float> dryDelay;
+    juce::AudioBuffer<float> view; // Refers to the caller's channels for the current slice.
+
+    dsp::ParameterSmoother<float> wetMixSmoother;
+    dsp::ParameterSmoother<float> outputGainSmoother;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> bypassSmoother;
+    bool bypassTransitionActive { false };
+
+    presets::PresetMorphEngine morphEngine;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> morphPositionSmoother;
+
+    dsp::TapeParameters tapeParams;
+    dsp::DirtParameters dirtParams;
+    dsp::PumpParameters pumpParams;
+    dsp::NoiseParameters noiseParams;
+    dsp::NoisePlacement noisePlacement { dsp::NoisePlacement::postTape };
+    dsp::ModuleOrder moduleOrder { dsp::ModuleOrder::tapeDirtPump };
+    float wetMix { 0.5f };
+    float outputGain { 1.0f };
+    bool hardBypass { false };
+
+    double currentSampleRate { 44100.0 };
+    double tempoBpm { 120.0 };
+    int preparedBlockSize { 0 };
+    int preparedChannels { 0 };
+    int latencySamples { 0 };
+};
+} // namespace dustbox::embed
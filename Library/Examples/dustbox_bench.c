@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+  File: dustbox_bench.c
+  Responsibility: Show the libdustbox C API end to end and time it: render a
+                  sine through the engine and print the cost per block and the
+                  realtime factor.
+  Assumptions: POSIX clock_gettime(). Usage:
+               dustbox_bench [sample_rate] [block_size] [channels] [seconds]
+               [parameter_id=value ...]
+  ==============================================================================
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "dustbox.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec * 1.0e-9;
+}
+
+static int find_parameter(const dustbox_engine* engine, const char* id, size_t id_length)
+{
+    const int32_t count = dustbox_get_parameter_count();
+    for (int32_t index = 0; index < count; ++index)
+    {
+        dustbox_parameter_info info;
+        if (dustbox_get_parameter_info(engine, index, &info) == DUSTBOX_OK
+            && strlen(info.id) == id_length && strncmp(info.id, id, id_length) == 0)
+            return index;
+    }
+
+    return -1;
+}
+
+static int apply_setting(dustbox_engine* engine, const char* setting)
+{
+    const char* separator = strchr(setting, '=');
+    const int index = separator != NULL ? find_parameter(engine, setting, (size_t) (separator - setting)) : -1;
+
+    if (index < 0 || dustbox_set_parameter(engine, index, strtof(separator + 1, NULL)) != DUSTBOX_OK)
+    {
+        fprintf(stderr, "unknown parameter setting '%s'\n", setting);
+        return 0;
+    }
+
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    const double sample_rate = argc > 1 ? atof(argv[1]) : 48000.0;
+    const int32_t block_size = argc > 2 ? atoi(argv[2]) : 256;
+    const int32_t num_channels = argc > 3 ? atoi(argv[3]) : 2;
+    const double seconds = argc > 4 ? atof(argv[4]) : 60.0;
+
+    if (dustbox_get_api_version() >> 16 != DUSTBOX_API_VERSION_MAJOR)
+    {
+        fprintf(stderr, "libdustbox API %u does not match this client\n", dustbox_get_api_version());
+        return 1;
+    }
+
+    dustbox_engine* engine = dustbox_create();
+    if (engine == NULL || dustbox_prepare(engine, sample_rate, block_size, num_channels) != DUSTBOX_OK)
+    {
+        fprintf(stderr, "cannot prepare %d channels of %d samples at %.0f Hz\n", num_channels, block_size, sample_rate);
+        dustbox_destroy(engine);
+        return 1;
+    }
+
+    for (int argument = 5; argument < argc; ++argument)
+    {
+        if (! apply_setting(engine, argv[argument]))
+        {
+            dustbox_destroy(engine);
+            return 1;
+        }
+    }
+
+    float* storage = calloc((size_t) num_channels * (size_t) block_size, sizeof(float));
+    if (storage == NULL)
+    {
+        dustbox_destroy(engine);
+        return 1;
+    }
+
+    float* channels[DUSTBOX_MAX_CHANNELS];
+    for (int32_t channel = 0; channel < num_channels; ++channel)
+        channels[channel] = storage + (size_t) channel * (size_t) block_size;
+
+    const long num_blocks = (long) ceil(seconds * sample_rate / block_size);
+    const double phase_increment = 2.0 * 3.14159265358979323846 * 220.0 / sample_rate;
+    double phase = 0.0;
+    double total = 0.0;
+    double worst = 0.0;
+
+    for (long block = 0; block < num_blocks; ++block)
+    {
+        for (int32_t sample = 0; sample < block_size; ++sample)
+        {
+            const float value = (float) (0.5 * sin(phase));
+            phase = fmod(phase + phase_increment, 2.0 * 3.14159265358979323846);
+            for (int32_t channel = 0; channel < num_channels; ++channel)
+                channels[channel][sample] = value;
+        }
+
+        const double start = now_seconds();
+        dustbox_process(engine, channels, block_size);
+        const double elapsed = now_seconds() - start;
+
+        total += elapsed;
+        if (elapsed > worst)
+            worst = elapsed;
+    }
+
+    /* Settings survive a round trip through the plugin's state format. */
+    unsigned char state[1024];
+    size_t state_size = sizeof(state);
+    const int state_ok = dustbox_get_state(engine, state, &state_size) == DUSTBOX_OK
+                         && dustbox_set_state(engine, state, state_size) == DUSTBOX_OK;
+
+    printf("libdustbox API %u.%u: %d ch, %d samples, %.0f Hz, latency %d samples\n",
+           dustbox_get_api_version() >> 16, dustbox_get_api_version() & 0xffffu,
+           num_channels, block_size, sample_rate, dustbox_get_latency_samples(engine));
+    printf("%ld blocks: mean %.2f us, worst %.2f us, %.1fx realtime\n",
+           num_blocks, 1.0e6 * total / (double) num_blocks, 1.0e6 * worst,
+           total > 0.0 ? (double) num_blocks * block_size / sample_rate / total : 0.0);
+    printf("state: %zu bytes, round trip %s\n", state_size, state_ok ? "ok" : "FAILED");
+
+    free(storage);
+    dustbox_destroy(engine);
+    return state_ok ? 0 : 1;
+}
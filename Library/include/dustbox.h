@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+  File: dustbox.h
+  Responsibility: Declare libdustbox's C API, which runs the Dustbox tape, dirt
+                  and pump chain without the plugin wrapper.
+  Assumptions: Calls on one engine must not overlap; different engines may run
+               on different threads. dustbox_create() and dustbox_prepare()
+               allocate. Every other call is allocation-free and lock-free, so
+               it may run on a realtime thread once the engine is prepared.
+  Notes: The ABI is plain C with an opaque handle and fixed-width types.
+         Functions are only ever added, so DUSTBOX_API_VERSION goes up for
+         additions and a build is compatible with any header of the same
+         major version. Parameters use the plugin's stable indices and plain
+         (unnormalised) values; choice parameters take their index. State is
+         the plugin's binary state, so the plugin and the library can load
+         each other's settings.
+  ==============================================================================
+*/
+
+#ifndef DUSTBOX_H
+#define DUSTBOX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(DUSTBOX_BUILDING_LIBRARY)
+        #define DUSTBOX_API __declspec(dllexport)
+    #else
+        #define DUSTBOX_API __declspec(dllimport)
+    #endif
+#else
+    #define DUSTBOX_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUSTBOX_API_VERSION_MAJOR 1
+#define DUSTBOX_API_VERSION_MINOR 0
+#define DUSTBOX_API_VERSION ((DUSTBOX_API_VERSION_MAJOR << 16) | DUSTBOX_API_VERSION_MINOR)
+
+/** Largest channel count dustbox_prepare() accepts. */
+#define DUSTBOX_MAX_CHANNELS 16
+
+typedef struct dustbox_engine dustbox_engine;
+
+typedef enum dustbox_result
+{
+    DUSTBOX_OK = 0,
+    DUSTBOX_ERROR_INVALID_ARGUMENT = -1, /* Null handle or pointer, or a value out of range. */
+    DUSTBOX_ERROR_NOT_PREPARED = -2,     /* dustbox_process() before a successful dustbox_prepare(). */
+    DUSTBOX_ERROR_INVALID_STATE = -3,    /* Not a Dustbox state blob, or a corrupted one. */
+    DUSTBOX_ERROR_BUFFER_TOO_SMALL = -4,
+    DUSTBOX_ERROR_OUT_OF_MEMORY = -5
+} dustbox_result;
+
+typedef struct dustbox_parameter_info
+{
+    const char* id;      /* Stable identifier shared with the plugin, e.g. "tapeWowDepth". */
+    float min_value;
+    float max_value;
+    float default_value;
+    int32_t is_discrete; /* Non-zero for whole-number (int, bool and choice) parameters. */
+} dustbox_parameter_info;
+
+/** DUSTBOX_API_VERSION of the library actually loaded. */
+DUSTBOX_API uint32_t dustbox_get_api_version(void);
+
+/** Returns a new engine with every parameter at its default, or NULL when out of memory. */
+DUSTBOX_API dustbox_engine* dustbox_create(void);
+/** Accepts NULL. */
+DUSTBOX_API void dustbox_destroy(dustbox_engine* engine);
+
+/** Sizes the engine for blocks of up to max_block_size samples of num_channels channels at
+    sample_rate, and resets its signal state. Parameters are kept. May be called again. */
+DUSTBOX_API dustbox_result dustbox_prepare(dustbox_engine* engine, double sample_rate, int32_t max_block_size, int32_t num_channels);
+/** Clears delay lines and filters, as if the stream started again. */
+DUSTBOX_API dustbox_result dustbox_reset(dustbox_engine* engine);
+
+DUSTBOX_API int32_t dustbox_get_parameter_count(void);
+DUSTBOX_API dustbox_result dustbox_get_parameter_info(const dustbox_engine* engine, int32_t index, dustbox_parameter_info* info);
+/** Clamps to the parameter's range and rounds discrete parameters; takes effect at the next block. */
+DUSTBOX_API dustbox_result dustbox_set_parameter(dustbox_engine* engine, int32_t index, float value);
+DUSTBOX_API dustbox_result dustbox_get_parameter(const dustbox_engine* engine, int32_t index, float* value);
+/** Tempo the pump syncs to; 120 BPM until set. */
+DUSTBOX_API dustbox_result dustbox_set_tempo(dustbox_engine* engine, double bpm);
+
+/** Processes num_samples samples in place. channels holds one pointer per prepared channel.
+    Blocks longer than max_block_size are split internally. */
+DUSTBOX_API dustbox_result dustbox_process(dustbox_engine* engine, float* const* channels, int32_t num_samples);
+/** Samples the output lags the input by; changes with the Dirt oversampling and target rate. */
+DUSTBOX_API int32_t dustbox_get_latency_samples(const dustbox_engine* engine);
+
+/** Bytes dustbox_get_state() writes. */
+DUSTBOX_API size_t dustbox_get_state_size(void);
+/** Writes the engine's settings into data; *size is the capacity on entry and the bytes written on
+    success, or the bytes needed on DUSTBOX_ERROR_BUFFER_TOO_SMALL. */
+DUSTBOX_API dustbox_result dustbox_get_state(const dustbox_engine* engine, void* data, size_t* size);
+/** Loads settings from dustbox_get_state() or from the plugin. A rejected blob changes nothing. */
+DUSTBOX_API dustbox_result dustbox_set_state(dustbox_engine* engine, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DUSTBOX_H */
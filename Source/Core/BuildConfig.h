@@ -9,11 +9,23 @@
 
 #pragma once
 
+// Set by CMake (DUSTBOX_ENABLE_STAGE_PROFILING); builds without it keep the timers.
+#ifndef DUSTBOX_ENABLE_STAGE_PROFILING
+ #define DUSTBOX_ENABLE_STAGE_PROFILING 1
+#endif
+
+// Set by CMake (DUSTBOX_REALTIME_SAFETY_CHECKS); a debug/test mode, off in release builds.
+#ifndef DUSTBOX_REALTIME_SAFETY_CHECKS
+ #define DUSTBOX_REALTIME_SAFETY_CHECKS 0
+#endif
+
 namespace dustbox
 {
 struct BuildConfig
 {
     static constexpr bool enableDenormalGuard = true;
+    static constexpr bool enableStageProfiling = DUSTBOX_ENABLE_STAGE_PROFILING != 0;
+    static constexpr bool enableRealtimeSafetyChecks = DUSTBOX_REALTIME_SAFETY_CHECKS != 0;
 };
 } // namespace dustbox
 
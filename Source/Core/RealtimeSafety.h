@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+  File: RealtimeSafety.h
+  Responsibility: Mark the code that must stay realtime-safe, so a checker that
+                  intercepts allocations and locks knows when to complain.
+  Assumptions: The mark is a per-thread depth counter; sections nest. Nothing
+               here checks anything by itself: the benchmark runner's checker
+               reads isInRealtimeSection() from its allocator and mutex hooks.
+  Notes: processBlock and each lane worker's share are marked only with
+         BuildConfig::enableRealtimeSafetyChecks, so plugin builds pay nothing.
+         Tools that play the host can always mark their own callback with
+         ScopedRealtimeSection::always(); work it hands to other threads
+         carries the mark with alsoWhen().
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BuildConfig.h"
+
+namespace dustbox
+{
+namespace detail
+{
+inline thread_local int realtimeSectionDepth = 0;
+} // namespace detail
+
+inline bool isInRealtimeSection() noexcept
+{
+    return detail::realtimeSectionDepth > 0;
+}
+
+class ScopedRealtimeSection
+{
+public:
+    /** Marks the scope when realtime safety checks are compiled in. */
+    ScopedRealtimeSection() noexcept
+        : ScopedRealtimeSection(BuildConfig::enableRealtimeSafetyChecks)
+    {
+    }
+
+    /** Marks the scope regardless of the build flag. */
+    static ScopedRealtimeSection always() noexcept { return ScopedRealtimeSection(true); }
+
+    /** Marks the scope when checks are compiled in or shouldMark is set, e.g. for work handed
+        over by a thread that was inside a section. */
+    static ScopedRealtimeSection alsoWhen(bool shouldMark) noexcept
+    {
+        return ScopedRealtimeSection(BuildConfig::enableRealtimeSafetyChecks || shouldMark);
+    }
+
+    ~ScopedRealtimeSection()
+    {
+        if (marked)
+            --detail::realtimeSectionDepth;
+    }
+
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+
+private:
+    explicit ScopedRealtimeSection(bool shouldMark) noexcept
+        : marked(shouldMark)
+    {
+        if (marked)
+            ++detail::realtimeSectionDepth;
+    }
+
+    bool marked;
+};
+} // namespace dustbox
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+  File: TraceRecorder.cpp
+  Responsibility: Implement the event ring and the background thread that turns
+                  it into a Chrome trace-event JSON file.
+  Assumptions: The ring is the bounded multi-producer queue from Vyukov: each
+               slot carries a sequence number, producers claim a position with
+               a CAS and publish it by bumping the sequence, and the single
+               consumer (the writer) hands the slot back by advancing it a
+               full lap. Event names are plain identifiers that need no JSON
+               escaping.
+  ==============================================================================
+*/
+
+#include "TraceRecorder.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+namespace dustbox
+{
+namespace
+{
+constexpr int flushIntervalMs = 20;
+
+uint32_t getCurrentThreadNumber() noexcept
+{
+    const auto id = reinterpret_cast<uintptr_t>(juce::Thread::getCurrentThreadId());
+    return static_cast<uint32_t>(static_cast<uint64_t>(id) ^ (static_cast<uint64_t>(id) >> 32));
+}
+} // namespace
+
+class TraceRecorder::Writer : public juce::Thread
+{
+public:
+    Writer(TraceRecorder& ownerRecorder, std::unique_ptr<juce::FileOutputStream> streamToUse)
+        : juce::Thread("Dustbox trace writer"),
+          owner(ownerRecorder),
+          stream(std::move(streamToUse)),
+          startTicks(juce::Time::getHighResolutionTicks()),
+          microsPerTick(1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+    {
+        writeText("{\"traceEvents\":[\n");
+    }
+
+    ~Writer() override { stopThread(1000); }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait(flushIntervalMs);
+        }
+    }
+
+    /** Stops the thread, writes what is left and closes the JSON document. */
+    void finish()
+    {
+        stopThread(1000);
+        drain();
+
+        writeText("\n],\"displayTimeUnit\":\"ms\"}\n");
+        stream->flush();
+    }
+
+private:
+    void drain()
+    {
+        Event event;
+        while (owner.pop(event))
+            writeEvent(event);
+
+        stream->flush();
+    }
+
+    void writeEvent(const Event& event)
+    {
+        // Name each instance's track the first time it shows up.
+        if (namedInstances.insert(event.instance).second)
+        {
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"Dustbox #%d\"}}",
+                          event.instance, event.instance);
+            writeLine();
+        }
+
+        const auto micros = static_cast<double>(juce::jmax<juce::int64>(0, event.ticks - startTicks)) * microsPerTick;
+
+        if (event.phase == 'C')
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%" PRIu32 ",\"args\":{\"value\":%g}}",
+                          event.name, micros, event.instance, event.thread, static_cast<double>(event.value));
+        else if (event.phase == 'i')
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"%s\",\"cat\":\"dustbox\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%" PRIu32 "}",
+                          event.name, micros, event.instance, event.thread);
+        else
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"%s\",\"cat\":\"dustbox\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%" PRIu32 "}",
+                          event.name, event.phase, micros, event.instance, event.thread);
+
+        writeLine();
+    }
+
+    void writeLine()
+    {
+        if (! firstLine)
+            writeText(",\n");
+
+        firstLine = false;
+        writeText(line);
+    }
+
+    void writeText(const char* text) { stream->write(text, std::strlen(text)); }
+
+    TraceRecorder& owner;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    const juce::int64 startTicks;
+    const double microsPerTick;
+    std::set<int> namedInstances;
+    char line[256] {};
+    bool firstLine { true };
+};
+
+TraceRecorder::TraceRecorder() = default;
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+}
+
+bool TraceRecorder::start(const juce::File& file)
+{
+    stop();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (! stream->openedOk())
+        return false;
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    if (slots == nullptr)
+    {
+        slots = std::make_unique<Slot[]>(ringCapacity);
+        for (size_t index = 0; index < ringCapacity; ++index)
+            slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+
+    // Anything a straggler pushed after the previous stop() belongs to no file.
+    Event discarded;
+    while (pop(discarded))
+    {
+    }
+
+    droppedEvents.store(0, std::memory_order_relaxed);
+    writer = std::make_unique<Writer>(*this, std::move(stream));
+    writer->startThread(juce::Thread::Priority::low);
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    if (writer == nullptr)
+        return;
+
+    recording.store(false, std::memory_order_release);
+    writer->finish();
+    writer.reset();
+}
+
+void TraceRecorder::push(const char* name, int instance, juce::int64 ticks, char phase, float value) noexcept
+{
+    if (! isRecording())
+        return;
+
+    auto position = writeIndex.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+
+    for (;;)
+    {
+        slot = &slots[static_cast<size_t>(position & (ringCapacity - 1))];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+        if (difference == 0)
+        {
+            if (writeIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // The writer has not caught up; drop rather than wait on the audio thread.
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = writeIndex.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->event.ticks = ticks;
+    slot->event.name = name;
+    slot->event.thread = getCurrentThreadNumber();
+    slot->event.instance = instance;
+    slot->event.value = value;
+    slot->event.phase = phase;
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::pop(Event& event) noexcept
+{
+    auto& slot = slots[static_cast<size_t>(readIndex & (ringCapacity - 1))];
+    if (slot.sequence.load(std::memory_order_acquire) != readIndex + 1)
+        return false;
+
+    event = slot.event;
+    slot.sequence.store(readIndex + ringCapacity, std::memory_order_release);
+    ++readIndex;
+    return true;
+}
+} // namespace dustbox
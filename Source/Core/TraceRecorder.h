@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+  File: TraceRecorder.h
+  Responsibility: Record timestamped begin/end, instant and counter events from
+                  any thread and stream them to a Chrome trace-event JSON file
+                  that chrome://tracing and Perfetto open directly.
+  Assumptions: start()/stop() run on the message thread (or a tool's main
+               thread). Recording calls are realtime-safe: no locks, no
+               allocation, and a full ring drops the event instead of waiting.
+               Event names must be string literals or otherwise outlive the
+               recording.
+  Notes: One recorder per process, shared through juce::SharedResourcePointer;
+         each processor registers as its own trace "process" so instances
+         show up as separate tracks. Events go into a bounded multi-producer
+         ring (lanes record concurrently) allocated by the first start(); a
+         background thread drains it every few milliseconds and formats JSON.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace dustbox
+{
+class TraceRecorder
+{
+public:
+    static constexpr size_t ringCapacity = size_t { 1 } << 17; // Events; a power of two.
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    /** Opens the file and starts recording; false if the file cannot be written. */
+    bool start(const juce::File& file);
+    /** Stops recording, writes what is still queued and closes the file. */
+    void stop();
+
+    bool isRecording() const noexcept { return recording.load(std::memory_order_acquire); }
+
+    /** Events that did not fit in the ring since the last start(). */
+    uint64_t getDroppedEventCount() const noexcept { return droppedEvents.load(std::memory_order_relaxed); }
+
+    /** A fresh trace process id for one processor instance. */
+    int registerInstance() noexcept { return nextInstance.fetch_add(1, std::memory_order_relaxed); }
+
+    void begin(const char* name, int instance, juce::int64 ticks) noexcept { push(name, instance, ticks, 'B', 0.0f); }
+    void end(const char* name, int instance, juce::int64 ticks) noexcept { push(name, instance, ticks, 'E', 0.0f); }
+    void instant(const char* name, int instance) noexcept
+    {
+        push(name, instance, juce::Time::getHighResolutionTicks(), 'i', 0.0f);
+    }
+    void counter(const char* name, int instance, float value) noexcept
+    {
+        push(name, instance, juce::Time::getHighResolutionTicks(), 'C', value);
+    }
+
+    /** Records a span around a scope on the current thread, if a recording is running. */
+    class ScopedSpan
+    {
+    public:
+        ScopedSpan(TraceRecorder& recorderToUse, const char* spanName, int spanInstance) noexcept
+            : recorder(recorderToUse.isRecording() ? &recorderToUse : nullptr), name(spanName), instance(spanInstance)
+        {
+            if (recorder != nullptr)
+                recorder->begin(name, instance, juce::Time::getHighResolutionTicks());
+        }
+
+        ~ScopedSpan()
+        {
+            if (recorder != nullptr)
+                recorder->end(name, instance, juce::Time::getHighResolutionTicks());
+        }
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    private:
+        TraceRecorder* recorder;
+        const char* name;
+        int instance;
+    };
+
+private:
+    struct Event
+    {
+        juce::int64 ticks { 0 };
+        const char* name { nullptr };
+        uint32_t thread { 0 };
+        int instance { 0 };
+        float value { 0.0f };
+        char phase { 'i' };
+    };
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence { 0 };
+        Event event;
+    };
+
+    class Writer;
+
+    void push(const char* name, int instance, juce::int64 ticks, char phase, float value) noexcept;
+    bool pop(Event& event) noexcept;
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> writeIndex { 0 };
+    uint64_t readIndex { 0 }; // Writer thread only.
+    std::atomic<bool> recording { false };
+    std::atomic<uint64_t> droppedEvents { 0 };
+    std::atomic<int> nextInstance { 1 };
+    std::unique_ptr<Writer> writer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TraceRecorder)
+};
+} // namespace dustbox
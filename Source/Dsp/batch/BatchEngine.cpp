@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+  File: BatchEngine.cpp
+  Responsibility: Implement the stream-parallel tape, dirt and pump kernels.
+  Assumptions: Each pack of streamsPerVector streams runs through the whole
+               block before the next, so its state stays in registers.
+               Delay taps differ per stream and are gathered lane by lane;
+               everything else is whole-vector arithmetic.
+  ==============================================================================
+*/
+
+#include "BatchEngine.h"
+
+#include "../utils/MathHelpers.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace dustbox::dsp
+{
+namespace
+{
+using Vector = BatchEngine::Vector;
+using Mask = BatchEngine::Mask;
+
+constexpr int lanes = BatchEngine::streamsPerVector;
+
+// The same curve constants as TapeModule, DirtModule and PumpModule.
+constexpr float baseDelayMs = 12.0f;
+constexpr float maxWowDepthMs = 6.0f;
+constexpr float maxFlutterDepthMs = 1.2f;
+constexpr float maxDelayMs = baseDelayMs + maxWowDepthMs + maxFlutterDepthMs + 4.0f;
+constexpr float minDelaySamples = 1.0f;
+constexpr float saturationFloor = 1.0e-4f;
+constexpr float decayPortion = 0.28f;
+constexpr float minimumGain = 0.05f;
+constexpr float pumpActiveFloor = 1.0e-4f;
+constexpr uint32_t maskTrue = 0xffffffffu;
+
+int roundUpToVectors(int count) noexcept
+{
+    return (count + lanes - 1) / lanes * lanes;
+}
+
+Vector select(Mask mask, Vector whenTrue, Vector whenFalse) noexcept
+{
+    return (whenTrue & mask) + (whenFalse & ~mask);
+}
+
+Vector clampUnit(Vector value) noexcept
+{
+    return Vector::max(Vector::expand(0.0f), Vector::min(Vector::expand(1.0f), value));
+}
+} // namespace
+
+int BatchEngine::computeDelayLength(double sampleRate) noexcept
+{
+    return static_cast<int>(std::ceil(sampleRate * (maxDelayMs * 0.001f))) + 4;
+}
+
+size_t BatchEngine::getArenaBytes(double sampleRate, int maxBlockSize, int numStreams, int numChannels) noexcept
+{
+    const auto slots = static_cast<size_t>(roundUpToVectors(numStreams));
+    const auto channels = static_cast<size_t>(numChannels);
+    return static_cast<size_t>(numStreamArrays) * DspArena::bytesFor<float>(slots)
+           + static_cast<size_t>(numChannelArrays) * DspArena::bytesFor<float>(slots * channels)
+           + DspArena::bytesFor<float>(channels * static_cast<size_t>(computeDelayLength(sampleRate)) * slots)
+           + DspArena::bytesFor<float>(channels * static_cast<size_t>(maxBlockSize) * lanes);
+}
+
+void BatchEngine::prepare(double sampleRate, int newMaxBlockSize, int newNumStreams, int newNumChannels)
+{
+    jassert(sampleRate > 0.0 && newMaxBlockSize > 0 && newNumStreams > 0);
+    jassert(newNumChannels > 0 && newNumChannels <= maxChannels);
+
+    currentSampleRate = sampleRate;
+    maxBlockSize = newMaxBlockSize;
+    numStreams = newNumStreams;
+    numSlots = roundUpToVectors(newNumStreams);
+    numChannels = newNumChannels;
+    delayLength = computeDelayLength(sampleRate);
+    writePosition = 0;
+
+    baseDelaySamples = static_cast<float>(sampleRate * (baseDelayMs * 0.001));
+    wowDepthRange = static_cast<float>(sampleRate * (maxWowDepthMs * 0.001));
+    flutterDepthRange = static_cast<float>(sampleRate * (maxFlutterDepthMs * 0.001));
+
+    arena.reserve(getArenaBytes(sampleRate, maxBlockSize, numStreams, numChannels));
+
+    const auto slots = static_cast<size_t>(numSlots);
+    for (auto* array : { &state.wowCos, &state.wowSin, &state.wowRotationCos, &state.wowRotationSin, &state.flutterCos,
+                         &state.flutterSin, &state.flutterRotationCos, &state.flutterRotationSin, &state.wowDepthSamples,
+                         &state.flutterDepthSamples, &state.toneCoefficient, &state.toneTarget, &state.drive,
+                         &state.inverseDrive, &state.step, &state.inverseStep, &state.divider, &state.pumpPhase,
+                         &state.pumpIncrement, &state.pumpOffset, &state.pumpMinGain, &state.dryGain, &state.wetGain,
+                         &state.outputGain })
+        *array = arena.allocate<float>(slots);
+
+    for (auto* array : { &state.saturate, &state.quantise, &state.pumpActive })
+        *array = arena.allocate<uint32_t>(slots);
+
+    const auto channelSlots = slots * static_cast<size_t>(numChannels);
+    for (auto* array : { &state.toneStates, &state.heldSamples, &state.holdCounters })
+        *array = arena.allocate<float>(channelSlots);
+
+    delayLines = arena.allocate<float>(static_cast<size_t>(numChannels) * static_cast<size_t>(delayLength) * slots);
+    packScratch = arena.allocate<float>(static_cast<size_t>(numChannels) * static_cast<size_t>(maxBlockSize) * lanes);
+
+    // Padded slots get defaults too, so their lanes stay finite.
+    const BatchStreamParameters defaults;
+    for (int slot = 0; slot < numSlots; ++slot)
+        writeParameters(slot, defaults);
+
+    reset();
+}
+
+void BatchEngine::reset() noexcept
+{
+    writePosition = 0;
+    for (int slot = 0; slot < numSlots; ++slot)
+        resetSlot(slot);
+}
+
+void BatchEngine::resetStream(int stream) noexcept
+{
+    jassert(stream >= 0 && stream < numStreams);
+    resetSlot(stream);
+}
+
+void BatchEngine::resetSlot(int slot) noexcept
+{
+    state.wowCos[slot] = 1.0f;
+    state.wowSin[slot] = 0.0f;
+    state.flutterCos[slot] = 1.0f;
+    state.flutterSin[slot] = 0.0f;
+    state.toneCoefficient[slot] = state.toneTarget[slot];
+    state.pumpPhase[slot] = 0.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto index = channel * numSlots + slot;
+        state.toneStates[index] = 0.0f;
+        state.heldSamples[index] = 0.0f;
+        state.holdCounters[index] = 0.0f;
+
+        auto* line = delayLines + static_cast<size_t>(channel) * static_cast<size_t>(delayLength) * static_cast<size_t>(numSlots);
+        for (int position = 0; position < delayLength; ++position)
+            line[static_cast<size_t>(position) * static_cast<size_t>(numSlots) + static_cast<size_t>(slot)] = 0.0f;
+    }
+}
+
+void BatchEngine::setParameters(int stream, const BatchStreamParameters& parameters) noexcept
+{
+    jassert(stream >= 0 && stream < numStreams);
+    writeParameters(stream, parameters);
+}
+
+void BatchEngine::writeParameters(int slot, const BatchStreamParameters& parameters) noexcept
+{
+    const auto sampleRate = static_cast<float>(currentSampleRate);
+    const auto twoPi = juce::MathConstants<float>::twoPi;
+
+    const auto& tape = parameters.tape;
+    const auto wowRate = juce::jlimit(0.1f, 5.0f, tape.wowRateHz);
+    const auto flutterRate = juce::jlimit(5.0f, 9.5f, 5.0f + tape.wowRateHz * 0.9f);
+    state.wowRotationCos[slot] = std::cos(twoPi * wowRate / sampleRate);
+    state.wowRotationSin[slot] = std::sin(twoPi * wowRate / sampleRate);
+    state.flutterRotationCos[slot] = std::cos(twoPi * flutterRate / sampleRate);
+    state.flutterRotationSin[slot] = std::sin(twoPi * flutterRate / sampleRate);
+    state.wowDepthSamples[slot] = wowDepthRange * juce::jlimit(0.0f, 1.0f, tape.wowDepth);
+    state.flutterDepthSamples[slot] = flutterDepthRange * juce::jlimit(0.0f, 1.0f, tape.flutterDepth);
+
+    const auto cutoff = juce::jlimit(20.0f, 0.5f * sampleRate - 10.0f, tape.toneLowpassHz);
+    state.toneTarget[slot] = 1.0f - std::exp(-twoPi * cutoff / sampleRate);
+
+    const auto& dirt = parameters.dirt;
+    const auto saturationAmount = juce::jlimit(0.0f, 1.0f, dirt.saturationAmount);
+    const auto saturate = saturationAmount > saturationFloor;
+    const auto drive = saturate ? 1.0f + 10.0f * saturationAmount * saturationAmount : 1.0f;
+    state.saturate[slot] = saturate ? maskTrue : 0u;
+    state.drive[slot] = drive;
+    state.inverseDrive[slot] = 1.0f / drive;
+
+    const auto bitDepth = juce::jlimit(4, 24, dirt.bitDepth);
+    const auto levelCount = static_cast<float>(std::ldexp(1.0, bitDepth) - 1.0);
+    state.quantise[slot] = bitDepth < 24 ? maskTrue : 0u;
+    state.step[slot] = 2.0f / levelCount;
+    state.inverseStep[slot] = 0.5f * levelCount;
+    state.divider[slot] = static_cast<float>(juce::jmax(1, dirt.sampleRateDiv));
+
+    const auto& pump = parameters.pump;
+    const auto amount = juce::jlimit(0.0f, 1.0f, pump.amount);
+    const auto depth = amount * amount;
+    state.pumpActive[slot] = amount > pumpActiveFloor ? maskTrue : 0u;
+    state.pumpMinGain[slot] = juce::jlimit(minimumGain, 1.0f, 1.0f - depth * 0.9f);
+    state.pumpOffset[slot] = juce::jlimit(0.0f, 1.0f, pump.phaseOffset);
+
+    // Same note values as HostTempo: 1/4, 1/8, 1/16.
+    const auto bpm = parameters.bpm > 0.0 ? parameters.bpm : 120.0;
+    const auto noteScale = pump.syncNoteIndex == 0 ? 1.0 : (pump.syncNoteIndex == 2 ? 0.25 : 0.5);
+    const auto samplesPerCycle = juce::jmax(1.0, 60.0 / bpm * currentSampleRate * noteScale);
+    state.pumpIncrement[slot] = static_cast<float>(1.0 / samplesPerCycle);
+
+    const auto gains = equalPowerMixGains(parameters.wetMix);
+    state.dryGain[slot] = gains.dry;
+    state.wetGain[slot] = gains.wet;
+    state.outputGain[slot] = parameters.outputGain;
+}
+
+void BatchEngine::process(float* const* channels, int numSamples) noexcept
+{
+    jassert(numSamples <= maxBlockSize);
+    if (numSamples <= 0)
+        return;
+
+    for (int firstStream = 0; firstStream < numStreams; firstStream += lanes)
+        processPack(firstStream, channels, numSamples);
+
+    writePosition = (writePosition + numSamples) % delayLength;
+}
+
+void BatchEngine::processPack(int firstStream, float* const* channels, int numSamples) noexcept
+{
+    const auto activeLanes = juce::jmin(lanes, numStreams - firstStream);
+    const auto slots = static_cast<size_t>(numSlots);
+    const auto channelScratch = static_cast<size_t>(maxBlockSize) * lanes;
+
+    // Transpose the pack's streams into [channel][sample][lane].
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            auto* destination = packScratch + static_cast<size_t>(channel) * channelScratch + static_cast<size_t>(lane);
+            if (lane < activeLanes)
+            {
+                const auto* source = channels[(firstStream + lane) * numChannels + channel];
+                for (int sample = 0; sample < numSamples; ++sample)
+                    destination[sample * lanes] = source[sample];
+            }
+            else
+            {
+                for (int sample = 0; sample < numSamples; ++sample)
+                    destination[sample * lanes] = 0.0f;
+            }
+        }
+    }
+
+    auto load = [firstStream](const float* array) noexcept { return Vector::fromRawArray(array + firstStream); };
+    auto loadMask = [firstStream](const uint32_t* array) noexcept { return Mask::fromRawArray(array + firstStream); };
+    auto store = [firstStream](const Vector& value, float* array) noexcept { value.copyToRawArray(array + firstStream); };
+
+    auto wowCos = load(state.wowCos);
+    auto wowSin = load(state.wowSin);
+    auto flutterCos = load(state.flutterCos);
+    auto flutterSin = load(state.flutterSin);
+    auto toneCoefficient = load(state.toneCoefficient);
+    auto pumpPhase = load(state.pumpPhase);
+    const auto wowRotationCos = load(state.wowRotationCos);
+    const auto wowRotationSin = load(state.wowRotationSin);
+    const auto flutterRotationCos = load(state.flutterRotationCos);
+    const auto flutterRotationSin = load(state.flutterRotationSin);
+    const auto wowDepth = load(state.wowDepthSamples);
+    const auto flutterDepth = load(state.flutterDepthSamples);
+    const auto toneStep = (load(state.toneTarget) - toneCoefficient) * (1.0f / static_cast<float>(numSamples));
+    const auto drive = load(state.drive);
+    const auto inverseDrive = load(state.inverseDrive);
+    const auto step = load(state.step);
+    const auto inverseStep = load(state.inverseStep);
+    const auto divider = load(state.divider);
+    const auto pumpIncrement = load(state.pumpIncrement);
+    const auto pumpOffset = load(state.pumpOffset);
+    const auto pumpMinGain = load(state.pumpMinGain);
+    const auto dryGain = load(state.dryGain);
+    const auto wetGain = load(state.wetGain);
+    const auto outputGain = load(state.outputGain);
+    const auto saturate = loadMask(state.saturate);
+    const auto quantise = loadMask(state.quantise);
+    const auto pumpActive = loadMask(state.pumpActive);
+
+    std::array<Vector, maxChannels> toneStates {};
+    std::array<Vector, maxChannels> heldSamples {};
+    std::array<Vector, maxChannels> holdCounters {};
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto offset = static_cast<size_t>(channel) * slots;
+        toneStates[static_cast<size_t>(channel)] = load(state.toneStates + offset);
+        heldSamples[static_cast<size_t>(channel)] = load(state.heldSamples + offset);
+        holdCounters[static_cast<size_t>(channel)] = load(state.holdCounters + offset);
+    }
+
+    const auto zero = Vector::expand(0.0f);
+    const auto one = Vector::expand(1.0f);
+    const auto half = Vector::expand(0.5f);
+    const auto minusHalf = Vector::expand(-0.5f);
+    const auto minusOne = Vector::expand(-1.0f);
+    const auto baseDelay = Vector::expand(baseDelaySamples);
+    const auto minDelay = Vector::expand(minDelaySamples);
+    const auto maxDelay = Vector::expand(static_cast<float>(delayLength - 2));
+    const auto lengthSamples = Vector::expand(static_cast<float>(delayLength));
+    const auto decay = Vector::expand(decayPortion);
+    const auto pumpHeadroom = one - pumpMinGain;
+
+    alignas(DspArena::cacheLineBytes) float wholeLanes[lanes] {};
+    alignas(DspArena::cacheLineBytes) float tap0[lanes] {};
+    alignas(DspArena::cacheLineBytes) float tap1[lanes] {};
+    size_t rows0[lanes] {};
+    size_t rows1[lanes] {};
+
+    auto writeIndex = writePosition;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // Tape modulation is per stream, shared by its channels.
+        const auto delaySamples = Vector::max(minDelay, Vector::min(maxDelay, baseDelay + wowDepth * wowSin + flutterDepth * flutterSin));
+
+        const auto nextWowCos = wowCos * wowRotationCos - wowSin * wowRotationSin;
+        wowSin = wowSin * wowRotationCos + wowCos * wowRotationSin;
+        wowCos = nextWowCos;
+        const auto nextFlutterCos = flutterCos * flutterRotationCos - flutterSin * flutterRotationSin;
+        flutterSin = flutterSin * flutterRotationCos + flutterCos * flutterRotationSin;
+        flutterCos = nextFlutterCos;
+
+        auto readPosition = Vector::expand(static_cast<float>(writeIndex)) - delaySamples;
+        readPosition = readPosition + (lengthSamples & Vector::lessThan(readPosition, zero));
+        const auto whole = Vector::truncate(readPosition);
+        const auto fraction = readPosition - whole;
+
+        whole.copyToRawArray(wholeLanes);
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const auto index0 = static_cast<int>(wholeLanes[lane]);
+            const auto index1 = index0 + 1 >= delayLength ? 0 : index0 + 1;
+            rows0[lane] = static_cast<size_t>(index0) * slots + static_cast<size_t>(firstStream + lane);
+            rows1[lane] = static_cast<size_t>(index1) * slots + static_cast<size_t>(firstStream + lane);
+        }
+
+        toneCoefficient = toneCoefficient + toneStep;
+
+        // Pump envelope: fast squared decay, then an eased release.
+        auto phase = pumpPhase + pumpOffset;
+        phase = phase - (one & Vector::greaterThanOrEqual(phase, one));
+        auto fall = one - clampUnit(phase * (1.0f / decayPortion));
+        fall = fall * fall;
+        const auto release = clampUnit((phase - decay) * (1.0f / (1.0f - decayPortion)));
+        const auto eased = release * release * (Vector::expand(3.0f) - release * 2.0f);
+        const auto envelope = select(pumpActive,
+                                     pumpMinGain + pumpHeadroom * select(Vector::lessThan(phase, decay), fall, eased),
+                                     one);
+        pumpPhase = pumpPhase + pumpIncrement;
+        pumpPhase = pumpPhase - (one & Vector::greaterThanOrEqual(pumpPhase, one));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto channelIndex = static_cast<size_t>(channel);
+            auto* lanesOut = packScratch + channelIndex * channelScratch + static_cast<size_t>(sample) * lanes;
+            auto* line = delayLines + channelIndex * static_cast<size_t>(delayLength) * slots;
+
+            const auto dry = Vector::fromRawArray(lanesOut);
+            dry.copyToRawArray(line + static_cast<size_t>(writeIndex) * slots + static_cast<size_t>(firstStream));
+
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                tap0[lane] = line[rows0[lane]];
+                tap1[lane] = line[rows1[lane]];
+            }
+
+            // Tape: linear tap, one-pole tone.
+            const auto delayed0 = Vector::fromRawArray(tap0);
+            const auto delayed = delayed0 + (Vector::fromRawArray(tap1) - delayed0) * fraction;
+            auto& toneState = toneStates[channelIndex];
+            toneState = toneState + toneCoefficient * (delayed - toneState);
+            auto wet = toneState;
+
+            // Dirt: soft clip, quantise, sample-and-hold.
+            const auto driven = wet * drive;
+            const auto shaped = (driven - driven * driven * driven * 0.3333333333f) * inverseDrive;
+            wet = select(saturate, shaped, wet);
+
+            const auto scaled = Vector::max(minusOne, Vector::min(one, wet)) * inverseStep;
+            const auto rounded = Vector::truncate(scaled + select(Vector::lessThan(scaled, zero), minusHalf, half));
+            wet = select(quantise, rounded * step, wet);
+
+            auto& counter = holdCounters[channelIndex];
+            auto& held = heldSamples[channelIndex];
+            const auto hold = Vector::lessThanOrEqual(counter, zero);
+            held = select(hold, wet, held);
+            counter = select(hold, divider, counter) - one;
+
+            // Pump, then the equal-power mix and output gain.
+            wet = held * envelope;
+            ((dry * dryGain + wet * wetGain) * outputGain).copyToRawArray(lanesOut);
+        }
+
+        if (++writeIndex >= delayLength)
+            writeIndex = 0;
+    }
+
+    // One Newton step back onto the unit circle keeps the phasors from drifting in amplitude.
+    const auto threeHalves = Vector::expand(1.5f);
+    const auto wowGain = threeHalves - (wowCos * wowCos + wowSin * wowSin) * 0.5f;
+    const auto flutterGain = threeHalves - (flutterCos * flutterCos + flutterSin * flutterSin) * 0.5f;
+    store(wowCos * wowGain, state.wowCos);
+    store(wowSin * wowGain, state.wowSin);
+    store(flutterCos * flutterGain, state.flutterCos);
+    store(flutterSin * flutterGain, state.flutterSin);
+    store(toneCoefficient, state.toneCoefficient);
+    store(pumpPhase, state.pumpPhase);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto offset = static_cast<size_t>(channel) * slots;
+        store(toneStates[static_cast<size_t>(channel)], state.toneStates + offset);
+        store(heldSamples[static_cast<size_t>(channel)], state.heldSamples + offset);
+        store(holdCounters[static_cast<size_t>(channel)], state.holdCounters + offset);
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int lane = 0; lane < activeLanes; ++lane)
+        {
+            const auto* source = packScratch + static_cast<size_t>(channel) * channelScratch + static_cast<size_t>(lane);
+            auto* destination = channels[(firstStream + lane) * numChannels + channel];
+            for (int sample = 0; sample < numSamples; ++sample)
+                destination[sample] = source[sample * lanes];
+        }
+    }
+}
+} // namespace dustbox::dsp
@@ -26,7 +26,43 @@ constexpr size_t maxSupportedChannels = 16;
 constexpr float saturationFloor = 1.0e-4f;
 }
 
-void DirtModule::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+template <typename SampleType>
+size_t DirtModule<SampleType>::getArenaBytes(double sampleRate, int samplesPerBlock, int numChannels) noexcept
+{
+    const auto channels = static_cast<size_t>(numChannels);
+    return DspArena::bytesFor<int>(channels) + 2 * DspArena::bytesFor<SampleType>(channels)
+           + PolyphaseOversampler<SampleType>::getArenaBytes(samplesPerBlock, numChannels)
+           + FractionalResampler<SampleType>::getArenaBytes(sampleRate, numChannels)
+           + LatencyDelay<SampleType>::getArenaBytes(getMaxLatencySamples(sampleRate), numChannels);
+}
+
+template <typename SampleType>
+int DirtModule<SampleType>::getLatencySamples(const Parameters& params, double sampleRate) noexcept
+{
+    return oversampling::getLatencySamples(juce::jlimit(0, oversampling::maxStages, params.oversamplingStages))
+           + resampling::getLatencySamples(sampleRate, params.targetSampleRate, params.resamplerQuality)
+           + juce::jmax(0, params.latencyCompensation);
+}
+
+template <typename SampleType>
+int DirtModule<SampleType>::getMaxLatencySamples(double sampleRate) noexcept
+{
+    Parameters widest;
+    widest.oversamplingStages = oversampling::maxStages;
+    widest.targetSampleRate = dirtTargetSampleRates[1];
+    widest.resamplerQuality = ResamplerQuality::high;
+    return getLatencySamples(widest, sampleRate);
+}
+
+template <typename SampleType>
+void DirtModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    ownedArena.reserve(getArenaBytes(sampleRate, samplesPerBlock, numChannels));
+    prepare(sampleRate, samplesPerBlock, numChannels, ownedArena);
+}
+
+template <typename SampleType>
+void DirtModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels, DspArena& arena)
 {
     currentSampleRate = sampleRate;
     preparedBlockSize = samplesPerBlock;
@@ -34,22 +70,35 @@ void DirtModule::prepare(double sampleRate, int samplesPerBlock, int numChannels
 
     jassert(numChannels <= static_cast<int>(maxSupportedChannels));
 
-    downsampleCounters.assign(static_cast<size_t>(numChannels), 0);
-    heldSamples.assign(static_cast<size_t>(numChannels), 0.0f);
+    downsampleCounters = arena.allocate<int>(static_cast<size_t>(numChannels));
+    heldSamples = arena.allocate<SampleType>(static_cast<size_t>(numChannels));
+    previousDriven = arena.allocate<SampleType>(static_cast<size_t>(numChannels));
+    oversampler.prepare(samplesPerBlock, numChannels, arena);
+    resampler.prepare(sampleRate, numChannels, arena);
+
+    // Compensation only ever tops a capped setting up to an uncapped one, so it never exceeds the widest.
+    compensationDelay.prepare(getMaxLatencySamples(sampleRate), numChannels, arena);
 }
 
-void DirtModule::reset()
+template <typename SampleType>
+void DirtModule<SampleType>::reset()
 {
-    std::fill(downsampleCounters.begin(), downsampleCounters.end(), 0);
-    std::fill(heldSamples.begin(), heldSamples.end(), 0.0f);
+    std::fill_n(downsampleCounters, numChannelsPrepared, 0);
+    std::fill_n(heldSamples, numChannelsPrepared, SampleType {});
+    std::fill_n(previousDriven, numChannelsPrepared, SampleType {});
+    oversampler.reset();
+    resampler.reset();
+    compensationDelay.reset();
 }
 
-void DirtModule::setParameters(const Parameters& newParams) noexcept
+template <typename SampleType>
+void DirtModule<SampleType>::setParameters(const Parameters& newParams) noexcept
 {
     parameters = newParams;
 }
 
-void DirtModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+template <typename SampleType>
+void DirtModule<SampleType>::processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
 {
     jassert(numSamples <= preparedBlockSize);
     const auto numChannels = buffer.getNumChannels();
@@ -58,63 +107,100 @@ void DirtModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
 
     const auto saturationAmount = juce::jlimit(0.0f, 1.0f, parameters.saturationAmount);
     const auto applySaturation = saturationAmount > saturationFloor;
-    const auto drive = applySaturation ? (1.0f + 10.0f * saturationAmount * saturationAmount) : 1.0f;
-    const auto inverseDrive = 1.0f / drive;
+    const auto drive = static_cast<SampleType>(applySaturation ? (1.0f + 10.0f * saturationAmount * saturationAmount) : 1.0f);
+    const auto inverseDrive = static_cast<SampleType>(1) / drive;
+    const auto antiderivative = parameters.saturationMode == SaturationMode::antiderivative;
 
     const auto bitDepth = juce::jlimit(4, 24, parameters.bitDepth);
     const auto bypassQuantiser = bitDepth >= 24;
-    const auto levelCount = static_cast<float>(std::ldexp(1.0, bitDepth) - 1.0);
-    const auto step = 2.0f / levelCount;
+    const auto levelCount = static_cast<SampleType>(std::ldexp(1.0, bitDepth) - 1.0);
+    const auto step = static_cast<SampleType>(2) / levelCount;
 
+    // A target rate replaces the divider; like oversampling, it applies even with the shaper idle.
+    resampler.setTarget(parameters.targetSampleRate, parameters.resamplerQuality);
+    const auto resampled = resampler.isActive();
     const auto divider = juce::jmax(1, parameters.sampleRateDiv);
-    const auto bypassDownsample = divider <= 1;
-
-    std::array<float*, maxSupportedChannels> channelPointers {};
+    const auto bypassDownsample = resampled || divider <= 1;
 
-    for (int channel = 0; channel < numChannels; ++channel)
-        channelPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
+    // Oversampled blocks always pass through the filters, even with the shaper idle, so the
+    // latency reported for the setting holds.
+    oversampler.setNumStages(parameters.oversamplingStages);
+    const auto oversampled = oversampler.getNumStages() > 0;
 
-    for (int channel = 0; channel < numChannels; ++channel)
+    auto shape = [&](SampleType* samples, int count, SampleType& previous) noexcept
     {
-        const auto channelIndex = static_cast<size_t>(channel);
-        auto* data = channelPointers[channelIndex];
-        auto counter = downsampleCounters[channelIndex];
-        auto held = heldSamples[channelIndex];
-
-        for (int sample = 0; sample < numSamples; ++sample)
+        for (int sample = 0; sample < count; ++sample)
         {
-            auto value = data[sample];
+            auto value = samples[sample];
 
             if (applySaturation)
             {
-                const auto driven = softClip(value * drive);
-                value = driven * inverseDrive;
+                const auto driven = value * drive;
+                const auto shaped = antiderivative ? softClipAntiderivative(previous, driven) : softClip(driven);
+                previous = driven;
+                value = shaped * inverseDrive;
             }
 
             if (! bypassQuantiser)
             {
-                const auto clamped = juce::jlimit(-1.0f, 1.0f, value);
+                const auto clamped = juce::jlimit(static_cast<SampleType>(-1), static_cast<SampleType>(1), value);
                 value = std::round(clamped / step) * step;
             }
 
-            if (! bypassDownsample)
+            samples[sample] = value;
+        }
+    };
+
+    std::array<SampleType*, maxSupportedChannels> channelPointers {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto channelIndex = static_cast<size_t>(channel);
+        auto* data = channelPointers[channelIndex];
+
+        if (oversampled)
+        {
+            shape(oversampler.upsample(channel, data, numSamples), numSamples * oversampler.getFactor(), previousDriven[channelIndex]);
+            oversampler.downsample(channel, data, numSamples);
+        }
+        else if (applySaturation || ! bypassQuantiser)
+        {
+            shape(data, numSamples, previousDriven[channelIndex]);
+        }
+
+        if (resampled)
+            resampler.process(channel, data, numSamples);
+
+        if (bypassDownsample)
+            continue;
+
+        auto counter = downsampleCounters[channelIndex];
+        auto held = heldSamples[channelIndex];
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            if (counter <= 0)
             {
-                if (counter <= 0)
-                {
-                    held = value;
-                    counter = divider;
-                }
-
-                value = held;
-                --counter;
+                held = data[sample];
+                counter = divider;
             }
 
-            data[sample] = value;
+            data[sample] = held;
+            --counter;
         }
 
         downsampleCounters[channelIndex] = counter;
         heldSamples[channelIndex] = held;
     }
+
+    compensationDelay.setDelay(parameters.latencyCompensation);
+    compensationDelay.process(buffer, numSamples);
 }
+
+template class DirtModule<float>;
+template class DirtModule<double>;
 } // namespace dustbox::dsp
 
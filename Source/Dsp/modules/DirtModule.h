@@ -4,6 +4,13 @@
   Responsibility: Encapsulate degradation processing (saturation/bit-depth/
                   downsampling) for the Dustbox signal chain.
   Assumptions: Module operates in-place on the provided buffer.
+  Notes: Templated on the buffer sample type; float and double are
+         instantiated in the .cpp. Per-channel state is carved from a
+         DspArena. Saturation and quantisation can run oversampled (2x-8x);
+         rate reduction always runs at the host rate, either as the integer
+         sample-and-hold divider or resampled to a fixed target rate. A
+         compensation delay lets the processor cap those filters under CPU
+         pressure without moving the latency it reported.
   TODO: Implement actual saturation curves and quantisation math.
   ==============================================================================
 */
@@ -11,32 +18,72 @@
 #pragma once
 
 #include <juce_dsp/juce_dsp.h>
-#include <vector>
+
+#include "../utils/DspArena.h"
+#include "../utils/FractionalResampler.h"
+#include "../utils/LatencyDelay.h"
+#include "../utils/PolyphaseOversampler.h"
+
+#include <array>
 
 namespace dustbox::dsp
 {
+enum class SaturationMode
+{
+    plain,         // softClip per sample; aliases at high drive unless oversampled.
+    antiderivative // First-order ADAA of the same curve; most of the aliasing for a few extra multiplies.
+};
+
+/** Target rates in the order of the dirtTargetRate choices; 0 keeps the integer divider. */
+inline constexpr std::array<double, 6> dirtTargetSampleRates { 0.0, 8000.0, 11025.0, 16000.0, 22050.0, 32000.0 };
+
+struct DirtParameters
+{
+    float saturationAmount { 0.35f };
+    int bitDepth { 12 };
+    int sampleRateDiv { 2 };
+    double targetSampleRate { 0.0 }; // Replaces sampleRateDiv when non-zero.
+    ResamplerQuality resamplerQuality { ResamplerQuality::fast };
+    int oversamplingStages { 0 }; // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x.
+    SaturationMode saturationMode { SaturationMode::plain };
+    int latencyCompensation { 0 }; // Extra delay so capped settings keep the latency of the ones they stand in for.
+};
+
+template <typename SampleType>
 class DirtModule
 {
 public:
-    struct Parameters
-    {
-        float saturationAmount { 0.35f };
-        int bitDepth { 12 };
-        int sampleRateDiv { 2 };
-    };
+    using Parameters = DirtParameters;
+
+    /** Bytes prepare() carves from the arena for this configuration, including 8x oversampling
+        and the lowest target rate. */
+    static size_t getArenaBytes(double sampleRate, int samplesPerBlock, int numChannels) noexcept;
+
+    /** Whole host-rate samples of delay the oversampling and resampling filters add, plus any
+        latency compensation. */
+    static int getLatencySamples(const Parameters& parameters, double sampleRate) noexcept;
+    /** The largest getLatencySamples() any setting reaches at this rate. */
+    static int getMaxLatencySamples(double sampleRate) noexcept;
 
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels, DspArena& arena);
+    /** Standalone use: carves from an arena owned by the module. */
     void prepare(double sampleRate, int samplesPerBlock, int numChannels);
     void reset();
     void setParameters(const Parameters& newParams) noexcept;
-    void processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept;
 
 private:
     Parameters parameters {};
     double currentSampleRate { 44100.0 };
     int preparedBlockSize { 0 };
     int numChannelsPrepared { 0 };
-    std::vector<int> downsampleCounters;
-    std::vector<float> heldSamples;
+    int* downsampleCounters { nullptr };
+    SampleType* heldSamples { nullptr };
+    SampleType* previousDriven { nullptr }; // Last shaper input per channel, for the ADAA difference.
+    PolyphaseOversampler<SampleType> oversampler;
+    FractionalResampler<SampleType> resampler;
+    LatencyDelay<SampleType> compensationDelay;
+    DspArena ownedArena;
 };
 } // namespace dustbox::dsp
 
@@ -20,30 +20,50 @@ constexpr uint32_t baseSeed = 0xC0FFEEu;
 constexpr uint32_t seedStride = 131u;
 } // namespace
 
-void NoiseModule::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+template <typename SampleType>
+size_t NoiseModule<SampleType>::getArenaBytes(int samplesPerBlock, int numChannels) noexcept
+{
+    return DspArena::bytesForBuffer<SampleType>(numChannels, samplesPerBlock)
+           + DspArena::bytesFor<NoiseGenerator>(static_cast<size_t>(numChannels));
+}
+
+template <typename SampleType>
+void NoiseModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels, int firstChannel)
+{
+    ownedArena.reserve(getArenaBytes(samplesPerBlock, numChannels));
+    prepare(sampleRate, samplesPerBlock, numChannels, ownedArena, firstChannel);
+}
+
+template <typename SampleType>
+void NoiseModule<SampleType>::prepare(double sampleRate,
+                                      int samplesPerBlock,
+                                      int numChannels,
+                                      DspArena& arena,
+                                      int firstChannel)
 {
     juce::ignoreUnused(sampleRate);
 
     jassert(numChannels <= static_cast<int>(maxSupportedChannels));
     preparedBlockSize = samplesPerBlock;
     numChannelsPrepared = numChannels;
+    firstSeedChannel = firstChannel;
 
-    noiseBuffer.setSize(numChannels, samplesPerBlock, false, false, true);
-    noiseBuffer.clear();
-
-    generators.resize(static_cast<size_t>(numChannels));
-    for (size_t i = 0; i < generators.size(); ++i)
-        generators[i].seed(baseSeed + static_cast<uint32_t>(i) * seedStride);
+    arena.allocateBuffer(noiseBuffer, numChannels, samplesPerBlock);
+    generators = arena.allocate<NoiseGenerator>(static_cast<size_t>(numChannels));
+    for (size_t i = 0; i < static_cast<size_t>(numChannels); ++i)
+        generators[i].seed(baseSeed + static_cast<uint32_t>(firstSeedChannel + static_cast<int>(i)) * seedStride);
 }
 
-void NoiseModule::reset()
+template <typename SampleType>
+void NoiseModule<SampleType>::reset()
 {
     noiseBuffer.clear();
-    for (size_t i = 0; i < generators.size(); ++i)
-        generators[i].seed(baseSeed + static_cast<uint32_t>(i) * seedStride);
+    for (size_t i = 0; i < static_cast<size_t>(numChannelsPrepared); ++i)
+        generators[i].seed(baseSeed + static_cast<uint32_t>(firstSeedChannel + static_cast<int>(i)) * seedStride);
 }
 
-void NoiseModule::generate(int numSamples) noexcept
+template <typename SampleType>
+void NoiseModule<SampleType>::generate(int numSamples) noexcept
 {
     jassert(numSamples <= preparedBlockSize);
     const auto numChannels = noiseBuffer.getNumChannels();
@@ -59,7 +79,7 @@ void NoiseModule::generate(int numSamples) noexcept
         return;
     }
 
-    std::array<float*, maxSupportedChannels> channelPointers {};
+    std::array<SampleType*, maxSupportedChannels> channelPointers {};
     for (int channel = 0; channel < numChannels; ++channel)
         channelPointers[static_cast<size_t>(channel)] = noiseBuffer.getWritePointer(channel);
 
@@ -68,9 +88,12 @@ void NoiseModule::generate(int numSamples) noexcept
         for (int channel = 0; channel < numChannels; ++channel)
         {
             const auto index = static_cast<size_t>(channel);
-            channelPointers[index][sample] = generators[index].getNextSample() * gain;
+            channelPointers[index][sample] = static_cast<SampleType>(generators[index].getNextSample() * gain);
         }
     }
 }
+
+template class NoiseModule<float>;
+template class NoiseModule<double>;
 } // namespace dustbox::dsp
 
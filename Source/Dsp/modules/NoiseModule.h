@@ -5,6 +5,9 @@
                   level for routing within the Dustbox processor.
   Assumptions: prepare() sizes buffers and seeds generators; generate() is
                called once per block on the realtime thread.
+  Notes: Templated on the buffer sample type (float and double instantiated);
+         both precisions produce the same generator sequence. The noise buffer
+         and generators are carved from a DspArena.
   ==============================================================================
 */
 
@@ -12,39 +15,50 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 
-#include <vector>
-
+#include "../utils/DspArena.h"
 #include "../utils/NoiseGenerator.h"
 #include "../utils/MathHelpers.h"
 
 namespace dustbox::dsp
 {
+struct NoiseParameters
+{
+    float levelDb { -48.0f };
+};
+
+template <typename SampleType>
 class NoiseModule
 {
 public:
-    struct Parameters
-    {
-        float levelDb { -48.0f };
-    };
+    using Parameters = NoiseParameters;
+
+    /** Bytes prepare() carves from the arena for this configuration. */
+    static size_t getArenaBytes(int samplesPerBlock, int numChannels) noexcept;
 
-    void prepare(double sampleRate, int samplesPerBlock, int numChannels);
+    /** firstChannel is the bus index of channel 0; seeds follow the bus index so split lanes
+        produce the same decorrelated noise as one wide module would. */
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels, DspArena& arena, int firstChannel = 0);
+    /** Standalone use: carves from an arena owned by the module. */
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels, int firstChannel = 0);
     void reset();
     void setParameters(const Parameters& newParams) noexcept { parameters = newParams; }
 
     void generate(int numSamples) noexcept;
 
-    const juce::AudioBuffer<float>& getNoiseBuffer() const noexcept { return noiseBuffer; }
+    const juce::AudioBuffer<SampleType>& getNoiseBuffer() const noexcept { return noiseBuffer; }
 
 private:
     static constexpr float noiseAudibleThreshold = 1.0e-6f;
 
     Parameters parameters {};
 
-    juce::AudioBuffer<float> noiseBuffer;
-    std::vector<NoiseGenerator> generators;
+    juce::AudioBuffer<SampleType> noiseBuffer;
+    NoiseGenerator* generators { nullptr };
+    DspArena ownedArena;
 
     int preparedBlockSize { 0 };
     int numChannelsPrepared { 0 };
+    int firstSeedChannel { 0 };
 };
 } // namespace dustbox::dsp
 
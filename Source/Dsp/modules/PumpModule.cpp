@@ -23,7 +23,8 @@ constexpr float decayPortion = 0.28f;
 constexpr float minimumGain = 0.05f;
 }
 
-void PumpModule::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+template <typename SampleType>
+void PumpModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels)
 {
     currentSampleRate = sampleRate;
     preparedBlockSize = samplesPerBlock;
@@ -32,31 +33,35 @@ void PumpModule::prepare(double sampleRate, int samplesPerBlock, int numChannels
     jassert(numChannels <= static_cast<int>(maxSupportedChannels));
 }
 
-void PumpModule::reset()
+template <typename SampleType>
+void PumpModule<SampleType>::reset()
 {
     phase = 0.0;
 }
 
-void PumpModule::setParameters(const Parameters& newParams) noexcept
+template <typename SampleType>
+void PumpModule<SampleType>::setParameters(const Parameters& newParams) noexcept
 {
     parameters = newParams;
 }
 
-void PumpModule::setSync(double newSamplesPerCycle, float phaseOffsetNormalised) noexcept
+template <typename SampleType>
+void PumpModule<SampleType>::setSync(double newSamplesPerCycle, float phaseOffsetNormalised) noexcept
 {
     samplesPerCycle = juce::jmax(1.0, newSamplesPerCycle);
     phaseIncrement = 1.0 / samplesPerCycle;
     phaseOffset = juce::jlimit(0.0f, 1.0f, phaseOffsetNormalised);
 }
 
-void PumpModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+template <typename SampleType>
+void PumpModule<SampleType>::processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
 {
     jassert(numSamples <= preparedBlockSize);
     const auto numChannels = buffer.getNumChannels();
     jassert(numChannels == numChannelsPrepared);
     jassert(numChannels <= static_cast<int>(maxSupportedChannels));
 
-    std::array<float*, maxSupportedChannels> channelPointers {};
+    std::array<SampleType*, maxSupportedChannels> channelPointers {};
     for (int channel = 0; channel < numChannels; ++channel)
         channelPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
 
@@ -93,7 +98,7 @@ void PumpModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
         }
 
         for (int channel = 0; channel < numChannels; ++channel)
-            channelPointers[static_cast<size_t>(channel)][sample] *= envelope;
+            channelPointers[static_cast<size_t>(channel)][sample] *= static_cast<SampleType>(envelope);
 
         localPhase += increment;
         if (localPhase >= 1.0)
@@ -102,5 +107,8 @@ void PumpModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
 
     phase = localPhase;
 }
+
+template class PumpModule<float>;
+template class PumpModule<double>;
 } // namespace dustbox::dsp
 
@@ -3,7 +3,8 @@
   File: PumpModule.h
   Responsibility: Provide tempo-synchronised gain modulation for Dustbox.
   Assumptions: Host tempo info is refreshed once per block via setSync().
-  Notes: Envelope shape is branch-light and suitable for realtime use.
+  Notes: Envelope shape is branch-light and suitable for realtime use. The
+         envelope is computed in float for both sample types.
   ==============================================================================
 */
 
@@ -13,21 +14,24 @@
 
 namespace dustbox::dsp
 {
+struct PumpParameters
+{
+    float amount { 0.35f };
+    int syncNoteIndex { 1 };
+    float phaseOffset { 0.0f };
+};
+
+template <typename SampleType>
 class PumpModule
 {
 public:
-    struct Parameters
-    {
-        float amount { 0.35f };
-        int syncNoteIndex { 1 };
-        float phaseOffset { 0.0f };
-    };
+    using Parameters = PumpParameters;
 
     void prepare(double sampleRate, int samplesPerBlock, int numChannels);
     void reset();
     void setParameters(const Parameters& newParams) noexcept;
     void setSync(double samplesPerCycle, float phaseOffsetNormalised) noexcept;
-    void processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept;
 
 private:
     static constexpr size_t maxSupportedChannels = 16;
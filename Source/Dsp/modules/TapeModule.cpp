@@ -17,16 +17,41 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 
+#include "../utils/MathHelpers.h"
+
 namespace dustbox::dsp
 {
 namespace
 {
 constexpr size_t maxSupportedChannels = 16; // Hard cap to keep stack allocations bounded.
 constexpr float minDelaySamples = 1.0f;
+constexpr float minCubicDelaySamples = 2.0f; // The fourth tap must already be written.
 constexpr float toneUpdateThreshold = 1.0e-3f;
 } // namespace
 
-void TapeModule::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+template <typename SampleType>
+int TapeModule<SampleType>::computeDelayBufferSize(double sampleRate) noexcept
+{
+    return static_cast<int>(std::ceil(sampleRate * (maxDelayMs * 0.001f))) + 4;
+}
+
+template <typename SampleType>
+size_t TapeModule<SampleType>::getArenaBytes(double sampleRate, int numChannels) noexcept
+{
+    const auto channels = static_cast<size_t>(numChannels);
+    return DspArena::bytesForBuffer<SampleType>(numChannels, computeDelayBufferSize(sampleRate))
+           + DspArena::bytesFor<int>(channels) + DspArena::bytesFor<SampleType>(channels);
+}
+
+template <typename SampleType>
+void TapeModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    ownedArena.reserve(getArenaBytes(sampleRate, numChannels));
+    prepare(sampleRate, samplesPerBlock, numChannels, ownedArena);
+}
+
+template <typename SampleType>
+void TapeModule<SampleType>::prepare(double sampleRate, int samplesPerBlock, int numChannels, DspArena& arena)
 {
     jassert(sampleRate > 0.0);
     jassert(numChannels <= static_cast<int>(maxSupportedChannels));
@@ -38,12 +63,11 @@ void TapeModule::prepare(double sampleRate, int samplesPerBlock, int numChannels
     wowDepthSamplesRange = static_cast<float>(sampleRate * (maxWowDepthMs * 0.001));
     flutterDepthSamplesRange = static_cast<float>(sampleRate * (maxFlutterDepthMs * 0.001));
 
-    delayBufferSize = static_cast<int>(std::ceil(sampleRate * (maxDelayMs * 0.001f))) + 4;
-    delayBuffer.setSize(numChannels, delayBufferSize, false, false, true);
-    delayBuffer.clear();
-
-    writePositions.assign(static_cast<size_t>(numChannels), 0);
-    toneStates.assign(static_cast<size_t>(numChannels), 0.0f);
+    // Carved memory arrives zeroed, so the delay line and states start silent.
+    delayBufferSize = computeDelayBufferSize(sampleRate);
+    arena.allocateBuffer(delayBuffer, numChannels, delayBufferSize);
+    writePositions = arena.allocate<int>(static_cast<size_t>(numChannels));
+    toneStates = arena.allocate<SampleType>(static_cast<size_t>(numChannels));
 
     toneCutoff.reset(sampleRate, 0.03f);
     toneCutoff.setCurrentAndTargetValue(parameters.toneLowpassHz);
@@ -54,11 +78,12 @@ void TapeModule::prepare(double sampleRate, int samplesPerBlock, int numChannels
     flutterPhase = 0.0f;
 }
 
-void TapeModule::reset()
+template <typename SampleType>
+void TapeModule<SampleType>::reset()
 {
     delayBuffer.clear();
-    std::fill(writePositions.begin(), writePositions.end(), 0);
-    std::fill(toneStates.begin(), toneStates.end(), 0.0f);
+    std::fill_n(writePositions, numChannelsPrepared, 0);
+    std::fill_n(toneStates, numChannelsPrepared, SampleType {});
 
     toneCutoff.setCurrentAndTargetValue(parameters.toneLowpassHz);
     lastToneCutoffHz = parameters.toneLowpassHz;
@@ -68,21 +93,25 @@ void TapeModule::reset()
     flutterPhase = 0.0f;
 }
 
-void TapeModule::setParameters(const Parameters& newParams) noexcept
+template <typename SampleType>
+void TapeModule<SampleType>::setParameters(const Parameters& newParams) noexcept
 {
     parameters = newParams;
     toneCutoff.setTargetValue(parameters.toneLowpassHz);
 }
 
-float TapeModule::computeToneCoefficient(float cutoffHz) const noexcept
+template <typename SampleType>
+SampleType TapeModule<SampleType>::computeToneCoefficient(float cutoffHz) const noexcept
 {
     const auto clampedCutoff = juce::jlimit(20.0f, static_cast<float>(0.5 * currentSampleRate - 10.0), cutoffHz);
-    const auto omega = juce::MathConstants<float>::twoPi * clampedCutoff / static_cast<float>(currentSampleRate);
+    const auto omega = juce::MathConstants<SampleType>::twoPi * static_cast<SampleType>(clampedCutoff)
+                       / static_cast<SampleType>(currentSampleRate);
     const auto expTerm = std::exp(-omega);
-    return 1.0f - expTerm;
+    return static_cast<SampleType>(1) - expTerm;
 }
 
-void TapeModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+template <typename SampleType>
+void TapeModule<SampleType>::processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
 {
     jassert(numSamples <= preparedBlockSize);
     const auto numChannels = buffer.getNumChannels();
@@ -102,9 +131,11 @@ void TapeModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
                                        ? juce::MathConstants<float>::twoPi * flutterRate / static_cast<float>(currentSampleRate)
                                        : 0.0f;
 
+    const auto cubic = parameters.interpolation == TapeInterpolation::cubic;
+    const auto minDelay = cubic ? minCubicDelaySamples : minDelaySamples;
     const auto maxDelaySamplesFloat = static_cast<float>(delayBufferSize - 2);
-    std::array<float*, maxSupportedChannels> bufferPointers {};
-    std::array<float*, maxSupportedChannels> delayPointers {};
+    std::array<SampleType*, maxSupportedChannels> bufferPointers {};
+    std::array<SampleType*, maxSupportedChannels> delayPointers {};
 
     for (int channel = 0; channel < numChannels; ++channel)
     {
@@ -127,7 +158,7 @@ void TapeModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
         const auto wowMod = wowDepthSamples * std::sin(localWowPhase);
         const auto flutterMod = flutterDepthSamples * std::sin(localFlutterPhase);
         auto delaySamples = baseDelaySamples + wowMod + flutterMod;
-        delaySamples = juce::jlimit(minDelaySamples, maxDelaySamplesFloat, delaySamples);
+        delaySamples = juce::jlimit(minDelay, maxDelaySamplesFloat, delaySamples);
 
         localWowPhase += wowIncrement;
         if (localWowPhase >= juce::MathConstants<float>::twoPi)
@@ -156,10 +187,21 @@ void TapeModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
             if (index1 >= delayBufferSize)
                 index1 -= delayBufferSize;
 
-            const auto frac = readPosition - static_cast<float>(index0);
+            const auto frac = static_cast<SampleType>(readPosition - static_cast<float>(index0));
             const auto delayed0 = delay[index0];
             const auto delayed1 = delay[index1];
-            const auto delayedSample = delayed0 + (delayed1 - delayed0) * frac;
+            SampleType delayedSample;
+
+            if (cubic)
+            {
+                const auto indexBefore = index0 == 0 ? delayBufferSize - 1 : index0 - 1;
+                const auto indexAfter = index1 + 1 >= delayBufferSize ? 0 : index1 + 1;
+                delayedSample = hermiteInterpolate(delay[indexBefore], delayed0, delayed1, delay[indexAfter], frac);
+            }
+            else
+            {
+                delayedSample = delayed0 + (delayed1 - delayed0) * frac;
+            }
 
             auto& toneState = toneStates[channelIndex];
             toneState += toneCoefficient * (delayedSample - toneState);
@@ -176,5 +218,8 @@ void TapeModule::processBlock(juce::AudioBuffer<float>& buffer, int numSamples)
     wowPhase = localWowPhase;
     flutterPhase = localFlutterPhase;
 }
+
+template class TapeModule<float>;
+template class TapeModule<double>;
 } // namespace dustbox::dsp
 
@@ -6,7 +6,9 @@
   Assumptions: prepare() is called before processBlock and parameters are
                updated from the owning processor.
   Notes: DSP implementation keeps allocations outside the realtime path and
-         remains zero-latency.
+         remains zero-latency. Templated on the audio sample type; float and
+         double are instantiated in the .cpp. Modulation stays in float. The
+         delay line and per-channel state are carved from a DspArena.
   ==============================================================================
 */
 
@@ -14,26 +16,42 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
-#include <vector>
+
+#include "../utils/DspArena.h"
 
 namespace dustbox::dsp
 {
+enum class TapeInterpolation
+{
+    linear, // Two taps; dulls the top octave slightly while the delay is modulated.
+    cubic   // Four-tap Hermite; flatter and cleaner, for offline renders.
+};
+
+struct TapeParameters
+{
+    float wowDepth { 0.15f };
+    float wowRateHz { 0.60f };
+    float flutterDepth { 0.08f };
+    float toneLowpassHz { 11000.0f };
+    TapeInterpolation interpolation { TapeInterpolation::linear };
+};
+
+template <typename SampleType>
 class TapeModule
 {
 public:
-    struct Parameters
-    {
-        float wowDepth { 0.15f };
-        float wowRateHz { 0.60f };
-        float flutterDepth { 0.08f };
-        float toneLowpassHz { 11000.0f };
-    };
+    using Parameters = TapeParameters;
+
+    /** Bytes prepare() carves from the arena for this configuration. */
+    static size_t getArenaBytes(double sampleRate, int numChannels) noexcept;
 
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels, DspArena& arena);
+    /** Standalone use: carves from an arena owned by the module. */
     void prepare(double sampleRate, int samplesPerBlock, int numChannels);
     void reset();
     void setParameters(const Parameters& newParams) noexcept;
 
-    void processBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept;
 
 private:
     static constexpr float baseDelayMs = 12.0f;
@@ -41,19 +59,21 @@ private:
     static constexpr float maxFlutterDepthMs = 1.2f;
     static constexpr float maxDelayMs = baseDelayMs + maxWowDepthMs + maxFlutterDepthMs + 4.0f;
 
-    float computeToneCoefficient(float cutoffHz) const noexcept;
+    static int computeDelayBufferSize(double sampleRate) noexcept;
+    SampleType computeToneCoefficient(float cutoffHz) const noexcept;
 
     Parameters parameters {};
 
-    juce::AudioBuffer<float> delayBuffer;
+    juce::AudioBuffer<SampleType> delayBuffer;
 
-    std::vector<int> writePositions;
-    std::vector<float> toneStates;
+    int* writePositions { nullptr };
+    SampleType* toneStates { nullptr };
+    DspArena ownedArena;
 
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> toneCutoff;
 
     double currentSampleRate { 44100.0 };
-    float toneCoefficient { 0.0f };
+    SampleType toneCoefficient { 0 };
     float lastToneCutoffHz { 0.0f };
 
     float baseDelaySamples { 0.0f };
@@ -1,33 +1,158 @@
 /*
   ==============================================================================
   File: ProcessingGraph.h
-  Responsibility: Provide a simple linear processing graph abstraction for the
-                  Dustbox signal chain.
-  Assumptions: Graph order is fixed (Tape → Dirt → Pump) for MVP.
-  TODO: Expand to support branching/parallel paths when feature scope increases.
+  Responsibility: Provide the Dustbox module chain as compile-time node lists,
+                  with a fixed set of orderings selectable per block.
+  Assumptions: Modules expose processBlock(buffer, numSamples) and outlive the
+               graph; the noise module has generated its block before process().
+  Notes: Every ordering/noise placement pair is its own ProcessingChain type, so
+         each chain compiles to straight-line calls (a fold over a tuple) with
+         no virtual dispatch. The per-block selection is a single index compare
+         chain over the instantiated orderings.
   ==============================================================================
 */
 
 #pragma once
 
-#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
 
 namespace dustbox::dsp
 {
+/** Module orderings the graph instantiates; values match the chainOrder parameter choices. */
+enum class ModuleOrder
+{
+    tapeDirtPump = 0,
+    dirtTapePump,
+    pumpTapeDirt,
+    count
+};
+
+/** Where generated noise joins the signal; values match the noiseRouting parameter choices. */
+enum class NoisePlacement
+{
+    preTape = 0,
+    postTape,
+    parallel, // Mixed in after the wet/dry stage by the processor, so no node in the chain.
+    count
+};
+
+template <typename Module>
+class ModuleNode
+{
+public:
+    explicit ModuleNode(Module& moduleToUse) noexcept : module(moduleToUse) {}
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        module.processBlock(buffer, numSamples);
+    }
+
+private:
+    Module& module;
+};
+
+template <typename NoiseSource>
+class NoiseInsertNode
+{
+public:
+    explicit NoiseInsertNode(const NoiseSource& sourceToUse) noexcept : source(sourceToUse) {}
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        const auto& noise = source.getNoiseBuffer();
+        const auto numChannels = juce::jmin(noise.getNumChannels(), buffer.getNumChannels());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.addFrom(channel, 0, noise, channel, 0, numSamples);
+    }
+
+private:
+    const NoiseSource& source;
+};
+
+/** A fixed sequence of nodes run in order; resolves to direct calls at compile time. */
+template <typename... Nodes>
+class ProcessingChain
+{
+public:
+    explicit ProcessingChain(Nodes... chainNodes) noexcept : nodes(chainNodes...) {}
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        std::apply([&buffer, numSamples](auto&... node) { (node.process(buffer, numSamples), ...); }, nodes);
+    }
+
+private:
+    std::tuple<Nodes...> nodes;
+};
+
+template <typename Tape, typename Dirt, typename Pump, typename Noise>
 class ProcessingGraph
 {
 public:
-    template <typename ModuleA, typename ModuleB, typename ModuleC>
-    void process(juce::AudioBuffer<float>& buffer,
-                 int numSamples,
-                 ModuleA& tape,
-                 ModuleB& dirt,
-                 ModuleC& pump)
+    ProcessingGraph(Tape& tape, Dirt& dirt, Pump& pump, const Noise& noise) noexcept
+        : chains(makeChains(T { tape }, D { dirt }, P { pump }, N { noise }))
+    {
+    }
+
+    template <typename SampleType>
+    void process(ModuleOrder order,
+                 NoisePlacement placement,
+                 juce::AudioBuffer<SampleType>& buffer,
+                 int numSamples) noexcept
     {
-        tape.processBlock(buffer, numSamples);
-        dirt.processBlock(buffer, numSamples);
-        pump.processBlock(buffer, numSamples);
+        const auto index = static_cast<size_t>(order) * static_cast<size_t>(NoisePlacement::count)
+                           + static_cast<size_t>(placement);
+        jassert(index < numChains);
+        dispatch(index, buffer, numSamples, std::make_index_sequence<numChains>());
     }
+
+private:
+    using T = ModuleNode<Tape>;
+    using D = ModuleNode<Dirt>;
+    using P = ModuleNode<Pump>;
+    using N = NoiseInsertNode<Noise>;
+
+    // Ordered by ModuleOrder, then NoisePlacement; noise always sits next to the tape node.
+    using Chains = std::tuple<ProcessingChain<N, T, D, P>,
+                              ProcessingChain<T, N, D, P>,
+                              ProcessingChain<T, D, P>,
+                              ProcessingChain<D, N, T, P>,
+                              ProcessingChain<D, T, N, P>,
+                              ProcessingChain<D, T, P>,
+                              ProcessingChain<P, N, T, D>,
+                              ProcessingChain<P, T, N, D>,
+                              ProcessingChain<P, T, D>>;
+
+    static constexpr size_t numChains = std::tuple_size_v<Chains>;
+    static_assert(numChains == static_cast<size_t>(ModuleOrder::count) * static_cast<size_t>(NoisePlacement::count));
+
+    static Chains makeChains(T t, D d, P p, N n) noexcept
+    {
+        return Chains { ProcessingChain<N, T, D, P> { n, t, d, p },
+                        ProcessingChain<T, N, D, P> { t, n, d, p },
+                        ProcessingChain<T, D, P> { t, d, p },
+                        ProcessingChain<D, N, T, P> { d, n, t, p },
+                        ProcessingChain<D, T, N, P> { d, t, n, p },
+                        ProcessingChain<D, T, P> { d, t, p },
+                        ProcessingChain<P, N, T, D> { p, n, t, d },
+                        ProcessingChain<P, T, N, D> { p, t, n, d },
+                        ProcessingChain<P, T, D> { p, t, d } };
+    }
+
+    template <typename SampleType, size_t... Indices>
+    void dispatch(size_t index, juce::AudioBuffer<SampleType>& buffer, int numSamples, std::index_sequence<Indices...>) noexcept
+    {
+        static_cast<void>(((index == Indices && (std::get<Indices>(chains).process(buffer, numSamples), true)) || ...));
+    }
+
+    Chains chains;
 };
 } // namespace dustbox::dsp
-
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+  File: RoutingGraph.cpp
+  Responsibility: Parse, print, and compile Dustbox routing descriptions.
+  Assumptions: Called on the message thread; allocation is fine here.
+  ==============================================================================
+*/
+
+#include "RoutingGraph.h"
+
+#include <array>
+
+namespace dustbox::dsp
+{
+namespace
+{
+constexpr std::array<const char*, 4> nodeNames { "tape", "dirt", "pump", "noise" };
+
+bool parseNode(const juce::String& token, RoutingNode& node)
+{
+    for (size_t index = 0; index < nodeNames.size(); ++index)
+    {
+        if (token == nodeNames[index])
+        {
+            node = static_cast<RoutingNode>(index);
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace
+
+bool RoutingGraph::parse(const juce::String& text, RoutingGraph& result)
+{
+    const auto trimmed = text.trim().toLowerCase();
+    if (trimmed.isEmpty() || trimmed == "default")
+    {
+        result.stages.clear();
+        return true;
+    }
+
+    std::vector<Stage> parsed;
+    std::array<bool, nodeNames.size()> used {};
+
+    for (const auto& stageText : juce::StringArray::fromTokens(trimmed, ">", {}))
+    {
+        Stage stage;
+        for (const auto& branchText : juce::StringArray::fromTokens(stageText, "|", {}))
+        {
+            RoutingNode node;
+            if (! parseNode(branchText.trim(), node))
+                return false;
+
+            auto& seen = used[static_cast<size_t>(node)];
+            if (seen)
+                return false;
+
+            seen = true;
+            stage.push_back(node);
+        }
+
+        if (stage.empty())
+            return false;
+
+        parsed.push_back(std::move(stage));
+    }
+
+    result.stages = std::move(parsed);
+    return true;
+}
+
+juce::String RoutingGraph::toString() const
+{
+    if (followsParameters())
+        return "default";
+
+    juce::StringArray stageTexts;
+    for (const auto& stage : stages)
+    {
+        juce::StringArray branchTexts;
+        for (const auto node : stage)
+            branchTexts.add(nodeNames[static_cast<size_t>(node)]);
+
+        stageTexts.add(branchTexts.joinIntoString(" | "));
+    }
+
+    return stageTexts.joinIntoString(" > ");
+}
+
+template <typename SampleType>
+std::unique_ptr<RoutingPlan> RoutingGraph::compile(int numLanes, int channelsPerLane, int maxBlockSize) const
+{
+    auto plan = std::make_unique<RoutingPlan>();
+    plan->parameterDriven = followsParameters();
+
+    bool needsScratch = false;
+    for (const auto& stage : stages)
+    {
+        if (stage.size() == 1)
+        {
+            plan->steps.push_back({ RoutingPlan::Operation::processNode, stage.front() });
+        }
+        else
+        {
+            // The first branch runs in place on the main buffer; the rest start from a copy
+            // of the stage input and are summed back in.
+            needsScratch = true;
+            plan->steps.push_back({ RoutingPlan::Operation::saveStageInput });
+            plan->steps.push_back({ RoutingPlan::Operation::processNode, stage.front() });
+
+            for (size_t branch = 1; branch < stage.size(); ++branch)
+            {
+                plan->steps.push_back({ RoutingPlan::Operation::loadStageInput });
+                plan->steps.push_back({ RoutingPlan::Operation::processNode, stage[branch] });
+                plan->steps.push_back({ RoutingPlan::Operation::accumulate });
+            }
+
+            plan->steps.push_back({ RoutingPlan::Operation::scale, RoutingNode::tape, 1.0f / static_cast<float>(stage.size()) });
+        }
+
+        for (const auto node : stage)
+        {
+            plan->hasNoiseNode = plan->hasNoiseNode || node == RoutingNode::noise;
+            plan->hasDirtNode = plan->hasDirtNode || node == RoutingNode::dirt;
+        }
+    }
+
+    auto& scratch = plan->getScratch<SampleType>();
+    scratch.resize(static_cast<size_t>(juce::jmax(1, numLanes)));
+    plan->scratchChannels = channelsPerLane;
+    plan->scratchSamples = maxBlockSize;
+    if (needsScratch)
+    {
+        for (auto& lane : scratch)
+        {
+            lane.stageInput.setSize(channelsPerLane, maxBlockSize);
+            lane.branch.setSize(channelsPerLane, maxBlockSize);
+            lane.stageInput.clear();
+            lane.branch.clear();
+        }
+    }
+
+    return plan;
+}
+
+template std::unique_ptr<RoutingPlan> RoutingGraph::compile<float>(int, int, int) const;
+template std::unique_ptr<RoutingPlan> RoutingGraph::compile<double>(int, int, int) const;
+} // namespace dustbox::dsp
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+  File: RoutingGraph.h
+  Responsibility: Describe user-defined module routings and compile them into
+                  flat, preallocated execution plans for the audio thread.
+  Assumptions: Descriptions are parsed and compiled on the message thread; a
+               compiled plan is then owned by one audio thread, which may run
+               its lanes concurrently on worker threads.
+  Notes: Text form is stages separated by '>' whose parallel branches are
+         separated by '|', e.g. "noise > tape | dirt > pump". Parallel branches
+         all start from the stage input and are averaged. The empty/"default"
+         routing follows the chainOrder and noiseRouting parameters through the
+         compile-time ProcessingGraph instead of a step list.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace dustbox::dsp
+{
+enum class RoutingNode
+{
+    tape,
+    dirt,
+    pump,
+    noise
+};
+
+class RoutingPlan;
+
+class RoutingGraph
+{
+public:
+    using Stage = std::vector<RoutingNode>;
+
+    /** Parses the text form; each node may appear at most once. Returns false and leaves
+        the result untouched on a syntax error. */
+    static bool parse(const juce::String& text, RoutingGraph& result);
+
+    bool followsParameters() const noexcept { return stages.empty(); }
+    const std::vector<Stage>& getStages() const noexcept { return stages; }
+    juce::String toString() const;
+
+    /** Builds a plan with SampleType scratch buffers for each channel lane, so lanes can run it
+        in parallel. Instantiated for float and double. */
+    template <typename SampleType>
+    std::unique_ptr<RoutingPlan> compile(int numLanes, int channelsPerLane, int maxBlockSize) const;
+
+private:
+    std::vector<Stage> stages;
+};
+
+class RoutingPlan
+{
+public:
+    enum class Operation
+    {
+        processNode,     // Run the node on the current target buffer.
+        saveStageInput,  // Copy the main buffer into the stage input.
+        loadStageInput,  // Copy the stage input into the branch buffer and target it.
+        accumulate,      // Add the branch buffer into the main buffer and target main again.
+        scale            // Multiply the main buffer by gain.
+    };
+
+    struct Step
+    {
+        Operation operation { Operation::processNode };
+        RoutingNode node { RoutingNode::tape };
+        float gain { 1.0f };
+    };
+
+    bool followsParameters() const noexcept { return parameterDriven; }
+    bool placesNoise() const noexcept { return hasNoiseNode; }
+    /** Parameter-driven plans always run Dirt; custom routings may leave it out. */
+    bool runsDirt() const noexcept { return parameterDriven || hasDirtNode; }
+    const std::vector<Step>& getSteps() const noexcept { return steps; }
+
+    /** True when the plan's SampleType scratch already covers this layout, so a re-prepare
+        within it can keep the plan instead of compiling (and allocating) a new one. */
+    template <typename SampleType>
+    bool covers(int numLanes, int channelsPerLane, int blockSize) const noexcept
+    {
+        return numLanes <= static_cast<int>(getScratch<SampleType>().size())
+               && channelsPerLane <= scratchChannels && blockSize <= scratchSamples;
+    }
+
+    /** Runs the steps on one lane's buffer with that lane's modules and scratch buffers. */
+    template <typename Tape, typename Dirt, typename Pump, typename Noise, typename SampleType>
+    void process(int lane,
+                 Tape& tape,
+                 Dirt& dirt,
+                 Pump& pump,
+                 const Noise& noise,
+                 juce::AudioBuffer<SampleType>& buffer,
+                 int numSamples) noexcept
+    {
+        auto& scratch = getScratch<SampleType>();
+        jassert(juce::isPositiveAndBelow(lane, static_cast<int>(scratch.size())));
+        auto& [stageInput, branch] = scratch[static_cast<size_t>(lane)];
+        auto* target = &buffer;
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), stageInput.getNumChannels());
+
+        for (const auto& step : steps)
+        {
+            switch (step.operation)
+            {
+                case Operation::processNode:
+                    switch (step.node)
+                    {
+                        case RoutingNode::tape: tape.processBlock(*target, numSamples); break;
+                        case RoutingNode::dirt: dirt.processBlock(*target, numSamples); break;
+                        case RoutingNode::pump: pump.processBlock(*target, numSamples); break;
+                        case RoutingNode::noise: addNoise(noise.getNoiseBuffer(), *target, numSamples); break;
+                    }
+                    break;
+
+                case Operation::saveStageInput:
+                    jassert(numSamples <= stageInput.getNumSamples());
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        stageInput.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+                    break;
+
+                case Operation::loadStageInput:
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        branch.copyFrom(channel, 0, stageInput, channel, 0, numSamples);
+                    target = &branch;
+                    break;
+
+                case Operation::accumulate:
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        buffer.addFrom(channel, 0, branch, channel, 0, numSamples);
+                    target = &buffer;
+                    break;
+
+                case Operation::scale:
+                    buffer.applyGain(0, numSamples, step.gain);
+                    break;
+            }
+        }
+    }
+
+private:
+    friend class RoutingGraph;
+
+    template <typename SampleType>
+    struct LaneScratch
+    {
+        juce::AudioBuffer<SampleType> stageInput;
+        juce::AudioBuffer<SampleType> branch;
+    };
+
+    template <typename SampleType>
+    std::vector<LaneScratch<SampleType>>& getScratch() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleScratch;
+        else
+            return floatScratch;
+    }
+
+    template <typename SampleType>
+    const std::vector<LaneScratch<SampleType>>& getScratch() const noexcept
+    {
+        return const_cast<RoutingPlan*>(this)->getScratch<SampleType>();
+    }
+
+    template <typename SampleType>
+    static void addNoise(const juce::AudioBuffer<SampleType>& noise, juce::AudioBuffer<SampleType>& target, int numSamples) noexcept
+    {
+        const auto numChannels = juce::jmin(noise.getNumChannels(), target.getNumChannels());
+        for (int channel = 0; channel < numChannels; ++channel)
+            target.addFrom(channel, 0, noise, channel, 0, numSamples);
+    }
+
+    // Only the precision the plan was compiled for is populated.
+    std::vector<Step> steps;
+    std::vector<LaneScratch<float>> floatScratch;
+    std::vector<LaneScratch<double>> doubleScratch;
+    int scratchChannels { 0 };
+    int scratchSamples { 0 };
+    bool parameterDriven { true };
+    bool hasNoiseNode { false };
+    bool hasDirtNode { false };
+};
+} // namespace dustbox::dsp
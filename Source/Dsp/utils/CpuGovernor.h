@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+  File: CpuGovernor.h
+  Responsibility: Decide how many quality steps to shed from the time each
+                  block took against its realtime deadline.
+  Assumptions: Audio thread only; the caller measures the block and knows how
+               many steps would actually save work.
+  Notes: Load is the block's processing time over its duration, smoothed over
+         ~100 ms. A step down needs the load above the budget for a sustained
+         stretch; a step up needs it below a fraction of the budget for much
+         longer. A step down soon after a step up doubles the wait before the
+         next attempt, so a session that sits right at the edge settles
+         instead of toggling every few seconds.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cmath>
+
+namespace dustbox::dsp
+{
+class CpuGovernor
+{
+public:
+    static constexpr double smoothingSeconds = 0.1;
+    static constexpr double stepDownSeconds = 0.25;
+    static constexpr double stepUpSeconds = 3.0;
+    static constexpr double maxStepUpSeconds = 48.0;
+    static constexpr double headroomRatio = 0.6;
+
+    void reset() noexcept
+    {
+        load = 0.0;
+        reduction = 0;
+        overBudgetSeconds = 0.0;
+        underBudgetSeconds = 0.0;
+        sinceStepUpSeconds = 0.0;
+        stepUpHoldSeconds = stepUpSeconds;
+        onProbation = false;
+    }
+
+    /** Fraction of the realtime deadline this instance may use; zero turns the governor off,
+        which hands every shed step back at once. */
+    void setBudget(double newBudget) noexcept
+    {
+        if (juce::approximatelyEqual(newBudget, budget))
+            return;
+
+        budget = newBudget;
+        overBudgetSeconds = 0.0;
+        underBudgetSeconds = 0.0;
+        stepUpHoldSeconds = stepUpSeconds;
+        onProbation = false;
+
+        if (budget <= 0.0)
+            reduction = 0;
+    }
+
+    double getBudget() const noexcept { return budget; }
+
+    /** Feeds one block that took elapsedSeconds to process and lasts blockSeconds of audio.
+        maxReduction is how many steps are currently worth shedding. */
+    void addBlock(double elapsedSeconds, double blockSeconds, int maxReduction) noexcept
+    {
+        if (blockSeconds <= 0.0)
+            return;
+
+        const auto alpha = 1.0 - std::exp(-blockSeconds / smoothingSeconds);
+        load += alpha * (elapsedSeconds / blockSeconds - load);
+        sinceStepUpSeconds += blockSeconds;
+        reduction = juce::jmin(reduction, juce::jmax(0, maxReduction));
+
+        if (budget <= 0.0)
+            return;
+
+        // A step up that held long enough proves the headroom; the next one waits the base time again.
+        if (onProbation && sinceStepUpSeconds >= stepUpHoldSeconds)
+        {
+            onProbation = false;
+            stepUpHoldSeconds = stepUpSeconds;
+        }
+
+        if (load > budget)
+        {
+            underBudgetSeconds = 0.0;
+            overBudgetSeconds += blockSeconds;
+
+            if (overBudgetSeconds >= stepDownSeconds && reduction < maxReduction)
+            {
+                ++reduction;
+                overBudgetSeconds = 0.0;
+
+                if (onProbation)
+                {
+                    stepUpHoldSeconds = juce::jmin(2.0 * stepUpHoldSeconds, maxStepUpSeconds);
+                    onProbation = false;
+                }
+            }
+        }
+        else if (load < budget * headroomRatio)
+        {
+            overBudgetSeconds = 0.0;
+            underBudgetSeconds += blockSeconds;
+
+            if (underBudgetSeconds >= stepUpHoldSeconds && reduction > 0)
+            {
+                --reduction;
+                underBudgetSeconds = 0.0;
+                sinceStepUpSeconds = 0.0;
+                onProbation = true;
+            }
+        }
+        else
+        {
+            overBudgetSeconds = 0.0;
+            underBudgetSeconds = 0.0;
+        }
+    }
+
+    /** Smoothed processing time over block duration; 1 means the whole deadline. */
+    double getLoad() const noexcept { return load; }
+    /** Quality steps currently shed; 0 runs the user's settings. */
+    int getReduction() const noexcept { return reduction; }
+
+private:
+    double budget { 0.0 };
+    double load { 0.0 };
+    int reduction { 0 };
+    double overBudgetSeconds { 0.0 };
+    double underBudgetSeconds { 0.0 };
+    double sinceStepUpSeconds { 0.0 };
+    double stepUpHoldSeconds { stepUpSeconds };
+    bool onProbation { false };
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+  File: DspArena.h
+  Responsibility: Provide one cache-line aligned block per processor instance
+                  from which modules carve their buffers and per-channel state.
+  Assumptions: reserve() and the allocate calls run on the message thread
+               (prepareToPlay); the audio thread only uses carved memory.
+  Notes: A bump allocator with every allocation rounded up to a cache line, so
+         two modules' hot state never shares a line and each instance's state
+         is one contiguous range. Callers size the block up front with
+         bytesFor()/bytesForBuffer(), the same way they will carve it.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace dustbox::dsp
+{
+class DspArena
+{
+public:
+    static constexpr size_t cacheLineBytes = 64;
+    static constexpr int maxBufferChannels = 32;
+
+    static constexpr size_t roundUp(size_t bytes) noexcept
+    {
+        return (bytes + cacheLineBytes - 1) & ~(cacheLineBytes - 1);
+    }
+
+    template <typename T>
+    static constexpr size_t bytesFor(size_t count) noexcept
+    {
+        return roundUp(sizeof(T) * count);
+    }
+
+    /** Each channel starts on its own cache line. */
+    template <typename SampleType>
+    static constexpr size_t bytesForBuffer(int numChannels, int numSamples) noexcept
+    {
+        return static_cast<size_t>(numChannels) * bytesFor<SampleType>(static_cast<size_t>(numSamples));
+    }
+
+    /** Makes sure at least totalBytes are available and rewinds. Existing storage is reused when it
+        is large enough, so re-carving within a reservation never allocates; otherwise it is
+        replaced, invalidating everything carved from it. */
+    void reserve(size_t totalBytes)
+    {
+        if (totalBytes > capacity)
+        {
+            storage.reset(new std::byte[totalBytes + cacheLineBytes - 1]);
+            const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+            base = storage.get() + (roundUp(address) - address);
+            capacity = totalBytes;
+        }
+
+        rewind();
+    }
+
+    void release() noexcept
+    {
+        storage.reset();
+        base = nullptr;
+        capacity = 0;
+        used = 0;
+    }
+
+    /** Starts carving from the beginning again; earlier carvings must no longer be used. */
+    void rewind() noexcept { used = 0; }
+
+    /** Carves count zero-initialised Ts. Only trivial types, since no constructors or destructors run.
+        Only the carved range is zeroed, so a large reservation costs nothing on re-carve. */
+    template <typename T>
+    T* allocate(size_t count) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+        static_assert(alignof(T) <= cacheLineBytes);
+
+        const auto bytes = bytesFor<T>(count);
+        jassert(used + bytes <= capacity); // The caller under-reserved.
+        if (used + bytes > capacity)
+            return nullptr;
+
+        std::memset(base + used, 0, bytes);
+        auto* result = reinterpret_cast<T*>(base + used);
+        used += bytes;
+        return result;
+    }
+
+    /** Points buffer at freshly carved, zeroed channels; the buffer owns no memory afterwards. */
+    template <typename SampleType>
+    void allocateBuffer(juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples) noexcept
+    {
+        jassert(numChannels <= maxBufferChannels);
+        std::array<SampleType*, maxBufferChannels> channels {};
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            channels[static_cast<size_t>(channel)] = allocate<SampleType>(static_cast<size_t>(numSamples));
+
+        buffer.setDataToReferTo(channels.data(), numChannels, numSamples);
+    }
+
+    size_t getCapacity() const noexcept { return capacity; }
+    size_t getUsedBytes() const noexcept { return used; }
+
+private:
+    std::unique_ptr<std::byte[]> storage;
+    std::byte* base { nullptr };
+    size_t capacity { 0 };
+    size_t used { 0 };
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,338 @@
+/*
+  ==============================================================================
+  File: FractionalResampler.h
+  Responsibility: Reduce a host-rate signal to an arbitrary lower target rate
+                  and bring it back, in place, so lo-fi rate reduction sounds
+                  the same at any host rate.
+  Assumptions: prepare() runs on the message thread with the host rate;
+               setTarget()/process() run on the audio thread, one call per
+               channel per block.
+  Notes: Both directions evaluate a windowed-sinc kernel at fractional
+         positions from a shared table (a polyphase filter with table
+         interpolation between phases), so any pair of rates works without
+         precomputing per-ratio filters. The decimating kernel is stretched to
+         the target rate's Nyquist and only evaluated once per target-rate
+         sample. Quality tiers:
+           fast     - fractional sample-and-hold, no filtering or latency; the
+                      cost of the integer divider it replaces.
+           balanced - 8-zero-crossing anti-alias filter, linear reconstruction.
+           high     - 16-zero-crossing filters in both directions.
+         Filtered tiers are linear phase and report their delay, rounded.
+         The kernel tables are function-local statics; prepare() builds them
+         and keeps pointers, so process() never runs their initialisers.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "DspArena.h"
+
+#include <array>
+#include <cmath>
+
+namespace dustbox::dsp
+{
+enum class ResamplerQuality
+{
+    fast,
+    balanced,
+    high
+};
+
+namespace resampling
+{
+inline constexpr double minTargetRate = 4000.0;
+inline constexpr int tableResolution = 512; // Kernel points per target-rate sample.
+inline constexpr double cutoff = 0.9;        // Of the target Nyquist, leaving room for the transition band.
+inline constexpr int maxHalfWidth = 8;
+inline constexpr int lowRingSize = 32; // Power of two above the widest reconstruction kernel.
+
+/** Half-width in target-rate samples of the anti-alias and reconstruction kernels. */
+inline constexpr int getDecimationHalfWidth(ResamplerQuality quality) noexcept
+{
+    return quality == ResamplerQuality::high ? 8 : (quality == ResamplerQuality::balanced ? 4 : 0);
+}
+
+inline constexpr int getReconstructionHalfWidth(ResamplerQuality quality) noexcept
+{
+    return quality == ResamplerQuality::high ? 8 : (quality == ResamplerQuality::balanced ? 1 : 0);
+}
+
+/** Blackman-windowed sinc, one side, sampled tableResolution times per target-rate sample. */
+template <int halfWidth>
+const std::array<float, halfWidth * tableResolution + 2>& getSincTable()
+{
+    static const auto table = []
+    {
+        std::array<float, halfWidth * tableResolution + 2> values {};
+        for (size_t index = 0; index + 1 < values.size(); ++index)
+        {
+            const auto x = static_cast<double>(index) / tableResolution;
+            const auto phase = juce::MathConstants<double>::pi * cutoff * x;
+            const auto sinc = index == 0 ? 1.0 : std::sin(phase) / phase;
+            const auto w = juce::MathConstants<double>::pi * x / halfWidth;
+            const auto window = 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+            values[index] = static_cast<float>(cutoff * sinc * window);
+        }
+
+        return values;
+    }();
+
+    return table;
+}
+
+/** Triangle kernel for linear reconstruction, in the same table form. */
+inline const std::array<float, tableResolution + 2>& getLinearTable()
+{
+    static const auto table = []
+    {
+        std::array<float, tableResolution + 2> values {};
+        for (size_t index = 0; index + 1 < values.size(); ++index)
+            values[index] = 1.0f - static_cast<float>(index) / tableResolution;
+
+        return values;
+    }();
+
+    return table;
+}
+
+/** Kernel value at position (table points, either sign). Callers keep |position| inside the table. */
+inline float evaluateTable(const float* table, float position) noexcept
+{
+    const auto distance = std::abs(position);
+    const auto index = static_cast<int>(distance);
+    const auto fraction = distance - static_cast<float>(index);
+    return table[index] + fraction * (table[index + 1] - table[index]);
+}
+
+/** Whole host samples the decimation side waits for, so its kernel never reads the future. */
+inline int getDecimationDelay(double hostRate, double targetRate, ResamplerQuality quality) noexcept
+{
+    return static_cast<int>(std::ceil(getDecimationHalfWidth(quality) * hostRate / targetRate));
+}
+
+inline int getLatencySamples(double hostRate, double targetRate, ResamplerQuality quality) noexcept
+{
+    if (targetRate <= 0.0 || targetRate >= hostRate)
+        return 0;
+
+    return getDecimationDelay(hostRate, targetRate, quality)
+           + juce::roundToInt(getReconstructionHalfWidth(quality) * hostRate / targetRate);
+}
+
+/** Host samples of input history the widest setting needs at this host rate. */
+inline int getInputRingSize(double hostRate) noexcept
+{
+    const auto span = 2 * static_cast<int>(std::ceil(maxHalfWidth * hostRate / minTargetRate)) + 4;
+    return juce::nextPowerOfTwo(span);
+}
+} // namespace resampling
+
+template <typename SampleType>
+class FractionalResampler
+{
+public:
+    static size_t getArenaBytes(double hostRate, int numChannels) noexcept
+    {
+        const auto channels = static_cast<size_t>(numChannels);
+        return channels * DspArena::bytesFor<SampleType>(2 * static_cast<size_t>(resampling::getInputRingSize(hostRate)))
+               + channels * DspArena::bytesFor<SampleType>(2 * resampling::lowRingSize)
+               + DspArena::bytesFor<ChannelState>(channels);
+    }
+
+    void prepare(double sampleRate, int numChannels, DspArena& arena)
+    {
+        jassert(numChannels <= DspArena::maxBufferChannels);
+        hostRate = sampleRate;
+        numChannelsPrepared = numChannels;
+        inputRingSize = resampling::getInputRingSize(sampleRate);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            inputRings[static_cast<size_t>(channel)] = arena.allocate<SampleType>(2 * static_cast<size_t>(inputRingSize));
+            lowRings[static_cast<size_t>(channel)] = arena.allocate<SampleType>(2 * resampling::lowRingSize);
+        }
+
+        channelStates = arena.allocate<ChannelState>(static_cast<size_t>(numChannels));
+
+        // Builds the tables here on first use, not on the audio thread.
+        balancedDecimationTable = resampling::getSincTable<4>().data();
+        linearTable = resampling::getLinearTable().data();
+        highTable = resampling::getSincTable<8>().data();
+
+        // The next setTarget() configures for the new host rate.
+        targetRate = 0.0;
+        active = false;
+    }
+
+    void reset() noexcept
+    {
+        for (int channel = 0; channel < numChannelsPrepared; ++channel)
+        {
+            std::fill_n(inputRings[static_cast<size_t>(channel)], 2 * inputRingSize, SampleType {});
+            std::fill_n(lowRings[static_cast<size_t>(channel)], 2 * resampling::lowRingSize, SampleType {});
+
+            // Start as if zeros had been streaming: the first target-rate sample is due at once and
+            // the reconstruction point sits its half-width behind the newest one.
+            auto& state = channelStates[channel];
+            state = {};
+            state.nextLowTime = 1.0;
+            state.reconstructionTime = 1.0 - reconstructionHalfWidth - ratio;
+        }
+    }
+
+    /** A target at or above the host rate disables the stage. Changes restart from silence. */
+    void setTarget(double newTargetRate, ResamplerQuality newQuality) noexcept
+    {
+        if (juce::approximatelyEqual(newTargetRate, targetRate) && newQuality == quality)
+            return;
+
+        targetRate = newTargetRate;
+        quality = newQuality;
+        active = targetRate >= resampling::minTargetRate && targetRate < hostRate;
+        if (! active)
+            return;
+
+        ratio = targetRate / hostRate;
+        step = hostRate / targetRate;
+        decimationHalfWidth = resampling::getDecimationHalfWidth(quality);
+        reconstructionHalfWidth = resampling::getReconstructionHalfWidth(quality);
+        decimationDelay = resampling::getDecimationDelay(hostRate, targetRate, quality);
+        reset();
+    }
+
+    bool isActive() const noexcept { return active; }
+
+    void process(int channel, SampleType* data, int numSamples) noexcept
+    {
+        if (! active)
+            return;
+
+        jassert(juce::isPositiveAndBelow(channel, numChannelsPrepared));
+
+        switch (quality)
+        {
+            case ResamplerQuality::fast: processFast(channel, data, numSamples); break;
+            case ResamplerQuality::balanced:
+                processFiltered(channel, data, numSamples, balancedDecimationTable, linearTable);
+                break;
+            case ResamplerQuality::high:
+                processFiltered(channel, data, numSamples, highTable, highTable);
+                break;
+        }
+    }
+
+private:
+    struct ChannelState
+    {
+        double nextLowTime { 0.0 };        // Host samples until the next target-rate sample is due.
+        double reconstructionTime { 0.0 }; // Output position in target-rate samples, relative to the newest one.
+        int inputWrite { 0 };
+        int lowWrite { 0 };
+        double held { 0.0 };
+    };
+
+    void processFast(int channel, SampleType* data, int numSamples) noexcept
+    {
+        auto& state = channelStates[channel];
+        auto nextLowTime = state.nextLowTime;
+        auto held = static_cast<SampleType>(state.held);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            nextLowTime -= 1.0;
+            if (nextLowTime <= 0.0)
+            {
+                held = data[sample];
+                nextLowTime += step;
+            }
+
+            data[sample] = held;
+        }
+
+        state.nextLowTime = nextLowTime;
+        state.held = static_cast<double>(held);
+    }
+
+    /** Both rings are written twice, size apart, so every kernel reads one contiguous span ending
+        at the newest sample without wrapping. */
+    void processFiltered(int channel,
+                         SampleType* data,
+                         int numSamples,
+                         const float* decimationKernel,
+                         const float* reconstructionKernel) noexcept
+    {
+        auto& state = channelStates[channel];
+        auto* inputRing = inputRings[static_cast<size_t>(channel)];
+        auto* lowRing = lowRings[static_cast<size_t>(channel)];
+        const auto inputMask = inputRingSize - 1;
+        constexpr auto lowMask = resampling::lowRingSize - 1;
+        const auto decimationReach = decimationHalfWidth * step;
+
+        // Kernel positions are in table points; one host sample moves the decimation kernel by tapStep.
+        constexpr auto resolution = static_cast<float>(resampling::tableResolution);
+        const auto tapStep = static_cast<float>(ratio) * resolution;
+        const auto gain = static_cast<SampleType>(ratio);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            state.inputWrite = (state.inputWrite + 1) & inputMask;
+            inputRing[state.inputWrite] = data[sample];
+            inputRing[state.inputWrite + inputRingSize] = data[sample];
+            state.nextLowTime -= 1.0;
+            state.reconstructionTime += ratio;
+
+            while (state.nextLowTime <= 0.0)
+            {
+                // Kernel centre in host samples relative to the newest input; all taps are in the past.
+                const auto centre = state.nextLowTime - decimationDelay;
+                const auto first = static_cast<int>(std::floor(centre - decimationReach)) + 1;
+                const auto last = juce::jmin(0, static_cast<int>(std::floor(centre + decimationReach)));
+                const auto* taps = inputRing + state.inputWrite + inputRingSize + first;
+                auto position = static_cast<float>((first - centre) * ratio) * resolution;
+
+                SampleType sum {};
+                for (int tap = 0; tap <= last - first; ++tap, position += tapStep)
+                    sum += static_cast<SampleType>(resampling::evaluateTable(decimationKernel, position)) * taps[tap];
+
+                state.lowWrite = (state.lowWrite + 1) & lowMask;
+                lowRing[state.lowWrite] = sum * gain;
+                lowRing[state.lowWrite + resampling::lowRingSize] = sum * gain;
+                state.nextLowTime += step;
+                state.reconstructionTime -= 1.0;
+            }
+
+            // Taps within the reconstruction half-width behind the output position, newest last.
+            const auto oldest = static_cast<int>(std::ceil(state.reconstructionTime - reconstructionHalfWidth));
+            const auto* taps = lowRing + state.lowWrite + resampling::lowRingSize + oldest;
+            auto position = static_cast<float>(oldest - state.reconstructionTime) * resolution;
+
+            SampleType output {};
+            for (int tap = 0; tap <= -oldest; ++tap, position += resolution)
+                output += static_cast<SampleType>(resampling::evaluateTable(reconstructionKernel, position)) * taps[tap];
+
+            data[sample] = output;
+        }
+    }
+
+    std::array<SampleType*, DspArena::maxBufferChannels> inputRings {};
+    std::array<SampleType*, DspArena::maxBufferChannels> lowRings {};
+    ChannelState* channelStates { nullptr };
+    const float* balancedDecimationTable { nullptr };
+    const float* linearTable { nullptr };
+    const float* highTable { nullptr };
+    double hostRate { 44100.0 };
+    double targetRate { 0.0 };
+    double ratio { 1.0 };
+    double step { 1.0 };
+    ResamplerQuality quality { ResamplerQuality::fast };
+    int decimationHalfWidth { 0 };
+    int reconstructionHalfWidth { 0 };
+    int decimationDelay { 0 };
+    int inputRingSize { 0 };
+    int numChannelsPrepared { 0 };
+    bool active { false };
+};
+} // namespace dustbox::dsp
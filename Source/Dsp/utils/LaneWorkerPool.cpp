@@ -0,0 +1,310 @@
+/*
+  ==============================================================================
+  File: LaneWorkerPool.cpp
+  Responsibility: Implement the worker threads and per-block barrier used to
+                  process channel lanes in parallel.
+  Assumptions: Workers only touch the task fields after observing a new
+               generation, and the caller only rewrites them once every
+               worker has reported back for the previous one.
+  Notes: Parking uses the platform semaphore whose post is an atomic plus, at
+         most, a kernel wake (futex-backed sem_post on Linux, Mach semaphores
+         on Apple, Win32 semaphores on Windows), so the audio thread never
+         takes a user-space mutex. A stale post only costs a worker one extra
+         look at the generation.
+  ==============================================================================
+*/
+
+#include "LaneWorkerPool.h"
+
+#include "DenormalGuard.h"
+
+#include "../../Core/RealtimeSafety.h"
+
+#include <thread>
+
+#if JUCE_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+
+    #include <climits>
+#elif JUCE_MAC || JUCE_IOS
+    #include <mach/mach.h>
+#else
+    #include <cerrno>
+    #include <ctime>
+    #include <semaphore.h>
+#endif
+
+namespace dustbox::dsp
+{
+namespace
+{
+constexpr int parkTimeoutMs = 100;
+constexpr double spinSeconds = 5.0e-6;
+
+std::atomic<int> workersInProcess { 0 };
+
+/** Takes up to wanted workers from the process-wide budget and returns how many it got. */
+int acquireWorkers(int wanted) noexcept
+{
+    const auto limit = LaneWorkerPool::getMaxWorkersInProcess();
+    auto inUse = workersInProcess.load(std::memory_order_relaxed);
+    int granted = 0;
+
+    do
+    {
+        granted = juce::jlimit(0, wanted, limit - inUse);
+    } while (granted > 0 && ! workersInProcess.compare_exchange_weak(inUse, inUse + granted, std::memory_order_relaxed));
+
+    return granted;
+}
+
+void releaseWorkers(int count) noexcept
+{
+    workersInProcess.fetch_sub(count, std::memory_order_relaxed);
+}
+
+class WakeSemaphore
+{
+public:
+    WakeSemaphore()
+    {
+       #if JUCE_WINDOWS
+        handle = CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr);
+       #elif JUCE_MAC || JUCE_IOS
+        semaphore_create(mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0);
+       #else
+        sem_init(&semaphore, 0, 0);
+       #endif
+    }
+
+    ~WakeSemaphore()
+    {
+       #if JUCE_WINDOWS
+        CloseHandle(handle);
+       #elif JUCE_MAC || JUCE_IOS
+        semaphore_destroy(mach_task_self(), semaphore);
+       #else
+        sem_destroy(&semaphore);
+       #endif
+    }
+
+    void post() noexcept
+    {
+       #if JUCE_WINDOWS
+        ReleaseSemaphore(handle, 1, nullptr);
+       #elif JUCE_MAC || JUCE_IOS
+        semaphore_signal(semaphore);
+       #else
+        sem_post(&semaphore);
+       #endif
+    }
+
+    /** Returns after a post or the timeout; spurious returns are fine, callers re-check. */
+    void wait(int timeoutMs) noexcept
+    {
+       #if JUCE_WINDOWS
+        WaitForSingleObject(handle, static_cast<DWORD>(timeoutMs));
+       #elif JUCE_MAC || JUCE_IOS
+        semaphore_timedwait(semaphore, mach_timespec_t { 0, timeoutMs * 1000000 });
+       #else
+        timespec deadline {};
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += static_cast<long>(timeoutMs) * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        while (sem_timedwait(&semaphore, &deadline) != 0 && errno == EINTR)
+        {
+        }
+       #endif
+    }
+
+private:
+   #if JUCE_WINDOWS
+    HANDLE handle { nullptr };
+   #elif JUCE_MAC || JUCE_IOS
+    semaphore_t semaphore {};
+   #else
+    sem_t semaphore {};
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(WakeSemaphore)
+};
+} // namespace
+
+class LaneWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(LaneWorkerPool& ownerPool, int participantIndex)
+        : juce::Thread("Dustbox lane worker " + juce::String(participantIndex)),
+          owner(ownerPool),
+          participant(participantIndex),
+          seenGeneration(ownerPool.generation.load(std::memory_order_acquire))
+    {
+    }
+
+    ~Worker() override { stop(); }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wakeSemaphore.post();
+        stopThread(1000);
+    }
+
+    /** Called by the audio thread after a generation bump. */
+    void wakeIfParked() noexcept
+    {
+        if (parked.load(std::memory_order_seq_cst))
+            wakeSemaphore.post();
+    }
+
+    void run() override
+    {
+        // Denormal flushing is per thread, so workers set it once for their lifetime.
+        DenormalGuard guard;
+
+        while (! threadShouldExit())
+        {
+            const auto next = waitForGeneration(seenGeneration);
+            if (next == seenGeneration)
+                continue;
+
+            seenGeneration = next;
+            owner.runShare(participant);
+            owner.pendingWorkers.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+private:
+    uint32_t waitForGeneration(uint32_t seen)
+    {
+        // Lanes of one block are dispatched together, so a short spin only catches a block that
+        // is already on its way; between blocks the worker sleeps.
+        const auto spinUntil = juce::Time::getHighResolutionTicks() + spinTicks;
+
+        do
+        {
+            const auto current = owner.generation.load(std::memory_order_acquire);
+            if (current != seen)
+                return current;
+        } while (juce::Time::getHighResolutionTicks() < spinUntil);
+
+        // Park. The flag and generation are both seq_cst, so either the re-check below sees the
+        // new generation or the caller sees the flag and posts.
+        parked.store(true, std::memory_order_seq_cst);
+        auto current = owner.generation.load(std::memory_order_seq_cst);
+        if (current == seen && ! threadShouldExit())
+        {
+            wakeSemaphore.wait(parkTimeoutMs);
+            current = owner.generation.load(std::memory_order_acquire);
+        }
+
+        parked.store(false, std::memory_order_relaxed);
+        return current;
+    }
+
+    LaneWorkerPool& owner;
+    const int participant;
+    const int64_t spinTicks { juce::Time::secondsToHighResolutionTicks(spinSeconds) };
+
+    // Taken at construction, before the thread starts, so a block dispatched before run() first
+    // executes is still picked up.
+    uint32_t seenGeneration;
+    std::atomic<bool> parked { false };
+    WakeSemaphore wakeSemaphore;
+};
+
+LaneWorkerPool::LaneWorkerPool() = default;
+
+LaneWorkerPool::~LaneWorkerPool()
+{
+    stop();
+}
+
+int LaneWorkerPool::getNumWorkersInProcess() noexcept
+{
+    return workersInProcess.load(std::memory_order_relaxed);
+}
+
+int LaneWorkerPool::getMaxWorkersInProcess() noexcept
+{
+    // The host's own audio threads need cores too; leave one.
+    return juce::jmax(0, juce::SystemStats::getNumCpus() - 1);
+}
+
+void LaneWorkerPool::start(int numWorkers, double sampleRate, int blockSize)
+{
+    jassert(sampleRate > 0.0 && blockSize > 0);
+
+    // A pool that got fewer workers than it asked for tries again, in case others have stopped.
+    if (numWorkers == requestedWorkers && numWorkers == getNumWorkers())
+        return;
+
+    stop();
+
+    requestedWorkers = numWorkers;
+    const auto granted = acquireWorkers(numWorkers);
+
+    const auto options = juce::Thread::RealtimeOptions {}.withApproximateAudioProcessingTime(blockSize, sampleRate);
+    for (int index = 0; index < granted; ++index)
+    {
+        auto worker = std::make_unique<Worker>(*this, index + 1);
+
+        // Hosts or sandboxes may refuse realtime scheduling; a high-priority thread still works.
+        if (! worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+
+        workers.push_back(std::move(worker));
+    }
+}
+
+void LaneWorkerPool::stop()
+{
+    for (auto& worker : workers)
+        worker->stop();
+
+    releaseWorkers(getNumWorkers());
+    workers.clear();
+    requestedWorkers = 0;
+}
+
+void LaneWorkerPool::run(int numTasks, Task task, void* context) noexcept
+{
+    if (workers.empty() || numTasks <= 1)
+    {
+        for (int index = 0; index < numTasks; ++index)
+            task(context, index);
+
+        return;
+    }
+
+    currentTask = task;
+    currentContext = context;
+    currentNumTasks = numTasks;
+    currentStride = getNumWorkers() + 1;
+    currentRunIsRealtime = isInRealtimeSection();
+    pendingWorkers.store(getNumWorkers(), std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_seq_cst);
+
+    for (auto& worker : workers)
+        worker->wakeIfParked();
+
+    runShare(0);
+
+    while (pendingWorkers.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+void LaneWorkerPool::runShare(int participant) noexcept
+{
+    // A caller checked by the realtime-safety checker has its workers' shares checked too.
+    const auto realtimeSection = ScopedRealtimeSection::alsoWhen(currentRunIsRealtime);
+
+    for (int index = participant; index < currentNumTasks; index += currentStride)
+        currentTask(currentContext, index);
+}
+} // namespace dustbox::dsp
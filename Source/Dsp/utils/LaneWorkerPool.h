@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+  File: LaneWorkerPool.h
+  Responsibility: Run a block's independent channel-lane tasks across the
+                  audio thread and a few realtime-priority worker threads.
+  Assumptions: start()/stop() run on the message thread while no run() call is
+               active; run() is called from a single audio thread.
+  Notes: Tasks are statically striped (task i goes to participant
+         i % (workers + 1), participant 0 being the caller), so no task is ever
+         claimed twice and each lane stays on the same thread block to block.
+         The per-block barrier is a generation counter plus an atomic pending
+         count. Workers spin for a few microseconds, then park on a
+         semaphore; the caller only posts to workers that have parked, and a
+         post never takes a lock. Workers are drawn from a process-wide
+         budget of one fewer than the CPU count, so many instances cannot
+         start more realtime threads than there are cores.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dustbox::dsp
+{
+class LaneWorkerPool
+{
+public:
+    using Task = void (*)(void* context, int taskIndex) noexcept;
+
+    LaneWorkerPool();
+    ~LaneWorkerPool();
+
+    /** Keeps up to numWorkers threads running, recreating them only when the count changes.
+        Fewer start when the process-wide budget is used up by other pools. */
+    void start(int numWorkers, double sampleRate, int blockSize);
+    void stop();
+
+    int getNumWorkers() const noexcept { return static_cast<int>(workers.size()); }
+
+    /** Workers running across every pool in the process, and the most there may be. */
+    static int getNumWorkersInProcess() noexcept;
+    static int getMaxWorkersInProcess() noexcept;
+
+    /** Runs task(context, i) for every i in [0, numTasks) and returns once all have finished. */
+    void run(int numTasks, Task task, void* context) noexcept;
+
+private:
+    class Worker;
+
+    void runShare(int participant) noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    int requestedWorkers { 0 };
+
+    // Written by the caller before each generation bump; read by workers after observing it.
+    Task currentTask { nullptr };
+    void* currentContext { nullptr };
+    int currentNumTasks { 0 };
+    int currentStride { 1 };
+    bool currentRunIsRealtime { false };
+
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<int> pendingWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(LaneWorkerPool)
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+  File: LatencyDelay.h
+  Responsibility: Delay a buffer by a whole number of samples so paths that do
+                  not run through a latent stage (dry signal, bypass) stay
+                  aligned with those that do.
+  Assumptions: prepare() runs on the message thread with the largest delay that
+               will be requested; setDelay()/process() run on the audio thread.
+  Notes: Per-channel ring buffers carved from a DspArena. A zero delay is a
+         no-op, so the cost only appears while a latent stage is active.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "DspArena.h"
+
+#include <algorithm>
+
+namespace dustbox::dsp
+{
+template <typename SampleType>
+class LatencyDelay
+{
+public:
+    static size_t getArenaBytes(int maxDelaySamples, int numChannels) noexcept
+    {
+        return DspArena::bytesForBuffer<SampleType>(numChannels, juce::jmax(1, maxDelaySamples));
+    }
+
+    void prepare(int maxDelaySamples, int numChannels, DspArena& arena)
+    {
+        capacity = juce::jmax(1, maxDelaySamples);
+        arena.allocateBuffer(history, numChannels, capacity);
+        delaySamples = juce::jmin(delaySamples, capacity);
+        writePosition = 0;
+    }
+
+    void reset() noexcept
+    {
+        history.clear();
+        writePosition = 0;
+    }
+
+    /** A new delay starts from silence rather than replaying stale history. */
+    void setDelay(int newDelaySamples) noexcept
+    {
+        newDelaySamples = juce::jlimit(0, capacity, newDelaySamples);
+        if (newDelaySamples == delaySamples)
+            return;
+
+        delaySamples = newDelaySamples;
+        reset();
+    }
+
+    int getDelay() const noexcept { return delaySamples; }
+
+    void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        if (delaySamples == 0)
+            return;
+
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), history.getNumChannels());
+        auto position = writePosition;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+            auto* ring = history.getWritePointer(channel);
+            position = writePosition;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const auto delayed = ring[position];
+                ring[position] = data[sample];
+                data[sample] = delayed;
+
+                if (++position == delaySamples)
+                    position = 0;
+            }
+        }
+
+        writePosition = position;
+    }
+
+private:
+    juce::AudioBuffer<SampleType> history;
+    int capacity { 1 };
+    int delaySamples { 0 };
+    int writePosition { 0 };
+};
+} // namespace dustbox::dsp
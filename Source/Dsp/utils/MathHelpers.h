@@ -3,7 +3,7 @@
   File: MathHelpers.h
   Responsibility: Provide utility math functions shared across DSP modules.
   Assumptions: Functions are simple inline helpers safe for realtime use.
-  TODO: Expand with interpolation helpers when modulation shapes are defined.
+  TODO: Expand with modulation shape helpers once those are defined.
   ==============================================================================
 */
 
@@ -38,10 +38,34 @@ inline EqualPowerGains equalPowerMixGains(float mix) noexcept
     return { dry, wet };
 }
 
-inline float softClip(float x) noexcept
+template <typename SampleType>
+inline SampleType softClip(SampleType x) noexcept
 {
     const auto x3 = x * x * x;
-    return x - (x3 * 0.3333333333f);
+    return x - (x3 * static_cast<SampleType>(0.3333333333));
+}
+
+/** First-order antiderivative anti-aliased softClip between consecutive inputs: the difference
+    quotient (F(x) - F(previous)) / (x - previous) of F(x) = x^2/2 - x^4/12. The division cancels
+    in closed form, so near-equal inputs need no fallback and cannot lose precision. Delays the
+    signal by half a sample. */
+template <typename SampleType>
+inline SampleType softClipAntiderivative(SampleType previous, SampleType x) noexcept
+{
+    const auto sum = x + previous;
+    const auto sumOfSquares = x * x + previous * previous;
+    return sum * static_cast<SampleType>(0.5) - sum * sumOfSquares * static_cast<SampleType>(1.0 / 12.0);
+}
+
+/** Four-point third-order Hermite (Catmull-Rom) interpolation between x0 and x1 at fraction t. */
+template <typename SampleType>
+inline SampleType hermiteInterpolate(SampleType xm1, SampleType x0, SampleType x1, SampleType x2, SampleType t) noexcept
+{
+    const auto half = static_cast<SampleType>(0.5);
+    const auto c1 = half * (x1 - xm1);
+    const auto c2 = xm1 - static_cast<SampleType>(2.5) * x0 + static_cast<SampleType>(2) * x1 - half * x2;
+    const auto c3 = half * (x2 - xm1) + static_cast<SampleType>(1.5) * (x0 - x1);
+    return ((c3 * t + c2) * t + c1) * t + x0;
 }
 }
 
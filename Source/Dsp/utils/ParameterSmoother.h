@@ -3,17 +3,19 @@
   File: ParameterSmoother.h
   Responsibility: Provide lightweight wrappers around juce::SmoothedValue for
                   consistent smoothing behaviour across the processor.
-  Assumptions: Smoothing is triggered from the audio thread only.
+  Assumptions: Smoothing is triggered from the audio thread only. ValueType
+               follows the processing precision of the values it feeds.
   TODO: Extend with exponential/logarithmic smoothing options per parameter.
   ==============================================================================
 */
 
 #pragma once
 
-#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_basics/juce_audio_basics.h>
 
 namespace dustbox::dsp
 {
+template <typename ValueType>
 class ParameterSmoother
 {
 public:
@@ -23,28 +25,28 @@ public:
         smoothed.reset(sampleRate, smoothingTimeSeconds);
     }
 
-    void setTarget(float value) noexcept
+    void setTarget(ValueType value) noexcept
     {
         smoothed.setTargetValue(value);
     }
 
-    float getNextValue() noexcept
+    ValueType getNextValue() noexcept
     {
         return smoothed.getNextValue();
     }
 
-    void setImmediate(float value) noexcept
+    void setImmediate(ValueType value) noexcept
     {
         smoothed.setCurrentAndTargetValue(value);
     }
 
-    float getCurrentValue() const noexcept
+    ValueType getCurrentValue() const noexcept
     {
         return smoothed.getCurrentValue();
     }
 
 private:
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothed { 0.0f };
+    juce::SmoothedValue<ValueType, juce::ValueSmoothingTypes::Linear> smoothed { ValueType {} };
     float smoothingTimeSeconds { 0.02f };
 };
 } // namespace dustbox::dsp
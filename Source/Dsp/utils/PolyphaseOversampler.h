@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+  File: PolyphaseOversampler.h
+  Responsibility: Up- and downsample one channel at a time by 2x, 4x or 8x with
+                  cascaded polyphase half-band IIR filters, so nonlinear stages
+                  can run above the host rate.
+  Assumptions: prepare() runs on the message thread; upsample()/downsample()
+               run on the audio thread in matched pairs per channel.
+  Notes: Each 2x stage is a pair of first-order allpass chains in z^-2 (the
+         classic two-path polyphase half-band), costing one multiply per
+         coefficient per low-rate sample. The first stage carries the steep
+         filter; later stages only have to reject images of content already
+         below 0.45 of the base rate, so they get fewer coefficients. The
+         filters are not linear phase; the reported latency is their group
+         delay at DC, rounded to whole base-rate samples.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "DspArena.h"
+
+#include <algorithm>
+#include <array>
+
+namespace dustbox::dsp
+{
+namespace oversampling
+{
+inline constexpr int maxStages = 3; // 8x
+
+// Two-path half-band allpass coefficients, alternating between the paths. Designed for a
+// passband edge of 0.45 of the base rate: stage 1 (transition 0.05, ~106 dB), stage 2 (0.2,
+// ~100 dB), stage 3 (0.3, ~104 dB).
+inline constexpr std::array<double, 8> stage1Coefficients {
+    0.035832788431062107, 0.1340901419430669,  0.2720401433964576,  0.42432487127186852,
+    0.57205719723570025,  0.70629214213863944, 0.82712476199732399, 0.94150309417375511
+};
+inline constexpr std::array<double, 4> stage2Coefficients {
+    0.04955103531301993, 0.19357032634740401, 0.42673668875647364, 0.76707007281308137
+};
+inline constexpr std::array<double, 3> stage3Coefficients { 0.062735752954034898, 0.26373233391150247, 0.66581509060708177 };
+
+inline constexpr std::array<int, maxStages> coefficientCounts {
+    static_cast<int>(stage1Coefficients.size()),
+    static_cast<int>(stage2Coefficients.size()),
+    static_cast<int>(stage3Coefficients.size())
+};
+inline constexpr int totalCoefficients = coefficientCounts[0] + coefficientCounts[1] + coefficientCounts[2];
+
+/** Up- plus downsampling delay of the first numStages stages, in base-rate samples. An allpass
+    section (a + z^-2) / (1 + a z^-2) delays DC by 2(1 - a)/(1 + a) high-rate samples; one
+    stage's round trip is the sum over both paths. */
+inline double getLatency(int numStages) noexcept
+{
+    double latency = 0.0;
+    double highRateSamples = 2.0;
+
+    auto addStage = [&](const auto& coefficients)
+    {
+        double stageDelay = 0.0;
+        for (const auto coefficient : coefficients)
+            stageDelay += 2.0 * (1.0 - coefficient) / (1.0 + coefficient);
+
+        latency += stageDelay / highRateSamples;
+        highRateSamples *= 2.0;
+    };
+
+    if (numStages > 0) addStage(stage1Coefficients);
+    if (numStages > 1) addStage(stage2Coefficients);
+    if (numStages > 2) addStage(stage3Coefficients);
+    return latency;
+}
+
+inline int getLatencySamples(int numStages) noexcept
+{
+    return juce::roundToInt(getLatency(numStages));
+}
+} // namespace oversampling
+
+template <typename SampleType>
+class PolyphaseOversampler
+{
+public:
+    static size_t getArenaBytes(int maxBlockSize, int numChannels) noexcept
+    {
+        const auto highRateSamples = static_cast<size_t>(maxBlockSize) << oversampling::maxStages;
+        return 2 * DspArena::bytesFor<SampleType>(highRateSamples)
+               + DspArena::bytesFor<SampleType>(static_cast<size_t>(numChannels * stateSamplesPerChannel));
+    }
+
+    void prepare(int maxBlockSize, int numChannels, DspArena& arena)
+    {
+        preparedBlockSize = maxBlockSize;
+        numChannelsPrepared = numChannels;
+
+        const auto highRateSamples = static_cast<size_t>(maxBlockSize) << oversampling::maxStages;
+        buffers[0] = arena.allocate<SampleType>(highRateSamples);
+        buffers[1] = arena.allocate<SampleType>(highRateSamples);
+        state = arena.allocate<SampleType>(static_cast<size_t>(numChannels * stateSamplesPerChannel));
+
+        auto* coefficient = coefficients.data();
+        for (const auto value : oversampling::stage1Coefficients) *coefficient++ = static_cast<SampleType>(value);
+        for (const auto value : oversampling::stage2Coefficients) *coefficient++ = static_cast<SampleType>(value);
+        for (const auto value : oversampling::stage3Coefficients) *coefficient++ = static_cast<SampleType>(value);
+    }
+
+    void reset() noexcept
+    {
+        if (state != nullptr)
+            std::fill_n(state, numChannelsPrepared * stateSamplesPerChannel, SampleType {});
+    }
+
+    /** Changing the stage count clears the filters, since their history belongs to another rate. */
+    void setNumStages(int newNumStages) noexcept
+    {
+        newNumStages = juce::jlimit(0, oversampling::maxStages, newNumStages);
+        if (newNumStages == numStages)
+            return;
+
+        numStages = newNumStages;
+        reset();
+    }
+
+    int getNumStages() const noexcept { return numStages; }
+    int getFactor() const noexcept { return 1 << numStages; }
+
+    /** Returns numSamples * getFactor() upsampled samples of input, valid until the next call. */
+    SampleType* upsample(int channel, const SampleType* input, int numSamples) noexcept
+    {
+        jassert(numSamples <= preparedBlockSize && juce::isPositiveAndBelow(channel, numChannelsPrepared));
+
+        const auto* source = input;
+        auto length = numSamples;
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            auto* destination = buffers[static_cast<size_t>(stage % 2)];
+            runStage<true>(stage, getFilterState(channel, stage, upFilter), source, destination, length);
+
+            source = destination;
+            length *= 2;
+        }
+
+        return const_cast<SampleType*>(source);
+    }
+
+    /** Decimates the buffer upsample() returned back to numSamples base-rate samples in output. */
+    void downsample(int channel, SampleType* output, int numSamples) noexcept
+    {
+        jassert(numSamples <= preparedBlockSize && juce::isPositiveAndBelow(channel, numChannelsPrepared));
+
+        auto length = numSamples << numStages;
+
+        for (int stage = numStages - 1; stage >= 0; --stage)
+        {
+            const auto* source = buffers[static_cast<size_t>(stage % 2)];
+            auto* destination = stage == 0 ? output : buffers[static_cast<size_t>((stage + 1) % 2)];
+
+            length /= 2;
+            runStage<false>(stage, getFilterState(channel, stage, downFilter), source, destination, length);
+        }
+    }
+
+private:
+    // Per channel and direction, each coefficient keeps its previous input and output.
+    static constexpr int upFilter = 0;
+    static constexpr int downFilter = 1;
+    static constexpr int stateSamplesPerChannel = 2 * 2 * oversampling::totalCoefficients;
+
+    static constexpr int getCoefficientOffset(int stage) noexcept
+    {
+        int offset = 0;
+        for (int index = 0; index < stage; ++index)
+            offset += oversampling::coefficientCounts[static_cast<size_t>(index)];
+
+        return offset;
+    }
+
+    SampleType* getFilterState(int channel, int stage, int direction) noexcept
+    {
+        return state + channel * stateSamplesPerChannel + direction * 2 * oversampling::totalCoefficients
+               + 2 * getCoefficientOffset(stage);
+    }
+
+    /** Dispatches to a stage whose coefficient count is a compile-time constant, so the chains
+        unroll and their state lives in registers for the whole block. */
+    template <bool upsampling>
+    void runStage(int stage, SampleType* filter, const SampleType* source, SampleType* destination, int length) noexcept
+    {
+        const auto* stageCoefficients = coefficients.data() + getCoefficientOffset(stage);
+
+        switch (stage)
+        {
+            case 0: processStage<upsampling, oversampling::coefficientCounts[0]>(stageCoefficients, filter, source, destination, length); break;
+            case 1: processStage<upsampling, oversampling::coefficientCounts[1]>(stageCoefficients, filter, source, destination, length); break;
+            default: processStage<upsampling, oversampling::coefficientCounts[2]>(stageCoefficients, filter, source, destination, length); break;
+        }
+    }
+
+    /** length low-rate samples through both allpass chains; coefficient i belongs to path i % 2. */
+    template <bool upsampling, int numCoefficients>
+    static void processStage(const SampleType* stageCoefficients,
+                             SampleType* filter,
+                             const SampleType* source,
+                             SampleType* destination,
+                             int length) noexcept
+    {
+        SampleType previousInputs[numCoefficients];
+        SampleType previousOutputs[numCoefficients];
+        SampleType localCoefficients[numCoefficients];
+
+        for (int index = 0; index < numCoefficients; ++index)
+        {
+            previousInputs[index] = filter[2 * index];
+            previousOutputs[index] = filter[2 * index + 1];
+            localCoefficients[index] = stageCoefficients[index];
+        }
+
+        for (int sample = 0; sample < length; ++sample)
+        {
+            // When decimating, the later sample of each pair feeds the first path, which aligns the phases.
+            auto path0 = upsampling ? source[sample] : source[2 * sample + 1];
+            auto path1 = upsampling ? source[sample] : source[2 * sample];
+
+            // y = a x + x1 - a y1, arranged so only one multiply-add sits on the recursive path.
+            auto allpass = [&](int index, SampleType& path) noexcept
+            {
+                const auto coefficient = localCoefficients[index];
+                const auto output = (coefficient * path + previousInputs[index]) - coefficient * previousOutputs[index];
+                previousInputs[index] = path;
+                previousOutputs[index] = output;
+                path = output;
+            };
+
+            for (int index = 0; index + 1 < numCoefficients; index += 2)
+            {
+                allpass(index, path0);
+                allpass(index + 1, path1);
+            }
+
+            if constexpr (numCoefficients % 2 != 0)
+                allpass(numCoefficients - 1, path0);
+
+            if constexpr (upsampling)
+            {
+                destination[2 * sample] = path0;
+                destination[2 * sample + 1] = path1;
+            }
+            else
+            {
+                destination[sample] = static_cast<SampleType>(0.5) * (path0 + path1);
+            }
+        }
+
+        for (int index = 0; index < numCoefficients; ++index)
+        {
+            filter[2 * index] = previousInputs[index];
+            filter[2 * index + 1] = previousOutputs[index];
+        }
+    }
+
+    std::array<SampleType, oversampling::totalCoefficients> coefficients {};
+    std::array<SampleType*, 2> buffers {};
+    SampleType* state { nullptr };
+    int numStages { 0 };
+    int preparedBlockSize { 0 };
+    int numChannelsPrepared { 0 };
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+  File: QualityTier.h
+  Responsibility: Name the processing quality tiers the processor can run its
+                  modules at.
+  Assumptions: The processor picks the tier; modules only see the settings it
+               implies, through their parameter structs.
+  Notes: Settings that change latency (Dirt oversampling, resampler quality)
+         only follow the high tier fixed at prepareToPlay, so the reported
+         latency never moves between block boundaries. Latency-neutral
+         settings (Tape interpolation, control rate) follow it block by block.
+         The CPU governor's reduced tiers do lower the latency-bearing
+         settings, but pad Dirt back to the latency the user's settings
+         report.
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace dustbox::dsp
+{
+/** Ordered from cheapest to most expensive, so tiers compare by cost. */
+enum class QualityTier
+{
+    minimal,  // Governed: Dirt oversampling off, fast resampler.
+    reduced,  // Governed: Dirt oversampling capped at 2x, resampler capped at balanced.
+    standard, // Realtime playback: the user's settings as they are.
+    high      // Offline rendering: cubic tape reads, at least 4x Dirt oversampling, finer control rate.
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+  File: StageProfiler.h
+  Responsibility: Time the stages of processBlock and keep a short history of
+                  per-block costs that the editor can summarise.
+  Assumptions: beginBlock()/endBlock() run on the audio thread around each
+               block; beginStage()/endStage() may also run on lane workers between them, which
+               the lane pool's hand-off orders against the audio thread.
+               getSnapshot() runs on the message thread.
+  Notes: Stage times accumulate into atomics during the block (lanes add
+         concurrently), then land in one ring of recent per-block times per
+         stage. Everything is a relaxed atomic, so readers may see a block
+         half published; the statistics are approximate by design. While the
+         profiler is disabled each timing point costs one branch on a flag
+         latched per block; with BuildConfig::enableStageProfiling off the
+         branch folds away entirely. While a TraceRecorder is recording, the
+         same timing points also emit begin/end events for the trace file,
+         whether or not the overlay's statistics are being collected.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "../../Core/BuildConfig.h"
+#include "../../Core/TraceRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace dustbox::dsp
+{
+enum class ProfiledStage
+{
+    dryCopy,  // Copying and delaying the dry signal.
+    noise,    // Generating the noise block.
+    tape,
+    dirt,
+    pump,
+    mix,      // Wet/dry mix, output gain and parallel noise.
+    bypass,   // Bypass and program-change crossfades.
+    metering, // Input and output meter readings.
+    block,    // The whole processBlock call.
+    count
+};
+
+inline constexpr size_t numProfiledStages = static_cast<size_t>(ProfiledStage::count);
+
+inline constexpr std::array<const char*, numProfiledStages> profiledStageNames {
+    "dry copy", "noise", "tape", "dirt", "pump", "mix", "bypass", "metering", "block"
+};
+
+class StageProfiler
+{
+public:
+    static constexpr int historySize = 256;
+
+    struct StageStatistics
+    {
+        float meanMicros { 0.0f };
+        float p99Micros { 0.0f };
+        float worstMicros { 0.0f };
+    };
+
+    struct Snapshot
+    {
+        std::array<StageStatistics, numProfiledStages> stages {};
+        float deadlineMicros { 0.0f }; // Duration of the most recent block.
+        int numBlocks { 0 };           // Blocks the statistics cover, up to historySize.
+    };
+
+    /** Message thread. Takes effect at the next block boundary. */
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /** Message thread, before playback: where to send trace events, and as which instance. */
+    void setTraceRecorder(TraceRecorder* recorderToUse, int instance) noexcept
+    {
+        traceRecorder = recorderToUse;
+        traceInstance = instance;
+    }
+
+    /** Audio thread: latches the enable flag and the recording state for the whole block. */
+    void beginBlock(juce::int64 startTicks) noexcept
+    {
+        if constexpr (BuildConfig::enableStageProfiling)
+        {
+            collecting = enabled.load(std::memory_order_relaxed);
+            tracing = traceRecorder != nullptr && traceRecorder->isRecording();
+            active = collecting || tracing;
+            blockStartTicks = startTicks;
+
+            if (tracing)
+                traceRecorder->begin(getStageName(ProfiledStage::block), traceInstance, startTicks);
+        }
+    }
+
+    /** True while any timing point in this block should read the clock. */
+    bool isActive() const noexcept { return BuildConfig::enableStageProfiling && active; }
+
+    /** Any thread during a block: a stage is starting. */
+    void beginStage(ProfiledStage stage, juce::int64 ticks) noexcept
+    {
+        if (tracing)
+            traceRecorder->begin(getStageName(stage), traceInstance, ticks);
+    }
+
+    /** Any thread during a block: a stage that started at startTicks has finished. */
+    void endStage(ProfiledStage stage, juce::int64 startTicks, juce::int64 endTicks) noexcept
+    {
+        if (collecting)
+            blockTicks[static_cast<size_t>(stage)].fetch_add(endTicks - startTicks, std::memory_order_relaxed);
+
+        if (tracing)
+            traceRecorder->end(getStageName(stage), traceInstance, endTicks);
+    }
+
+    /** Audio thread: publishes the block's stage times and clears them for the next one. */
+    void endBlock(juce::int64 endTicks, double blockSeconds) noexcept
+    {
+        if (! isActive())
+            return;
+
+        if (tracing)
+            traceRecorder->end(getStageName(ProfiledStage::block), traceInstance, endTicks);
+
+        if (! collecting)
+            return;
+
+        blockTicks[static_cast<size_t>(ProfiledStage::block)].fetch_add(endTicks - blockStartTicks, std::memory_order_relaxed);
+
+        const auto position = static_cast<size_t>(blocksWritten.load(std::memory_order_relaxed) % historySize);
+        const auto microsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+        for (size_t stage = 0; stage < numProfiledStages; ++stage)
+        {
+            const auto ticks = blockTicks[stage].exchange(0, std::memory_order_relaxed);
+            history[stage][position].store(static_cast<float>(static_cast<double>(ticks) * microsPerTick), std::memory_order_relaxed);
+        }
+
+        deadlineMicros.store(static_cast<float>(blockSeconds * 1.0e6), std::memory_order_relaxed);
+        blocksWritten.fetch_add(1, std::memory_order_release);
+    }
+
+    /** Message thread: mean, 99th percentile and worst time per block over the recent history. */
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot snapshot;
+        const auto written = blocksWritten.load(std::memory_order_acquire);
+        const auto count = static_cast<int>(std::min<uint32_t>(written, static_cast<uint32_t>(historySize)));
+        snapshot.numBlocks = count;
+        snapshot.deadlineMicros = deadlineMicros.load(std::memory_order_relaxed);
+
+        if (count == 0)
+            return snapshot;
+
+        std::array<float, historySize> times {};
+        for (size_t stage = 0; stage < numProfiledStages; ++stage)
+        {
+            double sum = 0.0;
+            for (int index = 0; index < count; ++index)
+            {
+                times[static_cast<size_t>(index)] = history[stage][static_cast<size_t>(index)].load(std::memory_order_relaxed);
+                sum += times[static_cast<size_t>(index)];
+            }
+
+            const auto p99Index = static_cast<size_t>((count - 1) * 99 / 100);
+            std::nth_element(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(p99Index), times.begin() + count);
+
+            auto& statistics = snapshot.stages[stage];
+            statistics.meanMicros = static_cast<float>(sum / count);
+            statistics.p99Micros = times[p99Index];
+            statistics.worstMicros = *std::max_element(times.begin() + static_cast<std::ptrdiff_t>(p99Index), times.begin() + count);
+        }
+
+        return snapshot;
+    }
+
+    /** Message thread: forgets the history, e.g. when the overlay is opened again. */
+    void clearHistory() noexcept { blocksWritten.store(0, std::memory_order_release); }
+
+private:
+    static const char* getStageName(ProfiledStage stage) noexcept { return profiledStageNames[static_cast<size_t>(stage)]; }
+
+    std::atomic<bool> enabled { false };
+    bool collecting { false };
+    bool tracing { false };
+    bool active { false };
+    juce::int64 blockStartTicks { 0 };
+    TraceRecorder* traceRecorder { nullptr };
+    int traceInstance { 0 };
+    std::array<std::atomic<juce::int64>, numProfiledStages> blockTicks {};
+    std::array<std::array<std::atomic<float>, historySize>, numProfiledStages> history {};
+    std::atomic<float> deadlineMicros { 0.0f };
+    std::atomic<uint32_t> blocksWritten { 0 };
+};
+
+/** Times one stage for as long as it is in scope, while the profiler is active. */
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(StageProfiler& profilerToUse, ProfiledStage stageToTime) noexcept
+        : profiler(profilerToUse.isActive() ? &profilerToUse : nullptr)
+        , stage(stageToTime)
+        , startTicks(profiler != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+    {
+        if (profiler != nullptr)
+            profiler->beginStage(stage, startTicks);
+    }
+
+    ~ScopedStageTimer()
+    {
+        if (profiler != nullptr)
+            profiler->endStage(stage, startTicks, juce::Time::getHighResolutionTicks());
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StageProfiler* profiler;
+    ProfiledStage stage;
+    juce::int64 startTicks;
+};
+
+/** Forwards processBlock() to a module and times it as one stage. Processing graphs and routing
+    plans only call processBlock(), so they run timed modules unchanged. */
+template <typename Module>
+class TimedModule
+{
+public:
+    TimedModule(Module& moduleToTime, StageProfiler& profilerToUse, ProfiledStage stageToTime) noexcept
+        : module(moduleToTime), profiler(profilerToUse), stage(stageToTime)
+    {
+    }
+
+    template <typename SampleType>
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        const ScopedStageTimer timer { profiler, stage };
+        module.processBlock(buffer, numSamples);
+    }
+
+private:
+    Module& module;
+    StageProfiler& profiler;
+    ProfiledStage stage;
+};
+} // namespace dustbox::dsp
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+  File: TripleBuffer.h
+  Responsibility: Provide a wait-free single-writer/single-reader mailbox that
+                  always hands the reader the most recently published value.
+  Assumptions: Exactly one writer thread (typically the message thread) and one
+               reader thread (the audio thread).
+  Notes: Publishing and acquiring are a single atomic exchange of a slot index;
+         neither side ever blocks, allocates, or copies under contention.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dustbox::dsp
+{
+template <typename T>
+class TripleBuffer
+{
+public:
+    /** Writer: slot to fill before calling publish(). Never visible to the reader until then. */
+    T& getWriteBuffer() noexcept { return slots[writeIndex]; }
+
+    /** Writer: hands the filled slot to the reader and takes back a free one. */
+    void publish() noexcept
+    {
+        writeIndex = shared.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** Reader: swaps in the latest published slot. Returns false if nothing new was published. */
+    bool acquire() noexcept
+    {
+        if ((shared.load(std::memory_order_relaxed) & freshFlag) == 0)
+            return false;
+
+        readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    /** Reader: the slot obtained by the last successful acquire(). */
+    const T& getReadBuffer() const noexcept { return slots[readIndex]; }
+
+private:
+    static constexpr uint32_t indexMask = 0x3u;
+    static constexpr uint32_t freshFlag = 0x4u;
+
+    std::array<T, 3> slots {};
+    uint32_t writeIndex { 0 };
+    std::atomic<uint32_t> shared { 1 };
+    uint32_t readIndex { 2 };
+};
+} // namespace dustbox::dsp
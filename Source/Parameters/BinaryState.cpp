@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+  File: BinaryState.cpp
+  Responsibility: Encode and decode Dustbox's compact binary session state.
+  Assumptions: Callers fall back to the legacy XML path when readBinaryState()
+               rejects the data.
+  Notes: No XML, ValueTree, or temporary heap allocations are involved in
+         either direction.
+  ==============================================================================
+*/
+
+#include "BinaryState.h"
+
+#include <cstring>
+
+namespace dustbox::params
+{
+namespace
+{
+constexpr size_t headerSize = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+constexpr size_t chunkHeaderSize = 2 * sizeof(uint32_t);
+constexpr uint32_t fnvOffsetBasis = 2166136261u;
+constexpr uint32_t fnvPrime = 16777619u;
+
+uint32_t computeChecksum(const uint8_t* bytes, size_t numBytes) noexcept
+{
+    auto hash = fnvOffsetBasis;
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= fnvPrime;
+    }
+
+    return hash;
+}
+
+template <typename Integer>
+uint8_t* writeLittleEndian(uint8_t* destination, Integer value) noexcept
+{
+    const auto littleEndian = juce::ByteOrder::swapIfBigEndian(value);
+    std::memcpy(destination, &littleEndian, sizeof(littleEndian));
+    return destination + sizeof(littleEndian);
+}
+} // namespace
+
+void writeBinaryState(const ParameterValues& values, juce::MemoryBlock& destination)
+{
+    constexpr auto totalSize = getBinaryStateSize(numParameters);
+    destination.setSize(totalSize, false);
+
+    const auto written = writeBinaryState(values, destination.getData(), totalSize);
+    jassert(written == totalSize);
+    juce::ignoreUnused(written);
+}
+
+size_t writeBinaryState(const ParameterValues& values, void* destination, size_t capacity) noexcept
+{
+    constexpr auto totalSize = getBinaryStateSize(numParameters);
+    if (destination == nullptr || capacity < totalSize)
+        return 0;
+
+    auto* const start = static_cast<uint8_t*>(destination);
+    auto* write = start;
+
+    write = writeLittleEndian(write, binaryStateMagic);
+    write = writeLittleEndian(write, binaryStateVersion);
+    write = writeLittleEndian(write, static_cast<uint16_t>(numParameters));
+
+    for (const auto value : values)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write = writeLittleEndian(write, bits);
+    }
+
+    const auto checksum = computeChecksum(start, static_cast<size_t>(write - start));
+    write = writeLittleEndian(write, checksum);
+
+    jassert(static_cast<size_t>(write - start) == totalSize);
+    return totalSize;
+}
+
+bool hasBinaryStateMagic(const void* data, int sizeInBytes) noexcept
+{
+    if (data == nullptr || sizeInBytes < static_cast<int>(sizeof(uint32_t)))
+        return false;
+
+    return juce::ByteOrder::littleEndianInt(data) == binaryStateMagic;
+}
+
+int readBinaryState(const void* data, int sizeInBytes, ParameterValues& values) noexcept
+{
+    if (! hasBinaryStateMagic(data, sizeInBytes) || sizeInBytes < static_cast<int>(getBinaryStateSize(0)))
+        return -1;
+
+    const auto* const bytes = static_cast<const uint8_t*>(data);
+    const auto version = juce::ByteOrder::littleEndianShort(bytes + sizeof(uint32_t));
+    const auto storedCount = static_cast<size_t>(juce::ByteOrder::littleEndianShort(bytes + sizeof(uint32_t) + sizeof(uint16_t)));
+
+    if (version == 0 || version > binaryStateVersion)
+        return -1;
+
+    const auto expectedSize = getBinaryStateSize(storedCount);
+    if (static_cast<size_t>(sizeInBytes) < expectedSize)
+        return -1;
+
+    const auto payloadSize = expectedSize - sizeof(uint32_t);
+    if (computeChecksum(bytes, payloadSize) != juce::ByteOrder::littleEndianInt(bytes + payloadSize))
+        return -1;
+
+    // Newer builds may have appended parameters this build does not know; ignore them.
+    const auto countToRead = juce::jmin(storedCount, numParameters);
+    const auto* read = bytes + headerSize;
+
+    for (size_t index = 0; index < countToRead; ++index)
+    {
+        const auto bits = juce::ByteOrder::littleEndianInt(read);
+        read += sizeof(uint32_t);
+
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        values[index] = value;
+    }
+
+    return static_cast<int>(countToRead);
+}
+
+void appendBinaryStateChunk(juce::MemoryBlock& destination, uint32_t tag, const void* chunkData, size_t numBytes)
+{
+    const auto offset = destination.getSize();
+    destination.setSize(offset + chunkHeaderSize + numBytes + sizeof(uint32_t), false);
+
+    auto* const start = static_cast<uint8_t*>(destination.getData()) + offset;
+    auto* write = start;
+
+    write = writeLittleEndian(write, tag);
+    write = writeLittleEndian(write, static_cast<uint32_t>(numBytes));
+    if (numBytes > 0)
+        std::memcpy(write, chunkData, numBytes);
+    write += numBytes;
+
+    const auto checksum = computeChecksum(start, static_cast<size_t>(write - start));
+    writeLittleEndian(write, checksum);
+}
+
+const void* findBinaryStateChunk(const void* data, int sizeInBytes, uint32_t tag, size_t& numBytes) noexcept
+{
+    numBytes = 0;
+    if (! hasBinaryStateMagic(data, sizeInBytes) || sizeInBytes < static_cast<int>(getBinaryStateSize(0)))
+        return nullptr;
+
+    const auto* const bytes = static_cast<const uint8_t*>(data);
+    const auto totalSize = static_cast<size_t>(sizeInBytes);
+    const auto storedCount = static_cast<size_t>(juce::ByteOrder::littleEndianShort(bytes + sizeof(uint32_t) + sizeof(uint16_t)));
+    auto offset = getBinaryStateSize(storedCount);
+
+    while (offset + chunkHeaderSize + sizeof(uint32_t) <= totalSize)
+    {
+        const auto chunkTag = juce::ByteOrder::littleEndianInt(bytes + offset);
+        const auto chunkBytes = static_cast<size_t>(juce::ByteOrder::littleEndianInt(bytes + offset + sizeof(uint32_t)));
+        const auto checksumOffset = offset + chunkHeaderSize + chunkBytes;
+
+        if (chunkBytes > totalSize || checksumOffset + sizeof(uint32_t) > totalSize
+            || computeChecksum(bytes + offset, checksumOffset - offset) != juce::ByteOrder::littleEndianInt(bytes + checksumOffset))
+            return nullptr;
+
+        if (chunkTag == tag)
+        {
+            numBytes = chunkBytes;
+            return bytes + offset + chunkHeaderSize;
+        }
+
+        offset = checksumOffset + sizeof(uint32_t);
+    }
+
+    return nullptr;
+}
+} // namespace dustbox::params
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+  File: BinaryState.h
+  Responsibility: Declare the compact, versioned binary format Dustbox uses for
+                  host session state (parameter index -> plain float value).
+  Assumptions: Values are stored in params::ParameterIndex order; the index
+               order is append-only so older blobs stay readable.
+  Notes: Layout (little-endian): magic u32, version u16, value count u16,
+         count x f32 values, FNV-1a u32 checksum over everything before it.
+         Optional chunks may follow: tag u32, length u32, bytes, FNV-1a u32
+         over the chunk. Version 1 readers ignore anything after the checksum.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "ParameterIndex.h"
+
+#include <cstdint>
+
+namespace dustbox::params
+{
+inline constexpr uint32_t binaryStateMagic = 0x53584244u; // "DBXS"
+inline constexpr uint16_t binaryStateVersion = 1;
+
+/** Size in bytes of a binary state holding the given number of values. */
+constexpr size_t getBinaryStateSize(size_t numValues) noexcept
+{
+    return sizeof(uint32_t) + 2 * sizeof(uint16_t) + numValues * sizeof(float) + sizeof(uint32_t);
+}
+
+/** Replaces the block's contents with the encoded values. Allocates only if the block is too small. */
+void writeBinaryState(const ParameterValues& values, juce::MemoryBlock& destination);
+
+/** Encodes the values into caller-owned memory without allocating. Returns the bytes written, or
+    0 when capacity is below getBinaryStateSize(numParameters). */
+size_t writeBinaryState(const ParameterValues& values, void* destination, size_t capacity) noexcept;
+
+/** True when the data starts with the binary state magic (it may still fail validation). */
+bool hasBinaryStateMagic(const void* data, int sizeInBytes) noexcept;
+
+/** Decodes into values, leaving entries beyond the stored count untouched.
+    Returns the number of values read, or -1 if the data is not a valid binary state. */
+int readBinaryState(const void* data, int sizeInBytes, ParameterValues& values) noexcept;
+
+/** Appends a tagged chunk after an encoded state. */
+void appendBinaryStateChunk(juce::MemoryBlock& destination, uint32_t tag, const void* chunkData, size_t numBytes);
+
+/** Returns the payload of the first intact chunk with the tag, or nullptr when absent. */
+const void* findBinaryStateChunk(const void* data, int sizeInBytes, uint32_t tag, size_t& numBytes) noexcept;
+} // namespace dustbox::params
@@ -27,6 +27,7 @@ inline constexpr auto noiseRouting       = "noiseRouting";
 inline constexpr auto dirtSaturationAmt  = "dirtSaturationAmt";
 inline constexpr auto dirtBitDepthBits   = "dirtBitDepthBits";
 inline constexpr auto dirtSampleRateDiv  = "dirtSampleRateDiv";
+inline constexpr auto dirtTargetRate     = "dirtTargetRate";
 
 // Pump
 inline constexpr auto pumpAmount         = "pumpAmount";
@@ -37,6 +38,25 @@ inline constexpr auto pumpPhase          = "pumpPhase";
 inline constexpr auto mixWet             = "mixWet";
 inline constexpr auto outputGainDb       = "outputGainDb";
 inline constexpr auto hardBypass         = "hardBypass";
+
+// Morph
+inline constexpr auto morphMode          = "morphMode";
+inline constexpr auto morphPosition      = "morphPosition";
+inline constexpr auto morphPresetA       = "morphPresetA";
+inline constexpr auto morphPresetB       = "morphPresetB";
+inline constexpr auto morphPresetC       = "morphPresetC";
+inline constexpr auto morphPresetD       = "morphPresetD";
+
+// Routing
+inline constexpr auto chainOrder         = "chainOrder";
+
+// Quality
+inline constexpr auto dirtOversampling   = "dirtOversampling";
+inline constexpr auto dirtSaturationMode = "dirtSaturationMode";
+inline constexpr auto dirtResampleQuality = "dirtResampleQuality";
+
+// Performance
+inline constexpr auto cpuBudget          = "cpuBudget";
 } // namespace ids
 } // namespace dustbox::params
 
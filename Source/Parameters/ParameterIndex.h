@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+  File: ParameterIndex.h
+  Responsibility: Assign every Dustbox parameter a stable dense index so
+                  presets, state, and realtime snapshots can use flat float
+                  arrays instead of string lookups or ValueTrees.
+  Assumptions: Order is append-only; stored presets and binary state depend on
+               existing indices never moving.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ParameterIDs.h"
+
+#include <array>
+#include <cstddef>
+
+namespace dustbox::params
+{
+enum class ParameterIndex : size_t
+{
+    tapeWowDepth = 0,
+    tapeWowRateHz,
+    tapeFlutterDepth,
+    tapeToneLowpassHz,
+    tapeNoiseLevelDb,
+    noiseRouting,
+    dirtSaturationAmt,
+    dirtBitDepthBits,
+    dirtSampleRateDiv,
+    pumpAmount,
+    pumpSyncNote,
+    pumpPhase,
+    mixWet,
+    outputGainDb,
+    hardBypass,
+    morphMode,
+    morphPosition,
+    morphPresetA,
+    morphPresetB,
+    morphPresetC,
+    morphPresetD,
+    chainOrder,
+    dirtOversampling,
+    dirtSaturationMode,
+    dirtTargetRate,
+    dirtResampleQuality,
+    cpuBudget,
+    count
+};
+
+inline constexpr size_t numParameters = static_cast<size_t>(ParameterIndex::count);
+
+constexpr size_t toIndex(ParameterIndex index) noexcept
+{
+    return static_cast<size_t>(index);
+}
+
+inline constexpr std::array<const char*, numParameters> parameterIdsByIndex {
+    ids::tapeWowDepth,
+    ids::tapeWowRateHz,
+    ids::tapeFlutterDepth,
+    ids::tapeToneLowpassHz,
+    ids::tapeNoiseLevelDb,
+    ids::noiseRouting,
+    ids::dirtSaturationAmt,
+    ids::dirtBitDepthBits,
+    ids::dirtSampleRateDiv,
+    ids::pumpAmount,
+    ids::pumpSyncNote,
+    ids::pumpPhase,
+    ids::mixWet,
+    ids::outputGainDb,
+    ids::hardBypass,
+    ids::morphMode,
+    ids::morphPosition,
+    ids::morphPresetA,
+    ids::morphPresetB,
+    ids::morphPresetC,
+    ids::morphPresetD,
+    ids::chainOrder,
+    ids::dirtOversampling,
+    ids::dirtSaturationMode,
+    ids::dirtTargetRate,
+    ids::dirtResampleQuality,
+    ids::cpuBudget,
+};
+
+/** Plain (denormalised) parameter values in ParameterIndex order. */
+using ParameterValues = std::array<float, numParameters>;
+
+/** Morph controls select and blend presets, and quality settings trade CPU or latency for
+    fidelity per session, so presets neither store nor recall them. */
+constexpr bool isStoredInPresets(ParameterIndex index) noexcept
+{
+    switch (index)
+    {
+        case ParameterIndex::morphMode:
+        case ParameterIndex::morphPosition:
+        case ParameterIndex::morphPresetA:
+        case ParameterIndex::morphPresetB:
+        case ParameterIndex::morphPresetC:
+        case ParameterIndex::morphPresetD:
+        case ParameterIndex::dirtOversampling:
+        case ParameterIndex::dirtSaturationMode:
+        case ParameterIndex::dirtResampleQuality:
+        case ParameterIndex::cpuBudget:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/** How the preset morph engine blends a parameter between two neighbouring presets. */
+enum class MorphBehaviour
+{
+    none,             // Left at the live value (bypass, morph controls).
+    interpolate,      // Linear blend.
+    roundToStep,      // Linear blend rounded to the nearest integer step.
+    switchAtMidpoint  // Takes the second preset's value from the middle of the segment on.
+};
+
+constexpr MorphBehaviour getMorphBehaviour(ParameterIndex index) noexcept
+{
+    switch (index)
+    {
+        case ParameterIndex::dirtBitDepthBits:
+        case ParameterIndex::dirtSampleRateDiv:
+            return MorphBehaviour::roundToStep;
+        case ParameterIndex::noiseRouting:
+        case ParameterIndex::pumpSyncNote:
+        case ParameterIndex::chainOrder:
+        case ParameterIndex::dirtTargetRate:
+            return MorphBehaviour::switchAtMidpoint;
+        case ParameterIndex::hardBypass:
+            return MorphBehaviour::none;
+        default:
+            return isStoredInPresets(index) ? MorphBehaviour::interpolate : MorphBehaviour::none;
+    }
+}
+} // namespace dustbox::params
@@ -2,7 +2,8 @@
   ==============================================================================
   File: ParameterLayout.h
   Responsibility: Construct the AudioProcessorValueTreeState layout for Dustbox.
-  Assumptions: Layout is consumed by DustboxProcessor during construction.
+  Assumptions: Layout is consumed by DustboxProcessor during construction;
+               morph source choices list the factory presets in table order.
   TODO: Add parameter metadata (tooltips, value formatters) once UI expands.
   ==============================================================================
 */
@@ -16,7 +17,7 @@
 
 namespace dustbox::params
 {
-inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(const juce::StringArray& morphSourceNames)
 {
     using Layout = juce::AudioProcessorValueTreeState::ParameterLayout;
     Layout layout;
@@ -102,6 +103,51 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
     layout.add(makeFloat({ ids::outputGainDb, "Output Gain", -24.0f, 24.0f, 0.0f }));
     layout.add(makeBool({ ids::hardBypass, "Hard Bypass", false }));
 
+    // Morph
+    layout.add(makeChoice({ ids::morphMode,
+                            "Morph Mode",
+                            juce::StringArray { "off", "two_presets", "four_presets" },
+                            0 }));
+    layout.add(makeFloat({ ids::morphPosition, "Morph Position", 0.0f, 1.0f, 0.0f }));
+
+    const auto lastSource = juce::jmax(0, morphSourceNames.size() - 1);
+    layout.add(makeChoice({ ids::morphPresetA, "Morph Preset A", morphSourceNames, juce::jmin(0, lastSource) }));
+    layout.add(makeChoice({ ids::morphPresetB, "Morph Preset B", morphSourceNames, juce::jmin(1, lastSource) }));
+    layout.add(makeChoice({ ids::morphPresetC, "Morph Preset C", morphSourceNames, juce::jmin(2, lastSource) }));
+    layout.add(makeChoice({ ids::morphPresetD, "Morph Preset D", morphSourceNames, juce::jmin(3, lastSource) }));
+
+    // Routing
+    layout.add(makeChoice({ ids::chainOrder,
+                            "Chain Order",
+                            juce::StringArray { "tape_dirt_pump", "dirt_tape_pump", "pump_tape_dirt" },
+                            0 }));
+
+    // Quality
+    layout.add(makeChoice({ ids::dirtOversampling,
+                            "Dirt Oversampling",
+                            juce::StringArray { "off", "2x", "4x", "8x" },
+                            0 }));
+    layout.add(makeChoice({ ids::dirtSaturationMode,
+                            "Dirt Saturation Mode",
+                            juce::StringArray { "plain", "adaa" },
+                            0 }));
+
+    // Dirt rate reduction
+    layout.add(makeChoice({ ids::dirtTargetRate,
+                            "Dirt Target Rate",
+                            juce::StringArray { "divider", "8000", "11025", "16000", "22050", "32000" },
+                            0 }));
+    layout.add(makeChoice({ ids::dirtResampleQuality,
+                            "Dirt Resample Quality",
+                            juce::StringArray { "fast", "balanced", "high" },
+                            0 }));
+
+    // Performance: share of each block's realtime deadline before the CPU governor sheds quality.
+    layout.add(makeChoice({ ids::cpuBudget,
+                            "CPU Budget",
+                            juce::StringArray { "off", "10%", "25%", "50%" },
+                            0 }));
+
     return layout;
 }
 } // namespace dustbox::params
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+  File: ParameterRanges.h
+  Responsibility: Give every parameter its plain-value range and default in
+                  ParameterIndex order, for code that runs the DSP without the
+                  AudioProcessorValueTreeState (the embeddable C library).
+  Assumptions: Mirrors ParameterLayout.h; DustboxProcessor asserts in debug
+               builds that the two agree. Choice parameters are indices.
+  Notes: The morph source choices list the factory presets, whose count is only
+         known at runtime, so their maxValue is left at zero here and callers
+         bound them by FactoryPresetTable::size().
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ParameterIndex.h"
+
+#include <array>
+
+namespace dustbox::params
+{
+struct ParameterRange
+{
+    float minValue { 0.0f };
+    float maxValue { 1.0f };
+    float defaultValue { 0.0f };
+    bool isDiscrete { false }; // Int, bool and choice parameters take whole values only.
+};
+
+inline constexpr std::array<ParameterRange, numParameters> parameterRanges {{
+    { 0.0f, 1.0f, 0.15f, false },          // tapeWowDepth
+    { 0.10f, 5.0f, 0.60f, false },         // tapeWowRateHz
+    { 0.0f, 1.0f, 0.08f, false },          // tapeFlutterDepth
+    { 2000.0f, 20000.0f, 11000.0f, false }, // tapeToneLowpassHz
+    { -60.0f, -20.0f, -48.0f, false },     // tapeNoiseLevelDb
+    { 0.0f, 2.0f, 1.0f, true },            // noiseRouting
+    { 0.0f, 1.0f, 0.35f, false },          // dirtSaturationAmt
+    { 4.0f, 24.0f, 12.0f, true },          // dirtBitDepthBits
+    { 1.0f, 16.0f, 2.0f, true },           // dirtSampleRateDiv
+    { 0.0f, 1.0f, 0.35f, false },          // pumpAmount
+    { 0.0f, 2.0f, 1.0f, true },            // pumpSyncNote
+    { 0.0f, 1.0f, 0.0f, false },           // pumpPhase
+    { 0.0f, 1.0f, 0.5f, false },           // mixWet
+    { -24.0f, 24.0f, 0.0f, false },        // outputGainDb
+    { 0.0f, 1.0f, 0.0f, true },            // hardBypass
+    { 0.0f, 2.0f, 0.0f, true },            // morphMode
+    { 0.0f, 1.0f, 0.0f, false },           // morphPosition
+    { 0.0f, 0.0f, 0.0f, true },            // morphPresetA
+    { 0.0f, 0.0f, 1.0f, true },            // morphPresetB
+    { 0.0f, 0.0f, 2.0f, true },            // morphPresetC
+    { 0.0f, 0.0f, 3.0f, true },            // morphPresetD
+    { 0.0f, 2.0f, 0.0f, true },            // chainOrder
+    { 0.0f, 3.0f, 0.0f, true },            // dirtOversampling
+    { 0.0f, 1.0f, 0.0f, true },            // dirtSaturationMode
+    { 0.0f, 5.0f, 0.0f, true },            // dirtTargetRate
+    { 0.0f, 2.0f, 0.0f, true },            // dirtResampleQuality
+    { 0.0f, 3.0f, 0.0f, true },            // cpuBudget
+}};
+
+constexpr bool isMorphSource(ParameterIndex index) noexcept
+{
+    return index == ParameterIndex::morphPresetA || index == ParameterIndex::morphPresetB
+           || index == ParameterIndex::morphPresetC || index == ParameterIndex::morphPresetD;
+}
+
+/** Every parameter at its default. */
+constexpr ParameterValues getDefaultParameterValues() noexcept
+{
+    ParameterValues values {};
+    for (size_t index = 0; index < numParameters; ++index)
+        values[index] = parameterRanges[index].defaultValue;
+
+    return values;
+}
+} // namespace dustbox::params
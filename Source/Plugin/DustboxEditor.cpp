@@ -10,6 +10,7 @@
 #include "DustboxEditor.h"
 
 #include "../Parameters/ParameterIDs.h"
+#include "../Presets/FactoryPresets.h"
 
 #include <algorithm>
 #include <array>
@@ -27,74 +28,372 @@ const std::array<juce::String, 3> noteDivisionLabels {
     juce::String(juce::CharPointer_UTF8("\xE2\x85\x9B")), // ⅛
     juce::String(juce::CharPointer_UTF8(u8"1\u204416")) // 1⁄16
 };
+
+using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+
+void configurePercentSlider(ui::LabeledSlider& control)
+{
+    auto& slider = control.getSlider();
+    slider.textFromValueFunction = [](double value) { return juce::String(value * 100.0, 1) + " %"; };
+    slider.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue() / 100.0; };
+}
+
+void addToGroup(ui::GroupContainer& group, const juce::Array<juce::Component*>& components)
+{
+    for (auto* component : components)
+        group.addAndMakeVisible(*component);
+}
 } // namespace
 
+struct DustboxEditor::TapeSection
+{
+    TapeSection(juce::AudioProcessorValueTreeState& state, ui::GroupContainer& group)
+    {
+        configurePercentSlider(wowDepth);
+        configurePercentSlider(flutterDepth);
+
+        auto& wowRateSlider = wowRate.getSlider();
+        wowRateSlider.setNumDecimalPlacesToDisplay(2);
+        wowRateSlider.setTextValueSuffix(" Hz");
+
+        auto& tone = toneLowpass.getSlider();
+        tone.setNumDecimalPlacesToDisplay(0);
+        tone.setTextValueSuffix(" Hz");
+
+        auto& noise = noiseLevel.getSlider();
+        noise.setNumDecimalPlacesToDisplay(1);
+        noise.setTextValueSuffix(" dB");
+
+        auto& noiseRoutingCombo = noiseRouting.getComboBox();
+        noiseRoutingCombo.addItem("Pre Tape", 1);
+        noiseRoutingCombo.addItem("Post Tape", 2);
+        noiseRoutingCombo.addItem("Parallel", 3);
+
+        wowDepthAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeWowDepth, wowDepth.getSlider());
+        wowRateAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeWowRateHz, wowRate.getSlider());
+        flutterAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeFlutterDepth, flutterDepth.getSlider());
+        toneAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeToneLowpassHz, toneLowpass.getSlider());
+        noiseLevelAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeNoiseLevelDb, noiseLevel.getSlider());
+        noiseRoutingAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::noiseRouting, noiseRouting.getComboBox());
+
+        addToGroup(group, getComponents());
+    }
+
+    juce::Array<juce::Component*> getComponents()
+    {
+        return { &wowDepth, &wowRate, &flutterDepth, &toneLowpass, &noiseLevel, &noiseRouting };
+    }
+
+    ui::LabeledSlider wowDepth { "Wow Depth" };
+    ui::LabeledSlider wowRate { "Wow Rate" };
+    ui::LabeledSlider flutterDepth { "Flutter" };
+    ui::LabeledSlider toneLowpass { "Tone" };
+    ui::LabeledSlider noiseLevel { "Noise" };
+    ui::LabeledComboBox noiseRouting { "Routing" };
+
+    std::unique_ptr<SliderAttachment> wowDepthAttachment;
+    std::unique_ptr<SliderAttachment> wowRateAttachment;
+    std::unique_ptr<SliderAttachment> flutterAttachment;
+    std::unique_ptr<SliderAttachment> toneAttachment;
+    std::unique_ptr<SliderAttachment> noiseLevelAttachment;
+    std::unique_ptr<ComboBoxAttachment> noiseRoutingAttachment;
+};
+
+struct DustboxEditor::DirtSection
+{
+    DirtSection(juce::AudioProcessorValueTreeState& state, ui::GroupContainer& group)
+    {
+        configurePercentSlider(saturation);
+
+        auto& bitDepthSlider = bitDepth.getSlider();
+        bitDepthSlider.setNumDecimalPlacesToDisplay(0);
+        bitDepthSlider.textFromValueFunction = [](double value) { return juce::String(static_cast<int>(std::round(value))) + " bit"; };
+        bitDepthSlider.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue(); };
+
+        auto& rateDiv = sampleRateDiv.getSlider();
+        rateDiv.setNumDecimalPlacesToDisplay(0);
+        rateDiv.textFromValueFunction = [](double value) { return juce::String(static_cast<int>(std::round(value))) + "x"; };
+        rateDiv.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue(); };
+
+        auto& oversamplingCombo = oversampling.getComboBox();
+        oversamplingCombo.addItem("Off", 1);
+        oversamplingCombo.addItem("2x", 2);
+        oversamplingCombo.addItem("4x", 3);
+        oversamplingCombo.addItem("8x", 4);
+
+        auto& saturationModeCombo = saturationMode.getComboBox();
+        saturationModeCombo.addItem("Plain", 1);
+        saturationModeCombo.addItem("ADAA", 2);
+
+        auto& targetRateCombo = targetRate.getComboBox();
+        targetRateCombo.addItem("Divider", 1);
+        targetRateCombo.addItem("8 kHz", 2);
+        targetRateCombo.addItem("11 kHz", 3);
+        targetRateCombo.addItem("16 kHz", 4);
+        targetRateCombo.addItem("22 kHz", 5);
+        targetRateCombo.addItem("32 kHz", 6);
+
+        auto& resampleQualityCombo = resampleQuality.getComboBox();
+        resampleQualityCombo.addItem("Fast", 1);
+        resampleQualityCombo.addItem("Balanced", 2);
+        resampleQualityCombo.addItem("High", 3);
+
+        saturationAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtSaturationAmt, saturation.getSlider());
+        bitDepthAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtBitDepthBits, bitDepth.getSlider());
+        sampleRateAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtSampleRateDiv, sampleRateDiv.getSlider());
+        oversamplingAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::dirtOversampling, oversampling.getComboBox());
+        saturationModeAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::dirtSaturationMode, saturationMode.getComboBox());
+        targetRateAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::dirtTargetRate, targetRate.getComboBox());
+        resampleQualityAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::dirtResampleQuality, resampleQuality.getComboBox());
+
+        addToGroup(group, getComponents());
+    }
+
+    juce::Array<juce::Component*> getComponents()
+    {
+        return { &saturation, &bitDepth, &sampleRateDiv, &targetRate, &resampleQuality, &oversampling, &saturationMode };
+    }
+
+    ui::LabeledSlider saturation { "Saturation" };
+    ui::LabeledSlider bitDepth { "Bit Depth" };
+    ui::LabeledSlider sampleRateDiv { "Rate Div" };
+    ui::LabeledComboBox targetRate { "Target Rate" };
+    ui::LabeledComboBox resampleQuality { "Resample" };
+    ui::LabeledComboBox oversampling { "Oversample" };
+    ui::LabeledComboBox saturationMode { "Shaper" };
+
+    std::unique_ptr<SliderAttachment> saturationAttachment;
+    std::unique_ptr<SliderAttachment> bitDepthAttachment;
+    std::unique_ptr<SliderAttachment> sampleRateAttachment;
+    std::unique_ptr<ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<ComboBoxAttachment> saturationModeAttachment;
+    std::unique_ptr<ComboBoxAttachment> targetRateAttachment;
+    std::unique_ptr<ComboBoxAttachment> resampleQualityAttachment;
+};
+
+struct DustboxEditor::PumpSection
+{
+    PumpSection(juce::AudioProcessorValueTreeState& state, ui::GroupContainer& group)
+    {
+        configurePercentSlider(amount);
+
+        auto& syncCombo = syncNote.getComboBox();
+        syncCombo.addItem(noteDivisionLabels[0], 1);
+        syncCombo.addItem(noteDivisionLabels[1], 2);
+        syncCombo.addItem(noteDivisionLabels[2], 3);
+
+        auto& phaseSlider = phase.getSlider();
+        const juce::String degreeSymbol { juce::CharPointer_UTF8("\xC2\xB0") };
+        phaseSlider.textFromValueFunction = [degreeSymbol](double value) { return juce::String(value * 360.0, 1) + degreeSymbol; };
+        phaseSlider.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue() / 360.0; };
+
+        amountAttachment = std::make_unique<SliderAttachment>(state, params::ids::pumpAmount, amount.getSlider());
+        syncAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::pumpSyncNote, syncNote.getComboBox());
+        phaseAttachment = std::make_unique<SliderAttachment>(state, params::ids::pumpPhase, phase.getSlider());
+
+        addToGroup(group, getComponents());
+    }
+
+    juce::Array<juce::Component*> getComponents()
+    {
+        return { &amount, &syncNote, &phase, &tempoDisplay };
+    }
+
+    ui::LabeledSlider amount { "Amount" };
+    ui::LabeledComboBox syncNote { "Sync" };
+    ui::LabeledSlider phase { "Phase" };
+    ui::HostTempoDisplay tempoDisplay;
+
+    std::unique_ptr<SliderAttachment> amountAttachment;
+    std::unique_ptr<ComboBoxAttachment> syncAttachment;
+    std::unique_ptr<SliderAttachment> phaseAttachment;
+};
+
+struct DustboxEditor::MorphSection
+{
+    MorphSection(juce::AudioProcessorValueTreeState& state, ui::GroupContainer& group, const juce::StringArray& presetNames)
+    {
+        auto& modeCombo = mode.getComboBox();
+        modeCombo.addItem("Off", 1);
+        modeCombo.addItem("2 Presets", 2);
+        modeCombo.addItem("4 Presets", 3);
+
+        configurePercentSlider(position);
+
+        for (auto* source : { &presetA, &presetB, &presetC, &presetD })
+            source->getComboBox().addItemList(presetNames, 1);
+
+        modeAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::morphMode, mode.getComboBox());
+        positionAttachment = std::make_unique<SliderAttachment>(state, params::ids::morphPosition, position.getSlider());
+        presetAAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::morphPresetA, presetA.getComboBox());
+        presetBAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::morphPresetB, presetB.getComboBox());
+        presetCAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::morphPresetC, presetC.getComboBox());
+        presetDAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::morphPresetD, presetD.getComboBox());
+
+        addToGroup(group, getComponents());
+    }
+
+    juce::Array<juce::Component*> getComponents()
+    {
+        return { &mode, &position, &presetA, &presetB, &presetC, &presetD };
+    }
+
+    ui::LabeledComboBox mode { "Morph" };
+    ui::LabeledSlider position { "Position" };
+    ui::LabeledComboBox presetA { "Preset A" };
+    ui::LabeledComboBox presetB { "Preset B" };
+    ui::LabeledComboBox presetC { "Preset C" };
+    ui::LabeledComboBox presetD { "Preset D" };
+
+    std::unique_ptr<ComboBoxAttachment> modeAttachment;
+    std::unique_ptr<SliderAttachment> positionAttachment;
+    std::unique_ptr<ComboBoxAttachment> presetAAttachment;
+    std::unique_ptr<ComboBoxAttachment> presetBAttachment;
+    std::unique_ptr<ComboBoxAttachment> presetCAttachment;
+    std::unique_ptr<ComboBoxAttachment> presetDAttachment;
+};
+
+struct DustboxEditor::GlobalSection
+{
+    GlobalSection(juce::AudioProcessorValueTreeState& state, ui::GroupContainer& group)
+    {
+        configurePercentSlider(mixWet);
+
+        auto& output = outputGain.getSlider();
+        output.setNumDecimalPlacesToDisplay(1);
+        output.setTextValueSuffix(" dB");
+
+        auto& orderCombo = chainOrder.getComboBox();
+        orderCombo.addItem("Tape > Dirt > Pump", 1);
+        orderCombo.addItem("Dirt > Tape > Pump", 2);
+        orderCombo.addItem("Pump > Tape > Dirt", 3);
+
+        // Suggestions only; any "a > b | c" routing can be typed in.
+        auto& routingCombo = routing.getComboBox();
+        routingCombo.setEditableText(true);
+        routingCombo.addItemList({ "default",
+                                   "noise > tape > dirt > pump",
+                                   "noise > tape | dirt > pump",
+                                   "pump > tape | dirt > noise",
+                                   "dirt > noise > tape > pump" },
+                                 1);
+
+        auto& budgetCombo = cpuBudget.getComboBox();
+        budgetCombo.addItem("Off", 1);
+        budgetCombo.addItem("10%", 2);
+        budgetCombo.addItem("25%", 3);
+        budgetCombo.addItem("50%", 4);
+
+        presetSelector.getComboBox().setTextWhenNothingSelected("Factory Presets");
+        hardBypass.getButton().setClickingTogglesState(true);
+
+        auto setupMeterLabel = [](juce::Label& label, const juce::String& text)
+        {
+            label.setText(text, juce::dontSendNotification);
+            label.setJustificationType(juce::Justification::centred);
+            label.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.8f));
+        };
+
+        setupMeterLabel(inputMeterLabel, "INPUT");
+        setupMeterLabel(outputMeterLabel, "OUTPUT");
+
+        clipIndicator.setColour(juce::Label::textColourId, juce::Colours::red);
+        clipIndicator.setJustificationType(juce::Justification::centredRight);
+        clipIndicator.setFont(juce::Font(juce::FontOptions(14.0f).withStyle("Bold")));
+
+        qualityStatus.setJustificationType(juce::Justification::centred);
+        qualityStatus.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.6f));
+        qualityStatus.setFont(juce::Font(juce::FontOptions(12.0f)));
+
+        mixWetAttachment = std::make_unique<SliderAttachment>(state, params::ids::mixWet, mixWet.getSlider());
+        outputGainAttachment = std::make_unique<SliderAttachment>(state, params::ids::outputGainDb, outputGain.getSlider());
+        hardBypassAttachment = std::make_unique<ButtonAttachment>(state, params::ids::hardBypass, hardBypass.getButton());
+        chainOrderAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::chainOrder, chainOrder.getComboBox());
+        cpuBudgetAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::cpuBudget, cpuBudget.getComboBox());
+
+        addToGroup(group,
+                   { &mixWet, &outputGain, &hardBypass, &chainOrder, &routing, &presetSelector, &cpuBudget,
+                     &inputMeterLabel, &outputMeterLabel, &clipIndicator, &qualityStatus,
+                     &inputMeterLeft, &inputMeterRight, &outputMeterLeft, &outputMeterRight });
+    }
+
+    ui::LabeledSlider mixWet { "Mix" };
+    ui::LabeledSlider outputGain { "Output" };
+    ui::LabeledToggleButton hardBypass { "Hard Bypass" };
+    ui::LabeledComboBox chainOrder { "Order" };
+    ui::LabeledComboBox routing { "Routing" };
+    ui::LabeledComboBox presetSelector { "Preset" };
+    ui::LabeledComboBox cpuBudget { "CPU Budget" };
+
+    ui::LevelMeter inputMeterLeft;
+    ui::LevelMeter inputMeterRight;
+    ui::LevelMeter outputMeterLeft;
+    ui::LevelMeter outputMeterRight;
+    juce::Label inputMeterLabel;
+    juce::Label outputMeterLabel;
+    juce::Label clipIndicator;
+    juce::Label qualityStatus;
+
+    std::unique_ptr<SliderAttachment> mixWetAttachment;
+    std::unique_ptr<SliderAttachment> outputGainAttachment;
+    std::unique_ptr<ButtonAttachment> hardBypassAttachment;
+    std::unique_ptr<ComboBoxAttachment> chainOrderAttachment;
+    std::unique_ptr<ComboBoxAttachment> cpuBudgetAttachment;
+};
+
 DustboxEditor::DustboxEditor(DustboxProcessor& p)
     : juce::AudioProcessorEditor(&p)
     , processor(p)
     , tapeGroup("TAPE")
     , dirtGroup("DIRT")
     , pumpGroup("PUMP")
+    , morphGroup("MORPH")
     , globalGroup("GLOBAL")
-    , tapeWowDepth("Wow Depth")
-    , tapeWowRate("Wow Rate")
-    , tapeFlutterDepth("Flutter")
-    , tapeToneLowpass("Tone")
-    , tapeNoiseLevel("Noise")
-    , noiseRouting("Routing")
-    , dirtSaturation("Saturation")
-    , dirtBitDepth("Bit Depth")
-    , dirtSampleRateDiv("Rate Div")
-    , pumpAmount("Amount")
-    , pumpSyncNote("Sync")
-    , pumpPhase("Phase")
-    , mixWet("Mix")
-    , outputGain("Output")
-    , hardBypass("Hard Bypass")
-    , presetSelector("Preset")
 {
-    initialiseControls();
-    initialiseAttachments();
-
     addAndMakeVisible(tapeGroup);
-    tapeGroup.addAndMakeVisible(tapeWowDepth);
-    tapeGroup.addAndMakeVisible(tapeWowRate);
-    tapeGroup.addAndMakeVisible(tapeFlutterDepth);
-    tapeGroup.addAndMakeVisible(tapeToneLowpass);
-    tapeGroup.addAndMakeVisible(tapeNoiseLevel);
-    tapeGroup.addAndMakeVisible(noiseRouting);
-
     addAndMakeVisible(dirtGroup);
-    dirtGroup.addAndMakeVisible(dirtSaturation);
-    dirtGroup.addAndMakeVisible(dirtBitDepth);
-    dirtGroup.addAndMakeVisible(dirtSampleRateDiv);
-
     addAndMakeVisible(pumpGroup);
-    pumpGroup.addAndMakeVisible(pumpAmount);
-    pumpGroup.addAndMakeVisible(pumpSyncNote);
-    pumpGroup.addAndMakeVisible(pumpPhase);
-    pumpGroup.addAndMakeVisible(tempoDisplay);
-
+    addAndMakeVisible(morphGroup);
     addAndMakeVisible(globalGroup);
-    globalGroup.addAndMakeVisible(mixWet);
-    globalGroup.addAndMakeVisible(outputGain);
-    globalGroup.addAndMakeVisible(hardBypass);
-    globalGroup.addAndMakeVisible(presetSelector);
-    globalGroup.addAndMakeVisible(inputMeterLabel);
-    globalGroup.addAndMakeVisible(outputMeterLabel);
-    globalGroup.addAndMakeVisible(clipIndicator);
-    globalGroup.addAndMakeVisible(inputMeterLeft);
-    globalGroup.addAndMakeVisible(inputMeterRight);
-    globalGroup.addAndMakeVisible(outputMeterLeft);
-    globalGroup.addAndMakeVisible(outputMeterRight);
 
-    refreshPresetCombo();
+    profileButton.setClickingTogglesState(true);
+    profileButton.setTooltip("Show per-stage processing times");
+    profileButton.onClick = [this]
+    {
+        const auto enabled = profileButton.getToggleState();
+        auto& profiler = processor.getStageProfiler();
+        if (enabled)
+            profiler.clearHistory();
+
+        profiler.setEnabled(enabled);
+        profilerOverlay.setVisible(enabled);
+    };
+    addAndMakeVisible(profileButton);
+    addChildComponent(profilerOverlay);
+
+    captureButton.setClickingTogglesState(true);
+    captureButton.setToggleState(processor.isCapturingSession(), juce::dontSendNotification);
+    captureButton.setTooltip("Record this host session to Dustbox/Captures for replay in the benchmark runner");
+    captureButton.onClick = [this]
+    {
+        if (! captureButton.getToggleState())
+        {
+            processor.stopSessionCapture();
+            return;
+        }
+
+        if (! processor.startSessionCapture(SessionCapture::getDefaultCaptureFile(), false))
+            captureButton.setToggleState(false, juce::dontSendNotification);
+    };
+    addAndMakeVisible(captureButton);
 
     pumpSyncParameter = processor.getValueTreeState().getRawParameterValue(params::ids::pumpSyncNote);
 
     setResizable(true, true);
-    setResizeLimits(720, 560, 1280, 960);
-    setSize(820, 640);
+    setResizeLimits(720, 700, 1280, 1100);
+    setSize(820, 800);
 
     startTimerHz(30);
 }
@@ -102,128 +401,89 @@ DustboxEditor::DustboxEditor(DustboxProcessor& p)
 DustboxEditor::~DustboxEditor()
 {
     stopTimer();
+
+    // Nobody is left to read the timings.
+    processor.getStageProfiler().setEnabled(false);
 }
 
-void DustboxEditor::initialiseControls()
+void DustboxEditor::visibilityChanged()
 {
-    auto percentText = [](double value) { return juce::String(value * 100.0, 1) + " %"; };
-    auto percentToValue = [](const juce::String& text) { return text.getDoubleValue() / 100.0; };
+    if (isShowing())
+        ensureSectionsBuilt();
+}
 
-    auto configurePercentSlider = [&](ui::LabeledSlider& control)
-    {
-        auto& slider = control.getSlider();
-        slider.textFromValueFunction = percentText;
-        slider.valueFromTextFunction = percentToValue;
-    };
+void DustboxEditor::parentHierarchyChanged()
+{
+    if (isShowing())
+        ensureSectionsBuilt();
+}
 
-    configurePercentSlider(tapeWowDepth);
-    configurePercentSlider(tapeFlutterDepth);
-    configurePercentSlider(dirtSaturation);
-    configurePercentSlider(pumpAmount);
-    configurePercentSlider(mixWet);
-
-    auto& wowRate = tapeWowRate.getSlider();
-    wowRate.setNumDecimalPlacesToDisplay(2);
-    wowRate.setTextValueSuffix(" Hz");
-
-    auto& tone = tapeToneLowpass.getSlider();
-    tone.setNumDecimalPlacesToDisplay(0);
-    tone.setTextValueSuffix(" Hz");
-
-    auto& noise = tapeNoiseLevel.getSlider();
-    noise.setNumDecimalPlacesToDisplay(1);
-    noise.setTextValueSuffix(" dB");
-
-    auto& bitDepth = dirtBitDepth.getSlider();
-    bitDepth.setNumDecimalPlacesToDisplay(0);
-    bitDepth.textFromValueFunction = [](double value) { return juce::String(static_cast<int>(std::round(value))) + " bit"; };
-    bitDepth.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue(); };
-
-    auto& rateDiv = dirtSampleRateDiv.getSlider();
-    rateDiv.setNumDecimalPlacesToDisplay(0);
-    rateDiv.textFromValueFunction = [](double value) { return juce::String(static_cast<int>(std::round(value))) + "x"; };
-    rateDiv.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue(); };
-
-    auto& phase = pumpPhase.getSlider();
-    const juce::String degreeSymbol { juce::CharPointer_UTF8("\xC2\xB0") };
-    phase.textFromValueFunction = [degreeSymbol](double value) { return juce::String(value * 360.0, 1) + degreeSymbol; };
-    phase.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue() / 360.0; };
-
-    auto& output = outputGain.getSlider();
-    output.setNumDecimalPlacesToDisplay(1);
-    output.setTextValueSuffix(" dB");
-
-    auto& noiseRoutingCombo = noiseRouting.getComboBox();
-    noiseRoutingCombo.addItem("Pre Tape", 1);
-    noiseRoutingCombo.addItem("Post Tape", 2);
-    noiseRoutingCombo.addItem("Parallel", 3);
-
-    auto& pumpSyncCombo = pumpSyncNote.getComboBox();
-    pumpSyncCombo.addItem(noteDivisionLabels[0], 1);
-    pumpSyncCombo.addItem(noteDivisionLabels[1], 2);
-    pumpSyncCombo.addItem(noteDivisionLabels[2], 3);
-
-    auto& presetCombo = presetSelector.getComboBox();
-    presetCombo.setTextWhenNothingSelected("Factory Presets");
-    presetCombo.onChange = [this]
+void DustboxEditor::ensureSectionsBuilt()
+{
+    if (areSectionsBuilt())
+        return;
+
+    auto& state = processor.getValueTreeState();
+
+    tapeSection = std::make_unique<TapeSection>(state, tapeGroup);
+    dirtSection = std::make_unique<DirtSection>(state, dirtGroup);
+    pumpSection = std::make_unique<PumpSection>(state, pumpGroup);
+
+    // The morph sources are factory presets only; the program list also carries user presets.
+    const juce::SharedResourcePointer<presets::FactoryPresetTable> factoryPresets;
+    morphSection = std::make_unique<MorphSection>(state, morphGroup, factoryPresets->getPresetNames());
+    globalSection = std::make_unique<GlobalSection>(state, globalGroup);
+
+    globalSection->presetSelector.getComboBox().onChange = [this]
     {
         if (updatingPresetSelection)
             return;
 
-        const int selectedIndex = presetSelector.getComboBox().getSelectedItemIndex();
+        const int selectedIndex = globalSection->presetSelector.getComboBox().getSelectedItemIndex();
         if (selectedIndex >= 0)
             processor.setCurrentProgram(selectedIndex);
     };
 
-    hardBypass.getButton().setClickingTogglesState(true);
-
-    auto setupMeterLabel = [](juce::Label& label, const juce::String& text)
+    globalSection->routing.getComboBox().onChange = [this]
     {
-        label.setText(text, juce::dontSendNotification);
-        label.setJustificationType(juce::Justification::centred);
-        label.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.8f));
+        auto& combo = globalSection->routing.getComboBox();
+        if (! processor.setRouting(combo.getText()))
+            combo.setText(processor.getRouting(), juce::dontSendNotification);
     };
 
-    setupMeterLabel(inputMeterLabel, "INPUT");
-    setupMeterLabel(outputMeterLabel, "OUTPUT");
-
-    clipIndicator.setColour(juce::Label::textColourId, juce::Colours::red);
-    clipIndicator.setJustificationType(juce::Justification::centredRight);
-    clipIndicator.setFont(juce::Font(juce::FontOptions(14.0f).withStyle("Bold")));
+    refreshPresetCombo();
+    refreshRoutingCombo();
+    resized();
 }
 
-void DustboxEditor::initialiseAttachments()
+void DustboxEditor::refreshRoutingCombo()
 {
-    auto& state = processor.getValueTreeState();
-
-    tapeWowDepthAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeWowDepth, tapeWowDepth.getSlider());
-    tapeWowRateAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeWowRateHz, tapeWowRate.getSlider());
-    tapeFlutterAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeFlutterDepth, tapeFlutterDepth.getSlider());
-    tapeToneAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeToneLowpassHz, tapeToneLowpass.getSlider());
-    tapeNoiseLevelAttachment = std::make_unique<SliderAttachment>(state, params::ids::tapeNoiseLevelDb, tapeNoiseLevel.getSlider());
-    noiseRoutingAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::noiseRouting, noiseRouting.getComboBox());
+    if (globalSection == nullptr)
+        return;
 
-    dirtSaturationAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtSaturationAmt, dirtSaturation.getSlider());
-    dirtBitDepthAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtBitDepthBits, dirtBitDepth.getSlider());
-    dirtSampleRateAttachment = std::make_unique<SliderAttachment>(state, params::ids::dirtSampleRateDiv, dirtSampleRateDiv.getSlider());
+    auto& combo = globalSection->routing.getComboBox();
+    const auto routing = processor.getRouting();
 
-    pumpAmountAttachment = std::make_unique<SliderAttachment>(state, params::ids::pumpAmount, pumpAmount.getSlider());
-    pumpSyncAttachment = std::make_unique<ComboBoxAttachment>(state, params::ids::pumpSyncNote, pumpSyncNote.getComboBox());
-    pumpPhaseAttachment = std::make_unique<SliderAttachment>(state, params::ids::pumpPhase, pumpPhase.getSlider());
-
-    mixWetAttachment = std::make_unique<SliderAttachment>(state, params::ids::mixWet, mixWet.getSlider());
-    outputGainAttachment = std::make_unique<SliderAttachment>(state, params::ids::outputGainDb, outputGain.getSlider());
-    hardBypassAttachment = std::make_unique<ButtonAttachment>(state, params::ids::hardBypass, hardBypass.getButton());
+    // Leave the text alone while the user is typing into it.
+    if (combo.getText() != routing && ! combo.hasKeyboardFocus(true))
+        combo.setText(routing, juce::dontSendNotification);
 }
 
 void DustboxEditor::refreshPresetCombo()
 {
-    auto& combo = presetSelector.getComboBox();
+    if (globalSection == nullptr)
+        return;
+
+    auto& combo = globalSection->presetSelector.getComboBox();
     const int numPrograms = processor.getNumPrograms();
 
-    const bool needsRefresh = combo.getNumItems() != numPrograms;
+    // The count alone misses a library replaced by one of the same size; the generation moves on
+    // every remap, including saves from other instances and processes.
+    const auto generation = processor.getPresetListGeneration();
+    const bool needsRefresh = combo.getNumItems() != numPrograms || generation != shownPresetGeneration;
     if (needsRefresh)
     {
+        shownPresetGeneration = generation;
         combo.clear(juce::dontSendNotification);
         for (int index = 0; index < numPrograms; ++index)
             combo.addItem(processor.getProgramName(index), index + 1);
@@ -249,7 +509,12 @@ void DustboxEditor::paint(juce::Graphics& g)
 void DustboxEditor::resized()
 {
     auto bounds = getLocalBounds().reduced(16);
-    bounds.removeFromTop(40);
+    auto header = bounds.removeFromTop(40);
+    profileButton.setBounds(header.removeFromRight(80).withSizeKeepingCentre(80, 24));
+    captureButton.setBounds(header.removeFromRight(88).withSizeKeepingCentre(80, 24));
+
+    const auto overlayHeight = 18 * (static_cast<int>(dsp::numProfiledStages) + 2) + 16;
+    profilerOverlay.setBounds(bounds.withTrimmedLeft(bounds.getWidth() - juce::jmin(bounds.getWidth(), 440)).withHeight(overlayHeight));
 
     constexpr int groupGap = 12;
     auto remaining = bounds;
@@ -263,22 +528,32 @@ void DustboxEditor::resized()
         group.setBounds(area);
     };
 
-    assignGroup(tapeGroup, 3);
-    assignGroup(dirtGroup, 2);
-    assignGroup(pumpGroup, 1);
+    assignGroup(tapeGroup, 4);
+    assignGroup(dirtGroup, 3);
+    assignGroup(pumpGroup, 2);
+    assignGroup(morphGroup, 1);
     assignGroup(globalGroup, 0);
 
-    layoutGroupFlex(tapeGroup, { &tapeWowDepth, &tapeWowRate, &tapeFlutterDepth, &tapeToneLowpass, &tapeNoiseLevel, &noiseRouting });
-    layoutGroupFlex(dirtGroup, { &dirtSaturation, &dirtBitDepth, &dirtSampleRateDiv });
-    layoutGroupFlex(pumpGroup, { &pumpAmount, &pumpSyncNote, &pumpPhase, &tempoDisplay });
+    if (! areSectionsBuilt())
+        return;
 
+    layoutGroupFlex(tapeGroup, tapeSection->getComponents());
+    layoutGroupFlex(dirtGroup, dirtSection->getComponents());
+    layoutGroupFlex(pumpGroup, pumpSection->getComponents());
+    layoutGroupFlex(morphGroup, morphSection->getComponents());
+
+    auto& global = *globalSection;
     auto globalContent = globalGroup.getContentBounds();
     const int meterWidth = juce::jlimit(160, globalContent.getWidth(), 240);
     auto meterArea = globalContent.removeFromRight(meterWidth);
     auto controlArea = globalContent;
-    layoutGroupFlex(globalGroup, { &mixWet, &outputGain, &hardBypass, &presetSelector }, controlArea);
+    layoutGroupFlex(globalGroup,
+                    { &global.mixWet, &global.outputGain, &global.hardBypass, &global.chainOrder, &global.routing,
+                      &global.presetSelector, &global.cpuBudget },
+                    controlArea);
 
     auto meterSpacing = 10;
+    global.qualityStatus.setBounds(meterArea.removeFromBottom(18));
 
     auto layoutMeterPair = [&](juce::Label& label, ui::LevelMeter& left, ui::LevelMeter& right, juce::Rectangle<int> area)
     {
@@ -292,29 +567,44 @@ void DustboxEditor::resized()
     };
 
     auto inputArea = meterArea.removeFromTop(meterArea.getHeight() / 2);
-    layoutMeterPair(inputMeterLabel, inputMeterLeft, inputMeterRight, inputArea);
+    layoutMeterPair(global.inputMeterLabel, global.inputMeterLeft, global.inputMeterRight, inputArea);
 
     auto outputArea = meterArea;
     auto outputLabelArea = outputArea.removeFromTop(22);
     auto clipArea = outputLabelArea.removeFromRight(60);
-    clipIndicator.setBounds(clipArea);
-    outputMeterLabel.setBounds(outputLabelArea);
+    global.clipIndicator.setBounds(clipArea);
+    global.outputMeterLabel.setBounds(outputLabelArea);
     outputArea.removeFromTop(4);
     const int outputWidth = (outputArea.getWidth() - meterSpacing) / 2;
-    outputMeterLeft.setBounds(outputArea.removeFromLeft(outputWidth));
+    global.outputMeterLeft.setBounds(outputArea.removeFromLeft(outputWidth));
     outputArea.removeFromLeft(meterSpacing);
-    outputMeterRight.setBounds(outputArea.removeFromLeft(outputWidth));
+    global.outputMeterRight.setBounds(outputArea.removeFromLeft(outputWidth));
 }
 
 void DustboxEditor::timerCallback()
 {
+    if (! areSectionsBuilt())
+    {
+        // Fallback for hosts whose window setup never reports a visibility change to the editor.
+        if (isShowing())
+            ensureSectionsBuilt();
+        return;
+    }
+
     updateMeters();
+    updateQualityStatus();
+
+    if (profilerOverlay.isVisible())
+        profilerOverlay.setSnapshot(processor.getStageProfiler().getSnapshot());
+
     updateTempoDisplay();
     refreshPresetCombo();
+    refreshRoutingCombo();
 }
 
 void DustboxEditor::updateMeters()
 {
+    auto& global = *globalSection;
     const auto channelCount = std::min<size_t>(processor.getMeterChannelCount(), 2);
 
     bool clipped = false;
@@ -336,13 +626,13 @@ void DustboxEditor::updateMeters()
 
         if (channel == 0)
         {
-            inputMeterLeft.setLevels(inputPeakDisplay[channel], inputRmsDisplay[channel], inputClip);
-            outputMeterLeft.setLevels(outputPeakDisplay[channel], outputRmsDisplay[channel], outputClip);
+            global.inputMeterLeft.setLevels(inputPeakDisplay[channel], inputRmsDisplay[channel], inputClip);
+            global.outputMeterLeft.setLevels(outputPeakDisplay[channel], outputRmsDisplay[channel], outputClip);
         }
         else
         {
-            inputMeterRight.setLevels(inputPeakDisplay[channel], inputRmsDisplay[channel], inputClip);
-            outputMeterRight.setLevels(outputPeakDisplay[channel], outputRmsDisplay[channel], outputClip);
+            global.inputMeterRight.setLevels(inputPeakDisplay[channel], inputRmsDisplay[channel], inputClip);
+            global.outputMeterRight.setLevels(outputPeakDisplay[channel], outputRmsDisplay[channel], outputClip);
         }
     }
 
@@ -355,13 +645,13 @@ void DustboxEditor::updateMeters()
 
         if (channel == 0)
         {
-            inputMeterLeft.setLevels(0.0f, 0.0f, false);
-            outputMeterLeft.setLevels(0.0f, 0.0f, false);
+            global.inputMeterLeft.setLevels(0.0f, 0.0f, false);
+            global.outputMeterLeft.setLevels(0.0f, 0.0f, false);
         }
         else
         {
-            inputMeterRight.setLevels(0.0f, 0.0f, false);
-            outputMeterRight.setLevels(0.0f, 0.0f, false);
+            global.inputMeterRight.setLevels(0.0f, 0.0f, false);
+            global.outputMeterRight.setLevels(0.0f, 0.0f, false);
         }
     }
 
@@ -370,7 +660,25 @@ void DustboxEditor::updateMeters()
     else if (clipHoldCounter > 0)
         --clipHoldCounter;
 
-    clipIndicator.setText(clipHoldCounter > 0 ? "CLIP" : juce::String(), juce::dontSendNotification);
+    global.clipIndicator.setText(clipHoldCounter > 0 ? "CLIP" : juce::String(), juce::dontSendNotification);
+}
+
+void DustboxEditor::updateQualityStatus()
+{
+    juce::String text;
+    switch (processor.getQualityTier())
+    {
+        case dsp::QualityTier::minimal:  text = "Minimal quality"; break;
+        case dsp::QualityTier::reduced:  text = "Reduced quality"; break;
+        case dsp::QualityTier::standard: text = "Standard quality"; break;
+        case dsp::QualityTier::high:     text = "Offline high quality"; break;
+    }
+
+    // Offline renders have no deadline, so there is no load worth showing.
+    if (processor.getQualityTier() != dsp::QualityTier::high)
+        text << " - CPU " << juce::roundToInt(100.0f * processor.getCpuLoad()) << " %";
+
+    globalSection->qualityStatus.setText(text, juce::dontSendNotification);
 }
 
 void DustboxEditor::updateTempoDisplay()
@@ -380,7 +688,7 @@ void DustboxEditor::updateTempoDisplay()
     const auto& hostTempo = processor.getHostTempo();
     const double bpm = hostTempo.getBpm();
     const double phase = hostTempo.getPhase01(clampedIndex);
-    tempoDisplay.setTempo(bpm, noteDivisionLabels[static_cast<size_t>(clampedIndex)], phase);
+    pumpSection->tempoDisplay.setTempo(bpm, noteDivisionLabels[static_cast<size_t>(clampedIndex)], phase);
 }
 
 void DustboxEditor::layoutGroupFlex(ui::GroupContainer& group,
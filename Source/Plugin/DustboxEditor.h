@@ -16,6 +16,7 @@
 
 #include <array>
 #include <atomic>
+#include <memory>
 
 namespace dustbox
 {
@@ -27,13 +28,26 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+    /** Builds controls and attachments if they have not been created yet. Called
+        automatically on first show; exposed so headless tools can force it. */
+    void ensureSectionsBuilt();
+    bool areSectionsBuilt() const noexcept { return tapeSection != nullptr; }
 
 private:
+    struct TapeSection;
+    struct DirtSection;
+    struct PumpSection;
+    struct MorphSection;
+    struct GlobalSection;
+
     void timerCallback() override;
-    void initialiseControls();
-    void initialiseAttachments();
     void refreshPresetCombo();
+    void refreshRoutingCombo();
     void updateMeters();
+    void updateQualityStatus();
     void updateTempoDisplay();
     void layoutGroupFlex(ui::GroupContainer& group,
                          const juce::Array<juce::Component*>& components,
@@ -45,59 +59,23 @@ private:
     ui::GroupContainer tapeGroup;
     ui::GroupContainer dirtGroup;
     ui::GroupContainer pumpGroup;
+    ui::GroupContainer morphGroup;
     ui::GroupContainer globalGroup;
 
-    ui::LabeledSlider tapeWowDepth;
-    ui::LabeledSlider tapeWowRate;
-    ui::LabeledSlider tapeFlutterDepth;
-    ui::LabeledSlider tapeToneLowpass;
-    ui::LabeledSlider tapeNoiseLevel;
-    ui::LabeledComboBox noiseRouting;
-
-    ui::LabeledSlider dirtSaturation;
-    ui::LabeledSlider dirtBitDepth;
-    ui::LabeledSlider dirtSampleRateDiv;
-
-    ui::LabeledSlider pumpAmount;
-    ui::LabeledComboBox pumpSyncNote;
-    ui::LabeledSlider pumpPhase;
-    ui::HostTempoDisplay tempoDisplay;
-
-    ui::LabeledSlider mixWet;
-    ui::LabeledSlider outputGain;
-    ui::LabeledToggleButton hardBypass;
-    ui::LabeledComboBox presetSelector;
-
-    ui::LevelMeter inputMeterLeft;
-    ui::LevelMeter inputMeterRight;
-    ui::LevelMeter outputMeterLeft;
-    ui::LevelMeter outputMeterRight;
-    juce::Label inputMeterLabel;
-    juce::Label outputMeterLabel;
-    juce::Label clipIndicator;
-
-    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
-    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
-    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
-
-    std::unique_ptr<SliderAttachment> tapeWowDepthAttachment;
-    std::unique_ptr<SliderAttachment> tapeWowRateAttachment;
-    std::unique_ptr<SliderAttachment> tapeFlutterAttachment;
-    std::unique_ptr<SliderAttachment> tapeToneAttachment;
-    std::unique_ptr<SliderAttachment> tapeNoiseLevelAttachment;
-    std::unique_ptr<ComboBoxAttachment> noiseRoutingAttachment;
-
-    std::unique_ptr<SliderAttachment> dirtSaturationAttachment;
-    std::unique_ptr<SliderAttachment> dirtBitDepthAttachment;
-    std::unique_ptr<SliderAttachment> dirtSampleRateAttachment;
-
-    std::unique_ptr<SliderAttachment> pumpAmountAttachment;
-    std::unique_ptr<ComboBoxAttachment> pumpSyncAttachment;
-    std::unique_ptr<SliderAttachment> pumpPhaseAttachment;
-
-    std::unique_ptr<SliderAttachment> mixWetAttachment;
-    std::unique_ptr<SliderAttachment> outputGainAttachment;
-    std::unique_ptr<ButtonAttachment> hardBypassAttachment;
+    // Profiling is off until toggled; the overlay sits over the groups while it is on.
+    juce::TextButton profileButton { "Profile" };
+    ui::ProfilerOverlay profilerOverlay;
+
+    // Records the host session (without audio) for replay in the benchmark runner.
+    juce::TextButton captureButton { "Capture" };
+
+    // Sections are created on first show so opening many instances (or hosts that
+    // construct editors speculatively) does not pay for every control and attachment.
+    std::unique_ptr<TapeSection> tapeSection;
+    std::unique_ptr<DirtSection> dirtSection;
+    std::unique_ptr<PumpSection> pumpSection;
+    std::unique_ptr<MorphSection> morphSection;
+    std::unique_ptr<GlobalSection> globalSection;
 
     std::atomic<float>* pumpSyncParameter { nullptr };
 
@@ -107,6 +85,6 @@ private:
     std::array<float, 2> outputRmsDisplay { 0.0f, 0.0f };
     int clipHoldCounter { 0 };
     bool updatingPresetSelection { false };
+    uint32_t shownPresetGeneration { 0 }; // Processor preset-list generation the combo was filled from.
 };
 } // namespace dustbox
-
@@ -12,13 +12,16 @@
 #include "DustboxProcessor.h"
 
 #include "DustboxEditor.h"
+#include "../Parameters/BinaryState.h"
 #include "../Parameters/ParameterIDs.h"
 #include "../Parameters/ParameterLayout.h"
+#include "../Parameters/ParameterRanges.h"
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 #include <array>
 #include <cmath>
+#include <type_traits>
 #include <utility>
 
 #include "../Dsp/utils/MathHelpers.h"
@@ -29,97 +32,338 @@ namespace dustbox
 namespace
 {
 constexpr size_t maxProcessChannels = 16;
+constexpr int latencyPollHz = 20;
+constexpr int presetPollIntervalTicks = latencyPollHz; // The preset library file is checked once a second.
 
-enum class NoiseRouting
+// Buses of this width and above are split into stereo lanes that can run on the worker pool.
+constexpr int minChannelsForLanes = 6;
+constexpr int channelsPerWideLane = 2;
+constexpr int maxLaneWorkers = 3;
+
+// Input widths isBusesLayoutSupported() accepts: mono, stereo, 5.1, 7.1 and 7.1.4.
+constexpr std::array<int, 5> supportedChannelCounts { 1, 2, 6, 8, 12 };
+
+constexpr double programFadeSeconds = 0.003;
+constexpr double morphRampSeconds = 0.02;
+
+// High-tier settings: parameters and the morph are re-evaluated this often instead of once per
+// host block, and Dirt oversamples at least 4x.
+constexpr int highQualityControlInterval = 32;
+constexpr int highQualityOversamplingStages = 2;
+
+// cpuBudget choices as fractions of the block deadline; zero leaves the governor off.
+constexpr std::array<float, 4> cpuBudgetFractions { 0.0f, 0.1f, 0.25f, 0.5f };
+constexpr int maxGovernorReduction = 2; // standard -> reduced -> minimal
+constexpr uint32_t routingChunkTag = 0x54524244u; // "DBRT"
+
+dsp::QualityTier getGovernedTier(int reduction) noexcept
 {
-    PreTape = 0,
-    PostTape,
-    Parallel
-};
+    return static_cast<dsp::QualityTier>(static_cast<int>(dsp::QualityTier::standard)
+                                         - juce::jlimit(0, maxGovernorReduction, reduction));
+}
 
-struct ProcessorSuspender
+/** Caps the latency-bearing Dirt settings for the governor's tiers; other tiers pass through. */
+dsp::DirtParameters limitDirtForTier(dsp::DirtParameters params, dsp::QualityTier tier) noexcept
 {
-    explicit ProcessorSuspender(DustboxProcessor& processorIn) : processor(processorIn)
+    if (tier == dsp::QualityTier::minimal)
     {
-        if (! processor.isSuspended())
-        {
-            processor.suspendProcessing(true);
-            suspended = true;
-        }
+        params.oversamplingStages = 0;
+        params.resamplerQuality = dsp::ResamplerQuality::fast;
     }
-
-    ~ProcessorSuspender()
+    else if (tier == dsp::QualityTier::reduced)
     {
-        if (suspended)
-            processor.suspendProcessing(false);
+        params.oversamplingStages = juce::jmin(params.oversamplingStages, 1);
+        if (params.resamplerQuality == dsp::ResamplerQuality::high)
+            params.resamplerQuality = dsp::ResamplerQuality::balanced;
     }
 
-private:
-    DustboxProcessor& processor;
-    bool suspended { false };
-};
+    return params;
+}
+
+bool dirtDiffersBetweenTiers(const dsp::DirtParameters& params, dsp::QualityTier first, dsp::QualityTier second) noexcept
+{
+    const auto a = limitDirtForTier(params, first);
+    const auto b = limitDirtForTier(params, second);
+    return a.oversamplingStages != b.oversamplingStages
+           || (params.targetSampleRate > 0.0 && a.resamplerQuality != b.resamplerQuality);
+}
 }
 
 DustboxProcessor::DustboxProcessor()
     : juce::AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
                                               .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      valueTreeState(*this, nullptr, "DustboxParameters", params::createParameterLayout())
+      valueTreeState(*this, nullptr, "DustboxParameters", params::createParameterLayout(factoryPresets->getPresetNames()))
+{
+    for (size_t index = 0; index < params::numParameters; ++index)
+    {
+        const auto* id = params::parameterIdsByIndex[index];
+        parametersByIndex[index] = valueTreeState.getParameter(id);
+        rawParameterValues[index] = valueTreeState.getRawParameterValue(id);
+        jassert(parametersByIndex[index] != nullptr && rawParameterValues[index] != nullptr);
+
+        // The embeddable library ranges and defaults parameters from this table instead of the layout.
+        const auto& range = params::parameterRanges[index];
+        const auto& layoutRange = parametersByIndex[index]->getNormalisableRange();
+        juce::ignoreUnused(range, layoutRange);
+        jassert(juce::approximatelyEqual(layoutRange.start, range.minValue)
+                && (params::isMorphSource(static_cast<params::ParameterIndex>(index)) || juce::approximatelyEqual(layoutRange.end, range.maxValue))
+                && juce::approximatelyEqual(parametersByIndex[index]->convertFrom0to1(parametersByIndex[index]->getDefaultValue()), range.defaultValue));
+    }
+
+    stageProfiler.setTraceRecorder(traceRecorder.get(), traceInstance);
+    reserveLanes<float>(1);
+    activeRoutingPlan = routingGraph.compile<float>(1, 0, 0);
+    startTimerHz(latencyPollHz);
+}
+
+DustboxProcessor::~DustboxProcessor()
 {
-    initialiseFactoryPresets();
+    stopTimer();
+    lanePool.stop();
+    collectRetiredRoutingPlan();
+    std::unique_ptr<dsp::RoutingPlan> pending { incomingRoutingPlan.exchange(nullptr, std::memory_order_acq_rel) };
 }
 
 void DustboxProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    const TraceRecorder::ScopedSpan traceSpan { *traceRecorder, "prepareToPlay", traceInstance };
+
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
-    const auto numChannels = getTotalNumInputChannels();
+    // Hosts announce offline rendering before preparing, so latency-changing upgrades are safe here.
+    preparedQualityTier = isNonRealtime() ? dsp::QualityTier::high : dsp::QualityTier::standard;
+    qualityTier.store(preparedQualityTier, std::memory_order_relaxed);
+
+    // A fresh start gets the user's settings back; the governor re-learns the load.
+    cpuGovernor.reset();
+    governedTier = dsp::QualityTier::standard;
+    requestedGovernedTier = dsp::QualityTier::standard;
+    cpuLoad.store(0.0f, std::memory_order_relaxed);
 
-    tapeModule.prepare(sampleRate, samplesPerBlock, numChannels);
-    noiseModule.prepare(sampleRate, samplesPerBlock, numChannels);
-    dirtModule.prepare(sampleRate, samplesPerBlock, numChannels);
-    pumpModule.prepare(sampleRate, samplesPerBlock, numChannels);
+    const auto numChannels = getTotalNumInputChannels();
 
-    dryBuffer.setSize(numChannels, samplesPerBlock);
-    dryBuffer.clear();
+    // The host fixes the precision before preparing; the other precision's lanes go idle but are
+    // kept, so switching back does not allocate.
+    if (isUsingDoublePrecision())
+    {
+        prepareLanes<double>(sampleRate, samplesPerBlock, numChannels);
+        floatState.numActiveLanes = 0;
+    }
+    else
+    {
+        prepareLanes<float>(sampleRate, samplesPerBlock, numChannels);
+        doubleState.numActiveLanes = 0;
+    }
 
     wetMixSmoother.reset(sampleRate, 30.0f);
     outputGainSmoother.reset(sampleRate, 30.0f);
 
     bypassSmoother.reset(sampleRate, 0.002);
-    updateParameters();
+
+    // prepareToPlay runs on the same thread as setCurrentProgram, so any requested program has
+    // already reached the APVTS and can be taken without a fade.
+    programSnapshots.acquire();
+    handledProgramChange = programChangeRequests.load(std::memory_order_acquire);
+    programTransition = ProgramTransition::idle;
+    programDryHoldSamples = 0;
+    programChangeFade.reset(sampleRate, programFadeSeconds);
+    programChangeFade.setCurrentAndTargetValue(0.0f);
+
+    morphPositionSmoother.reset(sampleRate, morphRampSeconds);
+    morphPositionSmoother.setCurrentAndTargetValue(rawParameterValues[params::toIndex(params::ParameterIndex::morphPosition)]->load());
+
+    // Audio is stopped here, so a pending plan goes in directly. The plan is only recompiled when
+    // its scratch does not cover the new layout, which never happens within reserved capacity.
+    collectRetiredRoutingPlan();
+    if (auto* pendingPlan = incomingRoutingPlan.exchange(nullptr, std::memory_order_acq_rel))
+        activeRoutingPlan.reset(pendingPlan);
+
+    const bool planCoversLayout = isUsingDoublePrecision()
+                                      ? activeRoutingPlan->covers<double>(numLanes, channelsPerLane, samplesPerBlock)
+                                      : activeRoutingPlan->covers<float>(numLanes, channelsPerLane, samplesPerBlock);
+    if (! planCoversLayout)
+        activeRoutingPlan = compileRoutingPlan();
+
+    updateParameters(0);
+
+    // Reported directly while stopped; changes during playback are picked up by timerCallback().
+    const auto latency = getWetPathLatency();
+    wetPathLatency.store(latency, std::memory_order_relaxed);
+    setLatencySamples(latency);
+
     wetMixSmoother.setImmediate(cachedParameters.wetMix);
     outputGainSmoother.setImmediate(cachedParameters.outputGain);
     bypassSmoother.setCurrentAndTargetValue(cachedParameters.hardBypass ? 1.0f : 0.0f);
 
-    tapeModule.reset();
-    noiseModule.reset();
-    dirtModule.reset();
-    pumpModule.reset();
+    auto resetLanes = [](auto& state)
+    {
+        state.forEachActiveLane([](auto& lane)
+        {
+            lane.tape.reset();
+            lane.noise.reset();
+            lane.dirt.reset();
+            lane.pump.reset();
+        });
+    };
+    resetLanes(floatState);
+    resetLanes(doubleState);
+
+    // Only the active precision's delay was just carved; the other one's memory is stale.
+    if (isUsingDoublePrecision())
+        doubleState.dryDelay.setDelay(latency);
+    else
+        floatState.dryDelay.setDelay(latency);
 
     bypassTransitionActive = false;
+
+    sessionCapture.recordPrepare({ sampleRate, samplesPerBlock, numChannels, isNonRealtime(), isUsingDoublePrecision(), getRouting() });
 }
 
 void DustboxProcessor::releaseResources()
 {
-    dryBuffer.setSize(0, 0);
-    noiseModule.reset();
+    sessionCapture.recordRelease();
+
+    // Reserved capacity outlives play/stop cycles; idle workers are parked on their semaphores.
+    if (reservedBlockSize > 0)
+        return;
+
+    lanePool.stop();
+
+    // Module and dry buffers all point into the arena; the next prepareToPlay carves them again.
+    floatState.dryBuffer.setSize(0, 0);
+    doubleState.dryBuffer.setSize(0, 0);
+    arena.release();
+}
+
+void DustboxProcessor::reserveCapacity(double maxSampleRate, int maxBlockSize, int maxChannels)
+{
+    jassert(maxSampleRate > 0.0 && maxBlockSize > 0 && maxChannels > 0);
+
+    // Double-precision state is never smaller than float, and the lane split makes the size
+    // uneven in the channel count, so take the largest of every supported width up to the limit.
+    size_t arenaBytes = 0;
+    reservedLayout = { 0, 0 };
+    for (const auto numChannels : supportedChannelCounts)
+    {
+        if (numChannels > maxChannels)
+            break;
+
+        const auto layout = getLaneLayout(numChannels);
+        reservedLayout.numLanes = juce::jmax(reservedLayout.numLanes, layout.numLanes);
+        reservedLayout.channelsPerLane = juce::jmax(reservedLayout.channelsPerLane, layout.channelsPerLane);
+        arenaBytes = juce::jmax(arenaBytes, getArenaBytes<double>(maxSampleRate, maxBlockSize, numChannels));
+    }
+
+    // Growing the arena invalidates everything carved from it; prepareToPlay carves it again.
+    arena.reserve(arenaBytes);
+    reserveLanes<float>(reservedLayout.numLanes);
+    reserveLanes<double>(reservedLayout.numLanes);
+    reservedBlockSize = maxBlockSize;
+
+    reservedWorkers = getNumLaneWorkers(reservedLayout.numLanes);
+    if (reservedWorkers > 0)
+        lanePool.start(reservedWorkers, maxSampleRate, maxBlockSize);
+
+    // A change of precision still recompiles the plan, since it only holds one precision's scratch.
+    collectRetiredRoutingPlan();
+    std::unique_ptr<dsp::RoutingPlan> stalePlan { incomingRoutingPlan.exchange(nullptr, std::memory_order_acq_rel) };
+    activeRoutingPlan = compileRoutingPlan();
 }
 
 bool DustboxProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
+    const auto& input = layouts.getMainInputChannelSet();
+    const auto& output = layouts.getMainOutputChannelSet();
+
     auto mono = juce::AudioChannelSet::mono();
     auto stereo = juce::AudioChannelSet::stereo();
-    return (layouts.getMainInputChannelSet() == mono || layouts.getMainInputChannelSet() == stereo)
-           && (layouts.getMainOutputChannelSet() == mono || layouts.getMainOutputChannelSet() == stereo);
+    if ((input == mono || input == stereo) && (output == mono || output == stereo))
+        return true;
+
+    // Surround buses are processed channel for channel, so input and output must match.
+    return input == output
+           && (input == juce::AudioChannelSet::create5point1() || input == juce::AudioChannelSet::create7point1()
+               || input == juce::AudioChannelSet::create7point1point4());
 }
 
 void DustboxProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processTimedBlock(buffer);
+}
+
+void DustboxProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processTimedBlock(buffer);
+}
+
+template <typename SampleType>
+void DustboxProcessor::processTimedBlock(juce::AudioBuffer<SampleType>& buffer)
+{
+    // Empty blocks (VST3 parameter flushes) carry no audio; before prepareToPlay there is nowhere
+    // to put any.
+    const auto numSamples = buffer.getNumSamples();
+    const auto maxSliceSamples = getPrecisionState<SampleType>().dryBuffer.getNumSamples();
+    if (numSamples == 0 || maxSliceSamples == 0)
+        return;
+
+    const ScopedRealtimeSection realtimeSection;
+    if (sessionCapture.isCapturing())
+        sessionCapture.recordBlock(captureParameterValues(), getPlayHead(), buffer, getTotalNumInputChannels());
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    stageProfiler.beginBlock(startTicks);
+
+    if (numSamples <= maxSliceSamples)
+        processBlockWithPrecision(buffer);
+    else
+        processInSlices(buffer, maxSliceSamples);
+
+    const auto endTicks = juce::Time::getHighResolutionTicks();
+    updateCpuGovernor(endTicks - startTicks, numSamples);
+    stageProfiler.endBlock(endTicks, numSamples / currentSampleRate);
+}
 
+template <typename SampleType>
+void DustboxProcessor::processInSlices(juce::AudioBuffer<SampleType>& buffer, int maxSliceSamples)
+{
+    // Some hosts send more samples than they announced in prepareToPlay. Those blocks run as
+    // prepared-size views into the host buffer instead of overrunning the module buffers.
+    auto& slice = getPrecisionState<SampleType>().sliceView;
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(maxProcessChannels));
+    jassert(buffer.getNumChannels() <= static_cast<int>(maxProcessChannels));
+
+    std::array<SampleType*, maxProcessChannels> pointers {};
+    for (int offset = 0; offset < numSamples; offset += maxSliceSamples)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            pointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel, offset);
+
+        slice.setDataToReferTo(pointers.data(), numChannels, juce::jmin(maxSliceSamples, numSamples - offset));
+        processBlockWithPrecision(slice);
+    }
+}
+
+template <typename SampleType>
+DustboxProcessor::PrecisionState<SampleType>& DustboxProcessor::getPrecisionState() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, double>)
+        return doubleState;
+    else
+        return floatState;
+}
+
+template <typename SampleType>
+void DustboxProcessor::processBlockWithPrecision(juce::AudioBuffer<SampleType>& buffer)
+{
     dsp::DenormalGuard guard;
 
+    auto& state = getPrecisionState<SampleType>();
+    auto& dryBuffer = state.dryBuffer;
+
     const auto numSamples = buffer.getNumSamples();
     const auto totalNumInputChannels = getTotalNumInputChannels();
     const auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -130,12 +374,44 @@ void DustboxProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     jassert(dryBuffer.getNumChannels() == totalNumInputChannels);
     jassert(numSamples <= dryBuffer.getNumSamples());
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        dryBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+    {
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::dryCopy };
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            dryBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+    }
+
+    // The governor only steers realtime blocks. A tier change that leaves Dirt's filters alone
+    // applies here; one that rebuilds them waits for advanceProgramTransition() to dip to dry.
+    const auto offline = isNonRealtime();
+    requestedGovernedTier = offline ? dsp::QualityTier::standard : getGovernedTier(cpuGovernor.getReduction());
+    if (requestedGovernedTier != governedTier
+        && ! dirtDiffersBetweenTiers(cachedParameters.requestedDirtParams, governedTier, requestedGovernedTier))
+        governedTier = requestedGovernedTier;
+
+    advanceProgramTransition(numSamples);
+
+    // Latency-neutral upgrades follow the host's render mode from this block on.
+    const auto tier = offline ? dsp::QualityTier::high : governedTier;
+    qualityTier.store(tier, std::memory_order_relaxed);
+    const auto controlInterval = tier == dsp::QualityTier::high ? juce::jmin(numSamples, highQualityControlInterval) : numSamples;
+
+    // While fading out for a program change the old values stay frozen; the APVTS already holds the new ones.
+    if (programTransition != ProgramTransition::fadingOut)
+        updateParameters(controlInterval);
+
+    const auto latency = getWetPathLatency();
+    wetPathLatency.store(latency, std::memory_order_relaxed);
 
-    updateParameters();
+    {
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::dryCopy };
+        state.dryDelay.setDelay(latency);
+        state.dryDelay.process(dryBuffer, numSamples);
+    }
 
-    publishMeterReadings(dryBuffer, inputMeterValues, totalNumInputChannels, numSamples);
+    {
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::metering };
+        publishMeterReadings(dryBuffer, inputMeterValues, totalNumInputChannels, numSamples);
+    }
 
     const float bypassTarget = cachedParameters.hardBypass ? 1.0f : 0.0f;
     if (bypassSmoother.getTargetValue() != bypassTarget)
@@ -151,75 +427,106 @@ void DustboxProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
                                     && juce::approximatelyEqual(bypassSmoother.getCurrentValue(), 1.0f);
     if (bypassFullyEngaged)
     {
-        publishMeterReadings(dryBuffer, outputMeterValues, totalNumInputChannels, numSamples);
+        // Bypassed output keeps the reported latency, so hosts do not see the timing jump.
+        {
+            const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::bypass };
+            if (state.dryDelay.getDelay() > 0)
+                for (int channel = 0; channel < totalNumInputChannels; ++channel)
+                    buffer.copyFrom(channel, 0, dryBuffer, channel, 0, numSamples);
+        }
+
+        programChangeFade.skip(numSamples);
+
+        {
+            const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::metering };
+            publishMeterReadings(dryBuffer, outputMeterValues, totalNumInputChannels, numSamples);
+        }
+
         hostTempo.advanceFallbackPhase(numSamples, currentSampleRate, syncNoteIndex);
         return;
     }
 
     const auto samplesPerCycle = hostTempo.getSamplesPerCycle(currentSampleRate, syncNoteIndex);
-    pumpModule.setSync(samplesPerCycle, cachedParameters.pumpParams.phaseOffset);
+    state.forEachActiveLane([&](auto& lane) { lane.pump.setSync(samplesPerCycle, cachedParameters.pumpParams.phaseOffset); });
 
-    noiseModule.generate(numSamples);
-    const auto& noise = noiseModule.getNoiseBuffer();
-    const auto noiseChannels = juce::jmin(noise.getNumChannels(), buffer.getNumChannels());
-    const auto noiseRouting = static_cast<NoiseRouting>(cachedParameters.noiseRoutingIndex);
+    jassert(totalNumInputChannels == state.numActiveLanes * channelsPerLane);
+    jassert(totalNumInputChannels <= static_cast<int>(maxProcessChannels));
+    std::array<const SampleType*, maxProcessChannels> dryPointers {};
+    std::array<SampleType*, maxProcessChannels> wetPointers {};
 
-    if (noiseRouting == NoiseRouting::PreTape)
+    for (int channel = 0; channel < totalNumInputChannels; ++channel)
     {
-        for (int channel = 0; channel < noiseChannels; ++channel)
-            buffer.addFrom(channel, 0, noise, channel, 0, numSamples);
+        dryPointers[static_cast<size_t>(channel)] = dryBuffer.getReadPointer(channel);
+        wetPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
     }
 
-    tapeModule.processBlock(buffer, numSamples);
-
-    if (noiseRouting == NoiseRouting::PostTape)
+    // The wet path runs in control-interval chunks: the whole block normally, a few dozen samples
+    // offline, with fresh parameters and morph values for every chunk after the first.
+    for (int offset = 0; offset < numSamples; offset += controlInterval)
     {
-        for (int channel = 0; channel < noiseChannels; ++channel)
-            buffer.addFrom(channel, 0, noise, channel, 0, numSamples);
-    }
+        const auto chunkSamples = juce::jmin(controlInterval, numSamples - offset);
+        if (offset > 0 && programTransition != ProgramTransition::fadingOut)
+            updateParameters(chunkSamples);
 
-    dirtModule.processBlock(buffer, numSamples);
-    pumpModule.processBlock(buffer, numSamples);
+        state.blockBuffer = &buffer;
+        laneBlockOffset = offset;
+        laneBlockSamples = chunkSamples;
+        lanePool.run(numLanes, &DustboxProcessor::runLaneTask<SampleType>, this);
 
-    wetMixSmoother.setTarget(cachedParameters.wetMix);
-    outputGainSmoother.setTarget(cachedParameters.outputGain);
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::mix };
+        wetMixSmoother.setTarget(cachedParameters.wetMix);
+        outputGainSmoother.setTarget(cachedParameters.outputGain);
 
-    jassert(totalNumInputChannels <= static_cast<int>(maxProcessChannels));
-    std::array<const float*, maxProcessChannels> dryPointers {};
-    std::array<float*, maxProcessChannels> wetPointers {};
-    std::array<const float*, maxProcessChannels> noisePointers {};
+        // Custom routings that place noise themselves take it out of the parallel path.
+        const bool noiseParallel = cachedParameters.noisePlacement == dsp::NoisePlacement::parallel
+                                   && ! activeRoutingPlan->placesNoise();
+        std::array<const SampleType*, maxProcessChannels> noisePointers {};
 
-    const bool noiseParallel = noiseRouting == NoiseRouting::Parallel;
+        if (noiseParallel)
+        {
+            state.forEachActiveLane([&](const auto& lane)
+            {
+                const auto& noise = lane.noise.getNoiseBuffer();
+                for (int channel = 0; channel < noise.getNumChannels(); ++channel)
+                    noisePointers[static_cast<size_t>(lane.firstChannel + channel)] = noise.getReadPointer(channel);
+            });
+        }
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        dryPointers[static_cast<size_t>(channel)] = dryBuffer.getReadPointer(channel);
-        wetPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
-        if (noiseParallel && channel < noiseChannels)
-            noisePointers[static_cast<size_t>(channel)] = noise.getReadPointer(channel);
+        // Noise buffers hold only this chunk, so they are indexed from zero.
+        for (int chunkSample = 0; chunkSample < chunkSamples; ++chunkSample)
+        {
+            const auto sample = offset + chunkSample;
+            const auto gains = dsp::equalPowerMixGains(wetMixSmoother.getNextValue());
+            const auto dryGain = static_cast<SampleType>(gains.dry);
+            const auto wetGain = static_cast<SampleType>(gains.wet);
+            const auto outputGain = static_cast<SampleType>(outputGainSmoother.getNextValue());
+
+            for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            {
+                const auto channelIndex = static_cast<size_t>(channel);
+                const auto drySample = dryPointers[channelIndex][sample];
+                const auto wetSample = wetPointers[channelIndex][sample];
+                auto mixed = (drySample * dryGain + wetSample * wetGain) * outputGain;
+
+                if (noiseParallel && noisePointers[channelIndex] != nullptr)
+                    mixed += noisePointers[channelIndex][chunkSample] * outputGain;
+
+                wetPointers[channelIndex][sample] = mixed;
+            }
+        }
     }
 
-    for (int sample = 0; sample < numSamples; ++sample)
     {
-        const auto gains = dsp::equalPowerMixGains(wetMixSmoother.getNextValue());
-        const auto outputGain = outputGainSmoother.getNextValue();
-
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        {
-            const auto channelIndex = static_cast<size_t>(channel);
-            const float drySample = dryPointers[channelIndex][sample];
-            const float wetSample = wetPointers[channelIndex][sample];
-            auto mixed = (drySample * gains.dry + wetSample * gains.wet) * outputGain;
-
-            if (noiseParallel && noisePointers[channelIndex] != nullptr)
-                mixed += noisePointers[channelIndex][sample] * outputGain;
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::bypass };
+        applyBypassRamp(buffer, dryBuffer, numSamples);
+        applyProgramCrossfade(buffer, dryBuffer, numSamples);
+    }
 
-            wetPointers[channelIndex][sample] = mixed;
-        }
+    {
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::metering };
+        publishMeterReadings(buffer, outputMeterValues, totalNumOutputChannels, numSamples);
     }
-    applyBypassRamp(buffer, numSamples);
 
-    publishMeterReadings(buffer, outputMeterValues, totalNumOutputChannels, numSamples);
     hostTempo.advanceFallbackPhase(numSamples, currentSampleRate, syncNoteIndex);
 }
 
@@ -230,12 +537,12 @@ juce::AudioProcessorEditor* DustboxProcessor::createEditor()
 
 int DustboxProcessor::getNumPrograms()
 {
-    return static_cast<int>(factoryPresets.size());
+    return factoryPresets->size() + userPresets->size();
 }
 
 int DustboxProcessor::getCurrentProgram()
 {
-    if (factoryPresets.empty())
+    if (getNumPrograms() == 0)
         return 0;
 
     return juce::jlimit(0, getNumPrograms() - 1, currentProgramIndex);
@@ -243,33 +550,49 @@ int DustboxProcessor::getCurrentProgram()
 
 void DustboxProcessor::setCurrentProgram(int index)
 {
-    if (factoryPresets.empty())
+    if (getNumPrograms() == 0)
         return;
 
+    const TraceRecorder::ScopedSpan traceSpan { *traceRecorder, "setCurrentProgram", traceInstance };
     const int clamped = juce::jlimit(0, getNumPrograms() - 1, index);
-    const auto& preset = factoryPresets[static_cast<size_t>(clamped)];
-    const bool needsUpdate = ! preset.state.isEquivalentTo(valueTreeState.state);
+    const int numFactoryPresets = factoryPresets->size();
+    const auto current = captureParameterValues();
+
+    // Presets leave the morph controls alone, so the target is the live state with the
+    // preset-stored entries replaced.
+    auto values = current;
+    if (clamped < numFactoryPresets)
+        factoryPresets->mergePresetValues(clamped, values);
+    else if (! userPresets->readValues(clamped - numFactoryPresets, values))
+        return;
 
-    if (needsUpdate)
+    if (! presets::parameterValuesMatch(values, current))
     {
-        ProcessorSuspender suspend(*this);
-        valueTreeState.replaceState(preset.state.createCopy());
+        // Order matters: the request freezes the audio thread's parameters before the APVTS
+        // changes, and the snapshot is only published once the APVTS is consistent with it.
+        const auto sequence = programChangeRequests.fetch_add(1, std::memory_order_acq_rel) + 1;
+        applyParameterValues(values);
+
+        auto& snapshot = programSnapshots.getWriteBuffer();
+        snapshot.values = values;
+        snapshot.sequence = sequence;
+        programSnapshots.publish();
     }
 
     currentProgramIndex = clamped;
-
-    if (needsUpdate)
-        updateParameters();
-
     updateHostDisplay();
 }
 
 const juce::String DustboxProcessor::getProgramName(int index)
 {
-    if (index < 0 || index >= getNumPrograms() || factoryPresets.empty())
+    if (index < 0 || index >= getNumPrograms())
         return {};
 
-    return factoryPresets[static_cast<size_t>(index)].name;
+    const int numFactoryPresets = factoryPresets->size();
+    if (index < numFactoryPresets)
+        return factoryPresets->getPreset(index).name;
+
+    return userPresets->getName(index - numFactoryPresets);
 }
 
 void DustboxProcessor::changeProgramName(int, const juce::String&)
@@ -277,16 +600,212 @@ void DustboxProcessor::changeProgramName(int, const juce::String&)
     // Factory presets are immutable; hosts may request a rename but we ignore it.
 }
 
+bool DustboxProcessor::saveUserPreset(const juce::String& name, const juce::StringArray& tags)
+{
+    presets::UserPreset preset { name, tags, captureParameterValues() };
+    if (! userPresets->append(preset))
+        return false;
+
+    currentProgramIndex = getNumPrograms() - 1;
+    notifiedPresetGeneration = userPresets->getGeneration();
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return true;
+}
+
+DustboxProcessor::LaneLayout DustboxProcessor::getLaneLayout(int numChannels) noexcept
+{
+    if (numChannels >= minChannelsForLanes && numChannels % channelsPerWideLane == 0)
+        return { numChannels / channelsPerWideLane, channelsPerWideLane };
+
+    return { 1, numChannels };
+}
+
+int DustboxProcessor::getNumLaneWorkers(int numLanes) noexcept
+{
+    // The host thread takes a share of the lanes itself, and one spare core is left for the host.
+    return juce::jmax(0, juce::jmin(numLanes - 1, maxLaneWorkers, juce::SystemStats::getNumCpus() - 1));
+}
+
+template <typename SampleType>
+size_t DustboxProcessor::getArenaBytes(double sampleRate, int samplesPerBlock, int numChannels) noexcept
+{
+    using Lane = ProcessingLane<SampleType>;
+    const auto layout = getLaneLayout(numChannels);
+    const auto laneBytes = Lane::Tape::getArenaBytes(sampleRate, layout.channelsPerLane)
+                           + Lane::Noise::getArenaBytes(samplesPerBlock, layout.channelsPerLane)
+                           + Lane::Dirt::getArenaBytes(sampleRate, samplesPerBlock, layout.channelsPerLane);
+    const auto maxLatency = Lane::Dirt::getMaxLatencySamples(sampleRate);
+
+    // One block for the whole instance: the dry copy and its delay first, then each lane's state.
+    return dsp::DspArena::bytesForBuffer<SampleType>(numChannels, samplesPerBlock)
+           + dsp::LatencyDelay<SampleType>::getArenaBytes(maxLatency, numChannels)
+           + static_cast<size_t>(layout.numLanes) * laneBytes;
+}
+
+template <typename SampleType>
+void DustboxProcessor::reserveLanes(int count)
+{
+    // Lane objects are never destroyed, so a layout that needs fewer simply leaves some idle.
+    auto& lanes = getPrecisionState<SampleType>().lanes;
+    while (static_cast<int>(lanes.size()) < count)
+        lanes.push_back(std::make_unique<ProcessingLane<SampleType>>(stageProfiler));
+}
+
+template <typename SampleType>
+void DustboxProcessor::prepareLanes(double sampleRate, int samplesPerBlock, int numChannels)
+{
+    const auto layout = getLaneLayout(numChannels);
+    numLanes = layout.numLanes;
+    channelsPerLane = layout.channelsPerLane;
+
+    // Within reserved capacity this only rewinds, and the carving below only zeroes what it uses.
+    arena.reserve(getArenaBytes<SampleType>(sampleRate, samplesPerBlock, numChannels));
+
+    auto& state = getPrecisionState<SampleType>();
+    arena.allocateBuffer(state.dryBuffer, numChannels, samplesPerBlock);
+    state.dryDelay.prepare(ProcessingLane<SampleType>::Dirt::getMaxLatencySamples(sampleRate), numChannels, arena);
+
+    reserveLanes<SampleType>(numLanes);
+    state.numActiveLanes = numLanes;
+    for (int index = 0; index < numLanes; ++index)
+    {
+        auto& lane = *state.lanes[static_cast<size_t>(index)];
+        lane.firstChannel = index * channelsPerLane;
+        lane.tape.prepare(sampleRate, samplesPerBlock, channelsPerLane, arena);
+        lane.noise.prepare(sampleRate, samplesPerBlock, channelsPerLane, arena, lane.firstChannel);
+        lane.dirt.prepare(sampleRate, samplesPerBlock, channelsPerLane, arena);
+        lane.pump.prepare(sampleRate, samplesPerBlock, channelsPerLane);
+    }
+
+    // Reserved workers stay up even for narrower layouts; a participant without a lane returns at once.
+    const auto numWorkers = juce::jmax(getNumLaneWorkers(numLanes), reservedWorkers);
+    if (numWorkers > 0)
+        lanePool.start(numWorkers, sampleRate, samplesPerBlock);
+    else
+        lanePool.stop();
+}
+
+template <typename SampleType>
+void DustboxProcessor::runLaneTask(void* context, int laneIndex) noexcept
+{
+    static_cast<DustboxProcessor*>(context)->processLane<SampleType>(laneIndex);
+}
+
+template <typename SampleType>
+void DustboxProcessor::processLane(int laneIndex) noexcept
+{
+    auto& state = getPrecisionState<SampleType>();
+    auto& lane = *state.lanes[static_cast<size_t>(laneIndex)];
+    const auto numSamples = laneBlockSamples;
+
+    // Refers to the host's channel pointers; fewer than 32 channels never allocates.
+    lane.view.setDataToReferTo(state.blockBuffer->getArrayOfWritePointers() + lane.firstChannel,
+                               channelsPerLane,
+                               laneBlockOffset,
+                               numSamples);
+
+    {
+        const dsp::ScopedStageTimer timer { stageProfiler, dsp::ProfiledStage::noise };
+        lane.noise.generate(numSamples);
+    }
+
+    if (activeRoutingPlan->followsParameters())
+        lane.graph.process(cachedParameters.moduleOrder, cachedParameters.noisePlacement, lane.view, numSamples);
+    else
+        activeRoutingPlan->process(laneIndex, lane.timedTape, lane.timedDirt, lane.timedPump, lane.noise, lane.view, numSamples);
+}
+
+bool DustboxProcessor::setRouting(const juce::String& description)
+{
+    dsp::RoutingGraph graph;
+    if (! dsp::RoutingGraph::parse(description, graph))
+        return false;
+
+    if (graph.toString() == routingGraph.toString())
+        return true;
+
+    routingGraph = std::move(graph);
+
+    // Before the first prepareToPlay the plan is built there, once the block size is known.
+    if (currentBlockSize > 0)
+        publishRoutingPlan(compileRoutingPlan());
+
+    return true;
+}
+
+std::unique_ptr<dsp::RoutingPlan> DustboxProcessor::compileRoutingPlan() const
+{
+    // Sized for the reserved capacity as well, so later re-prepares can keep the plan.
+    const auto lanes = juce::jmax(numLanes, reservedLayout.numLanes);
+    const auto channels = juce::jmax(channelsPerLane, reservedLayout.channelsPerLane);
+    const auto blockSize = juce::jmax(currentBlockSize, reservedBlockSize);
+
+    if (isUsingDoublePrecision())
+        return routingGraph.compile<double>(lanes, channels, blockSize);
+
+    return routingGraph.compile<float>(lanes, channels, blockSize);
+}
+
+void DustboxProcessor::publishRoutingPlan(std::unique_ptr<dsp::RoutingPlan> plan)
+{
+    // A plan the audio thread has not picked up yet is simply replaced.
+    std::unique_ptr<dsp::RoutingPlan> superseded { incomingRoutingPlan.exchange(plan.release(), std::memory_order_acq_rel) };
+
+    // Emptied after publishing: the audio thread waits for a free retired slot before swapping,
+    // and at most one swap can happen between this and the next publish.
+    collectRetiredRoutingPlan();
+}
+
+void DustboxProcessor::collectRetiredRoutingPlan()
+{
+    std::unique_ptr<dsp::RoutingPlan> retired { retiredRoutingPlan.exchange(nullptr, std::memory_order_acq_rel) };
+}
+
+bool DustboxProcessor::startSessionCapture(const juce::File& file, bool includeAudio)
+{
+    // A capture started mid-playback opens with the running prepare, so replay can begin there.
+    const capture::PrepareInfo current { currentSampleRate, currentBlockSize, getTotalNumInputChannels(),
+                                         isNonRealtime(), isUsingDoublePrecision(), getRouting() };
+    return sessionCapture.start(file, includeAudio, currentBlockSize > 0 ? &current : nullptr);
+}
+
 void DustboxProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // JUCE 7 exposed copyState(); JUCE 8 made it non-const, so grab the ValueTree directly.
-    auto state = valueTreeState.state;
-    if (auto xml = state.createXml())
-        copyXmlToBinary(*xml, destData);
+    params::writeBinaryState(captureParameterValues(), destData);
+
+    if (! routingGraph.followsParameters())
+    {
+        const auto routing = routingGraph.toString();
+        params::appendBinaryStateChunk(destData, routingChunkTag, routing.toRawUTF8(), routing.getNumBytesAsUTF8());
+    }
 }
 
 void DustboxProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    const TraceRecorder::ScopedSpan traceSpan { *traceRecorder, "setStateInformation", traceInstance };
+
+    if (params::hasBinaryStateMagic(data, sizeInBytes))
+    {
+        // Entries the blob does not carry keep their current values, matching replaceState().
+        auto values = captureParameterValues();
+        if (params::readBinaryState(data, sizeInBytes, values) < 0)
+            return;
+
+        applyParameterValues(values);
+
+        size_t routingBytes = 0;
+        const auto* routing = params::findBinaryStateChunk(data, sizeInBytes, routingChunkTag, routingBytes);
+        setRouting(routing != nullptr ? juce::String::fromUTF8(static_cast<const char*>(routing), static_cast<int>(routingBytes))
+                                      : juce::String());
+
+        const auto match = factoryPresets->findMatchingPreset(values);
+        if (match >= 0)
+            currentProgramIndex = match;
+
+        return;
+    }
+
+    // Legacy sessions stored the APVTS ValueTree as XML.
     if (auto xml = getXmlFromBinary(data, sizeInBytes))
     {
         auto restoredState = juce::ValueTree::fromXml(*xml);
@@ -296,51 +815,286 @@ void DustboxProcessor::setStateInformation(const void* data, int sizeInBytes)
 
         // JUCE 8 prefers replaceState with an explicit ValueTree instead of copyState round-trips.
         valueTreeState.replaceState(restoredState);
+        setRouting({});
 
-        if (! factoryPresets.empty())
-        {
-            const auto match = findPresetIndexMatchingState(restoredState);
-            if (match >= 0)
-                currentProgramIndex = match;
-        }
+        const auto match = factoryPresets->findMatchingPreset(captureParameterValues());
+        if (match >= 0)
+            currentProgramIndex = match;
+    }
+}
+
+void DustboxProcessor::timerCallback()
+{
+    // Polled rather than triggered: posting a message from the audio thread takes the message
+    // queue's lock.
+    const auto latency = wetPathLatency.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    // Another process may have saved presets; another instance's saves show up as a new generation.
+    if (++presetPollTicks >= presetPollIntervalTicks)
+    {
+        presetPollTicks = 0;
+        userPresets->refreshIfChanged();
+    }
+
+    if (userPresets->getGeneration() != notifiedPresetGeneration)
+    {
+        notifiedPresetGeneration = userPresets->getGeneration();
+        updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    }
+}
+
+int DustboxProcessor::getWetPathLatency() const noexcept
+{
+    if (! activeRoutingPlan->runsDirt())
+        return 0;
+
+    return dsp::DirtModule<float>::getLatencySamples(cachedParameters.dirtParams, currentSampleRate);
+}
+
+void DustboxProcessor::updateCpuGovernor(juce::int64 elapsedTicks, int numSamples) noexcept
+{
+    // Offline renders have no deadline; a later realtime pass starts from the user's settings.
+    if (isNonRealtime() || numSamples <= 0)
+    {
+        cpuGovernor.reset();
+        cpuLoad.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+    const auto blockSeconds = numSamples / currentSampleRate;
+
+    // Only Dirt's filters are worth shedding, so without them in play the governor just measures.
+    const auto canReduce = activeRoutingPlan->runsDirt()
+                           && dirtDiffersBetweenTiers(cachedParameters.requestedDirtParams,
+                                                      dsp::QualityTier::standard,
+                                                      dsp::QualityTier::minimal);
+
+    cpuGovernor.setBudget(cachedParameters.cpuBudget);
+    cpuGovernor.addBlock(elapsedSeconds, blockSeconds, canReduce ? maxGovernorReduction : 0);
+    cpuLoad.store(static_cast<float>(cpuGovernor.getLoad()), std::memory_order_relaxed);
+}
+
+void DustboxProcessor::updateParameters(int numSamples)
+{
+    auto values = captureParameterValues();
+
+    if (traceRecorder->isRecording())
+        traceParameterChanges(values);
+
+    applyPresetMorph(values, numSamples);
+    applyParameterSnapshot(values);
+}
+
+void DustboxProcessor::traceParameterChanges(const params::ParameterValues& values) noexcept
+{
+    // Automation bursts show up as a counter track: how many parameters moved since the last block.
+    int changes = 0;
+    for (size_t index = 0; index < params::numParameters; ++index)
+        changes += juce::exactlyEqual(values[index], tracedParameterValues[index]) ? 0 : 1;
+
+    tracedParameterValues = values;
+
+    if (changes != tracedParameterChanges)
+    {
+        traceRecorder->counter("parameter changes", traceInstance, static_cast<float>(changes));
+        tracedParameterChanges = changes;
     }
 }
 
-void DustboxProcessor::updateParameters()
+void DustboxProcessor::applyPresetMorph(params::ParameterValues& values, int numSamples) noexcept
 {
-    auto getFloat = [this](const char* id) {
-        return valueTreeState.getRawParameterValue(id)->load();
+    using P = params::ParameterIndex;
+    auto getChoice = [&values](P index) {
+        return static_cast<int>(values[params::toIndex(index)]);
     };
-    auto getChoice = [this](const char* id) {
-        return static_cast<int>(valueTreeState.getRawParameterValue(id)->load());
+
+    const auto position = values[params::toIndex(P::morphPosition)];
+    const auto mode = getChoice(P::morphMode);
+    const auto numSources = mode == 2 ? 4 : (mode == 1 ? 2 : 0);
+
+    if (numSources == 0)
+    {
+        morphPositionSmoother.setCurrentAndTargetValue(position);
+        return;
+    }
+
+    const presets::PresetMorphEngine::SourceIndices sourceIndices {
+        getChoice(P::morphPresetA), getChoice(P::morphPresetB), getChoice(P::morphPresetC), getChoice(P::morphPresetD)
     };
 
-    cachedParameters.tapeParams.wowDepth = getFloat(params::ids::tapeWowDepth);
-    cachedParameters.tapeParams.wowRateHz = getFloat(params::ids::tapeWowRateHz);
-    cachedParameters.tapeParams.flutterDepth = getFloat(params::ids::tapeFlutterDepth);
-    cachedParameters.tapeParams.toneLowpassHz = getFloat(params::ids::tapeToneLowpassHz);
-    tapeModule.setParameters(cachedParameters.tapeParams);
+    // Recompiling copies at most four preset vectors, so it is cheap enough to do inline.
+    if (numSources != morphEngine.getNumSources() || sourceIndices != morphEngine.getSourceIndices())
+        morphEngine.setSources(*factoryPresets, sourceIndices, numSources);
+
+    morphPositionSmoother.setTargetValue(position);
+    morphPositionSmoother.skip(numSamples);
+    morphEngine.evaluate(morphPositionSmoother.getCurrentValue(), values);
+}
 
-    cachedParameters.noiseParams.levelDb = getFloat(params::ids::tapeNoiseLevelDb);
-    cachedParameters.noiseRoutingIndex = juce::jlimit(0, 2, getChoice(params::ids::noiseRouting));
-    noiseModule.setParameters(cachedParameters.noiseParams);
+void DustboxProcessor::applyParameterSnapshot(const params::ParameterValues& values) noexcept
+{
+    using P = params::ParameterIndex;
+    auto getFloat = [&values](P index) {
+        return values[params::toIndex(index)];
+    };
+    auto getChoice = [&values](P index) {
+        return static_cast<int>(values[params::toIndex(index)]);
+    };
 
-    cachedParameters.dirtParams.saturationAmount = getFloat(params::ids::dirtSaturationAmt);
-    cachedParameters.dirtParams.bitDepth = getChoice(params::ids::dirtBitDepthBits);
-    cachedParameters.dirtParams.sampleRateDiv = getChoice(params::ids::dirtSampleRateDiv);
-    dirtModule.setParameters(cachedParameters.dirtParams);
+    cachedParameters.tapeParams.wowDepth = getFloat(P::tapeWowDepth);
+    cachedParameters.tapeParams.wowRateHz = getFloat(P::tapeWowRateHz);
+    cachedParameters.tapeParams.flutterDepth = getFloat(P::tapeFlutterDepth);
+    cachedParameters.tapeParams.toneLowpassHz = getFloat(P::tapeToneLowpassHz);
+
+    cachedParameters.noiseParams.levelDb = getFloat(P::tapeNoiseLevelDb);
+    cachedParameters.noisePlacement = static_cast<dsp::NoisePlacement>(juce::jlimit(0, 2, getChoice(P::noiseRouting)));
+
+    cachedParameters.dirtParams.saturationAmount = getFloat(P::dirtSaturationAmt);
+    cachedParameters.dirtParams.bitDepth = getChoice(P::dirtBitDepthBits);
+    cachedParameters.dirtParams.sampleRateDiv = getChoice(P::dirtSampleRateDiv);
+    cachedParameters.dirtParams.targetSampleRate =
+        dsp::dirtTargetSampleRates[static_cast<size_t>(juce::jlimit(0, static_cast<int>(dsp::dirtTargetSampleRates.size()) - 1, getChoice(P::dirtTargetRate)))];
+    cachedParameters.dirtParams.resamplerQuality = static_cast<dsp::ResamplerQuality>(juce::jlimit(0, 2, getChoice(P::dirtResampleQuality)));
+    cachedParameters.dirtParams.oversamplingStages = juce::jlimit(0, dsp::oversampling::maxStages, getChoice(P::dirtOversampling));
+    cachedParameters.dirtParams.saturationMode = static_cast<dsp::SaturationMode>(juce::jlimit(0, 1, getChoice(P::dirtSaturationMode)));
+
+    cachedParameters.pumpParams.amount = getFloat(P::pumpAmount);
+    cachedParameters.pumpParams.syncNoteIndex = juce::jlimit(0, 2, getChoice(P::pumpSyncNote));
+    cachedParameters.pumpParams.phaseOffset = getFloat(P::pumpPhase);
+
+    // Offline renders trade CPU for quality. Settings that change latency follow the tier fixed at
+    // prepareToPlay, so the reported latency only moves when the host prepares again.
+    cachedParameters.tapeParams.interpolation = qualityTier.load(std::memory_order_relaxed) == dsp::QualityTier::high
+                                                    ? dsp::TapeInterpolation::cubic
+                                                    : dsp::TapeInterpolation::linear;
+
+    if (preparedQualityTier == dsp::QualityTier::high)
+    {
+        auto& dirtParams = cachedParameters.dirtParams;
+        dirtParams.oversamplingStages = juce::jmax(dirtParams.oversamplingStages, highQualityOversamplingStages);
+        dirtParams.resamplerQuality = dsp::ResamplerQuality::high;
+    }
 
-    cachedParameters.pumpParams.amount = getFloat(params::ids::pumpAmount);
-    cachedParameters.pumpParams.syncNoteIndex = juce::jlimit(0, 2, getChoice(params::ids::pumpSyncNote));
-    cachedParameters.pumpParams.phaseOffset = getFloat(params::ids::pumpPhase);
-    pumpModule.setParameters(cachedParameters.pumpParams);
+    // The governor caps Dirt's filters under CPU pressure and pads the capped path back to the
+    // latency of the requested settings, so the host's delay compensation stays valid.
+    auto& dirtParams = cachedParameters.dirtParams;
+    dirtParams.latencyCompensation = 0;
+    cachedParameters.requestedDirtParams = dirtParams;
 
-    cachedParameters.wetMix = getFloat(params::ids::mixWet);
-    cachedParameters.outputGain = juce::Decibels::decibelsToGain(getFloat(params::ids::outputGainDb));
-    cachedParameters.hardBypass = valueTreeState.getRawParameterValue(params::ids::hardBypass)->load() > 0.5f;
+    if (governedTier < dsp::QualityTier::standard)
+    {
+        const auto requestedLatency = dsp::DirtModule<float>::getLatencySamples(dirtParams, currentSampleRate);
+        dirtParams = limitDirtForTier(dirtParams, governedTier);
+        dirtParams.latencyCompensation = requestedLatency - dsp::DirtModule<float>::getLatencySamples(dirtParams, currentSampleRate);
+    }
+
+    auto updateLanes = [this](auto& state)
+    {
+        state.forEachActiveLane([this](auto& lane)
+        {
+            lane.tape.setParameters(cachedParameters.tapeParams);
+            lane.noise.setParameters(cachedParameters.noiseParams);
+            lane.dirt.setParameters(cachedParameters.dirtParams);
+            lane.pump.setParameters(cachedParameters.pumpParams);
+        });
+    };
+    updateLanes(floatState);
+    updateLanes(doubleState);
+
+    cachedParameters.wetMix = getFloat(P::mixWet);
+    cachedParameters.outputGain = juce::Decibels::decibelsToGain(getFloat(P::outputGainDb));
+    cachedParameters.hardBypass = getFloat(P::hardBypass) > 0.5f;
+    cachedParameters.moduleOrder = static_cast<dsp::ModuleOrder>(juce::jlimit(0, 2, getChoice(P::chainOrder)));
+    cachedParameters.cpuBudget =
+        cpuBudgetFractions[static_cast<size_t>(juce::jlimit(0, static_cast<int>(cpuBudgetFractions.size()) - 1, getChoice(P::cpuBudget)))];
 }
 
-void DustboxProcessor::applyBypassRamp(juce::AudioBuffer<float>& buffer, int numSamples)
+void DustboxProcessor::advanceProgramTransition(int numSamples) noexcept
+{
+    const auto requested = programChangeRequests.load(std::memory_order_acquire);
+    const auto programPending = requested != handledProgramChange;
+    const auto routingPending = incomingRoutingPlan.load(std::memory_order_acquire) != nullptr;
+    const auto tierPending = requestedGovernedTier != governedTier;
+
+    if ((programPending || routingPending || tierPending) && programTransition != ProgramTransition::fadingOut)
+    {
+        programTransition = ProgramTransition::fadingOut;
+        programChangeFade.setTargetValue(1.0f);
+    }
+
+    if (programTransition == ProgramTransition::fadingOut && ! programChangeFade.isSmoothing())
+    {
+        bool swapped = false;
+
+        // Fully dry: rebuilding Dirt's filters for the governor's tier cannot be heard here. A
+        // pending program brings its own values; otherwise the live ones are applied again.
+        if (tierPending)
+        {
+            governedTier = requestedGovernedTier;
+            if (! programPending)
+                updateParameters(0);
+            swapped = true;
+        }
+
+        // Swap at this block boundary once the matching snapshot has been published.
+        if (programPending)
+        {
+            programSnapshots.acquire();
+            const auto& snapshot = programSnapshots.getReadBuffer();
+
+            if (snapshot.sequence == requested)
+            {
+                auto values = snapshot.values;
+                applyPresetMorph(values, 0);
+                applyParameterSnapshot(values);
+                handledProgramChange = snapshot.sequence;
+                swapped = true;
+            }
+        }
+
+        // The message thread empties the retired slot right after publishing, so any wait is brief.
+        if (retiredRoutingPlan.load(std::memory_order_acquire) == nullptr)
+        {
+            if (auto* plan = incomingRoutingPlan.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                retiredRoutingPlan.store(activeRoutingPlan.release(), std::memory_order_release);
+                activeRoutingPlan.reset(plan);
+                swapped = true;
+            }
+        }
+
+        // Swapped-in filters and delay lines start from silence; staying dry until the wet path's
+        // latency has passed through them keeps the fade-in from starting on a step.
+        if (swapped)
+        {
+            programDryHoldSamples = getWetPathLatency();
+            traceRecorder->instant(tierPending ? "quality tier swap" : "program swap", traceInstance);
+        }
+
+        if (handledProgramChange == requested && incomingRoutingPlan.load(std::memory_order_acquire) == nullptr)
+        {
+            if (programDryHoldSamples > 0)
+            {
+                programDryHoldSamples -= numSamples;
+            }
+            else
+            {
+                programTransition = ProgramTransition::fadingIn;
+                programChangeFade.setTargetValue(0.0f);
+            }
+        }
+    }
+    else if (programTransition == ProgramTransition::fadingIn && ! programChangeFade.isSmoothing())
+    {
+        programTransition = ProgramTransition::idle;
+    }
+}
+
+template <typename SampleType>
+void DustboxProcessor::applyBypassRamp(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& dry, int numSamples)
 {
     if (! bypassTransitionActive && ! cachedParameters.hardBypass)
         return;
@@ -350,24 +1104,24 @@ void DustboxProcessor::applyBypassRamp(juce::AudioBuffer<float>& buffer, int num
         return;
 
     jassert(numChannels <= static_cast<int>(maxProcessChannels));
-    std::array<const float*, maxProcessChannels> dryPointers {};
-    std::array<float*, maxProcessChannels> wetPointers {};
+    std::array<const SampleType*, maxProcessChannels> dryPointers {};
+    std::array<SampleType*, maxProcessChannels> wetPointers {};
 
     for (int channel = 0; channel < numChannels; ++channel)
     {
-        dryPointers[static_cast<size_t>(channel)] = dryBuffer.getReadPointer(channel);
+        dryPointers[static_cast<size_t>(channel)] = dry.getReadPointer(channel);
         wetPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
     }
 
     for (int sample = 0; sample < numSamples; ++sample)
     {
-        const float bypassValue = bypassSmoother.getNextValue();
+        const auto bypassValue = static_cast<SampleType>(bypassSmoother.getNextValue());
         for (int channel = 0; channel < numChannels; ++channel)
         {
             const auto channelIndex = static_cast<size_t>(channel);
-            const float drySample = dryPointers[channelIndex][sample];
+            const auto drySample = dryPointers[channelIndex][sample];
             auto& wetSample = wetPointers[channelIndex][sample];
-            wetSample = drySample * bypassValue + wetSample * (1.0f - bypassValue);
+            wetSample = drySample * bypassValue + wetSample * (static_cast<SampleType>(1) - bypassValue);
         }
     }
 
@@ -375,24 +1129,58 @@ void DustboxProcessor::applyBypassRamp(juce::AudioBuffer<float>& buffer, int num
         bypassTransitionActive = false;
 }
 
-void DustboxProcessor::initialiseFactoryPresets()
+template <typename SampleType>
+void DustboxProcessor::applyProgramCrossfade(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& dry, int numSamples)
+{
+    if (programTransition == ProgramTransition::idle && ! programChangeFade.isSmoothing())
+        return;
+
+    const auto numChannels = getTotalNumInputChannels();
+    if (numChannels == 0)
+        return;
+
+    jassert(numChannels <= static_cast<int>(maxProcessChannels));
+    std::array<const SampleType*, maxProcessChannels> dryPointers {};
+    std::array<SampleType*, maxProcessChannels> wetPointers {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        dryPointers[static_cast<size_t>(channel)] = dry.getReadPointer(channel);
+        wetPointers[static_cast<size_t>(channel)] = buffer.getWritePointer(channel);
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const auto dryAmount = static_cast<SampleType>(programChangeFade.getNextValue());
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto channelIndex = static_cast<size_t>(channel);
+            auto& wetSample = wetPointers[channelIndex][sample];
+            wetSample = dryPointers[channelIndex][sample] * dryAmount + wetSample * (static_cast<SampleType>(1) - dryAmount);
+        }
+    }
+}
+
+params::ParameterValues DustboxProcessor::captureParameterValues() const noexcept
 {
-    factoryPresets = presets::createFactoryPresets(valueTreeState);
-    currentProgramIndex = factoryPresets.empty() ? 0 : juce::jlimit(0, getNumPrograms() - 1, currentProgramIndex);
+    params::ParameterValues values {};
+    for (size_t index = 0; index < params::numParameters; ++index)
+        values[index] = rawParameterValues[index]->load();
+
+    return values;
 }
 
-int DustboxProcessor::findPresetIndexMatchingState(const juce::ValueTree& state) const
+void DustboxProcessor::applyParameterValues(const params::ParameterValues& values)
 {
-    for (size_t i = 0; i < factoryPresets.size(); ++i)
+    for (size_t index = 0; index < params::numParameters; ++index)
     {
-        if (state.isEquivalentTo(factoryPresets[i].state))
-            return static_cast<int>(i);
+        auto* parameter = parametersByIndex[index];
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(values[index]));
     }
-
-    return -1;
 }
 
-void DustboxProcessor::publishMeterReadings(const juce::AudioBuffer<float>& buffer,
+template <typename SampleType>
+void DustboxProcessor::publishMeterReadings(const juce::AudioBuffer<SampleType>& buffer,
                                             std::array<MeterReadings, meterChannelCount>& storage,
                                             int numChannels,
                                             int numSamples)
@@ -408,7 +1196,7 @@ void DustboxProcessor::publishMeterReadings(const juce::AudioBuffer<float>& buff
 
         for (int sample = 0; sample < numSamples; ++sample)
         {
-            const float sampleValue = data[sample];
+            const auto sampleValue = static_cast<float>(data[sample]);
             const float absValue = std::abs(sampleValue);
             peak = juce::jmax(peak, absValue);
             sumSquares += static_cast<double>(sampleValue) * static_cast<double>(sampleValue);
@@ -13,37 +13,60 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 
 #include "../Core/BuildConfig.h"
+#include "../Core/RealtimeSafety.h"
+#include "../Core/TraceRecorder.h"
 #include "../Core/Version.h"
 #include "../Dsp/modules/DirtModule.h"
 #include "../Dsp/modules/NoiseModule.h"
 #include "../Dsp/modules/PumpModule.h"
 #include "../Dsp/modules/TapeModule.h"
+#include "../Dsp/routing/ProcessingGraph.h"
+#include "../Dsp/routing/RoutingGraph.h"
+#include "../Dsp/utils/CpuGovernor.h"
+#include "../Dsp/utils/DspArena.h"
+#include "../Dsp/utils/LaneWorkerPool.h"
+#include "../Dsp/utils/LatencyDelay.h"
 #include "../Dsp/utils/ParameterSmoother.h"
+#include "../Dsp/utils/QualityTier.h"
+#include "../Dsp/utils/StageProfiler.h"
+#include "../Dsp/utils/TripleBuffer.h"
+#include "../Parameters/ParameterIndex.h"
 #include "../Presets/FactoryPresets.h"
+#include "../Presets/PresetMorph.h"
+#include "../Presets/UserPresetLibrary.h"
 #include "HostTempo.h"
+#include "SessionCapture.h"
 #include "../Dsp/utils/DenormalGuard.h"
 
 #include <array>
 #include <atomic>
+#include <memory>
 #include <vector>
 
 namespace dustbox
 {
 class DustboxEditor;
 
-class DustboxProcessor : public juce::AudioProcessor
+class DustboxProcessor : public juce::AudioProcessor, private juce::Timer
 {
 public:
     DustboxProcessor();
-    ~DustboxProcessor() override = default;
+    ~DustboxProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
 
+    /** Reserves memory, lanes, worker threads and routing scratch for every layout up to these
+        limits, in either precision, so later prepareToPlay calls within them only reconfigure
+        and never allocate. Message thread, before prepareToPlay; releaseResources keeps it. */
+    void reserveCapacity(double maxSampleRate, int maxBlockSize, int maxChannels);
+
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -68,11 +91,43 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    /** Parses and installs a routing such as "noise > tape | dirt > pump" ("default" follows the
+        chainOrder/noiseRouting parameters). The new plan crossfades in; message thread only. */
+    bool setRouting(const juce::String& description);
+    juce::String getRouting() const { return routingGraph.toString(); }
+
+    /** Appends the current settings to the shared user preset library; message thread only. */
+    bool saveUserPreset(const juce::String& name, const juce::StringArray& tags);
+    /** Changes whenever the user presets, and so the program names, may have changed. */
+    uint32_t getPresetListGeneration() const noexcept { return userPresets->getGeneration(); }
+
     juce::AudioProcessorValueTreeState& getValueTreeState() noexcept { return valueTreeState; }
     const juce::AudioProcessorValueTreeState& getValueTreeState() const noexcept { return valueTreeState; }
 
     const HostTempo& getHostTempo() const noexcept { return hostTempo; }
 
+    /** High while the host renders offline (isNonRealtime()). Latency-changing upgrades follow the
+        tier seen at the last prepareToPlay; the rest switch at the next block boundary. In realtime,
+        the CPU governor drops to the reduced or minimal tier while the cpuBudget is exceeded. */
+    dsp::QualityTier getQualityTier() const noexcept { return qualityTier.load(std::memory_order_relaxed); }
+    /** Tape read-head interpolation of the last block: cubic at the high tier, linear otherwise.
+        Read it on the audio thread or while no block is running. */
+    dsp::TapeInterpolation getTapeInterpolation() const noexcept { return cachedParameters.tapeParams.interpolation; }
+    /** Smoothed share of the realtime deadline processBlock takes; 1 is the whole block. */
+    float getCpuLoad() const noexcept { return cpuLoad.load(std::memory_order_relaxed); }
+
+    /** Per-stage processBlock timers, off until enabled (the editor's profiling overlay does). */
+    dsp::StageProfiler& getStageProfiler() noexcept { return stageProfiler; }
+    /** The process-wide trace recorder; while it records, this instance writes its stage timings,
+        prepareToPlay, program and state changes and per-block parameter churn to the trace. */
+    TraceRecorder& getTraceRecorder() noexcept { return *traceRecorder; }
+
+    /** Records prepare/release calls, block sizes, parameter values, playhead and (optionally) input
+        audio to file for replay; see SessionCapture. Message thread. */
+    bool startSessionCapture(const juce::File& file, bool includeAudio);
+    void stopSessionCapture() { sessionCapture.stop(); }
+    bool isCapturingSession() const noexcept { return sessionCapture.isCapturing(); }
+
     size_t getMeterChannelCount() const noexcept;
     float getInputPeakLevel(size_t channel) const noexcept;
     float getInputRmsLevel(size_t channel) const noexcept;
@@ -91,52 +146,238 @@ private:
 
     static constexpr size_t meterChannelCount = 2;
 
-    void updateParameters();
-    void applyBypassRamp(juce::AudioBuffer<float>& buffer, int numSamples);
-    void initialiseFactoryPresets();
-    int findPresetIndexMatchingState(const juce::ValueTree& state) const;
-    void publishMeterReadings(const juce::AudioBuffer<float>& buffer,
+    /** Parameter values for a host program change, tagged with the request they answer. */
+    struct ProgramSnapshot
+    {
+        params::ParameterValues values {};
+        uint32_t sequence { 0 };
+    };
+
+    enum class ProgramTransition
+    {
+        idle,
+        fadingOut,
+        fadingIn
+    };
+
+    /** One independent group of channels with its own module state. Wide buses are split into
+        stereo lanes so the lanes can run on the worker pool; narrower ones use a single lane. */
+    template <typename SampleType>
+    struct ProcessingLane
+    {
+        using Tape = dsp::TapeModule<SampleType>;
+        using Noise = dsp::NoiseModule<SampleType>;
+        using Dirt = dsp::DirtModule<SampleType>;
+        using Pump = dsp::PumpModule<SampleType>;
+
+        explicit ProcessingLane(dsp::StageProfiler& profiler) noexcept
+            : timedTape(tape, profiler, dsp::ProfiledStage::tape)
+            , timedDirt(dirt, profiler, dsp::ProfiledStage::dirt)
+            , timedPump(pump, profiler, dsp::ProfiledStage::pump)
+        {
+        }
+
+        Tape tape;
+        Noise noise;
+        Dirt dirt;
+        Pump pump;
+
+        // The graph and custom plans run the modules through these, so each is timed on its own.
+        dsp::TimedModule<Tape> timedTape;
+        dsp::TimedModule<Dirt> timedDirt;
+        dsp::TimedModule<Pump> timedPump;
+        dsp::ProcessingGraph<dsp::TimedModule<Tape>, dsp::TimedModule<Dirt>, dsp::TimedModule<Pump>, Noise> graph {
+            timedTape, timedDirt, timedPump, noise
+        };
+
+        juce::AudioBuffer<SampleType> view; // Refers to the lane's channels of the host buffer.
+        int firstChannel { 0 };
+    };
+
+    /** Lanes and dry copy for one processing precision. Only the precision the host selected
+        before prepareToPlay has active lanes; lane objects beyond those are kept for reuse. */
+    template <typename SampleType>
+    struct PrecisionState
+    {
+        template <typename Function>
+        void forEachActiveLane(Function&& function)
+        {
+            for (int index = 0; index < numActiveLanes; ++index)
+                function(*lanes[static_cast<size_t>(index)]);
+        }
+
+        std::vector<std::unique_ptr<ProcessingLane<SampleType>>> lanes;
+        int numActiveLanes { 0 };
+        juce::AudioBuffer<SampleType> dryBuffer;
+        dsp::LatencyDelay<SampleType> dryDelay; // Keeps dry and bypassed audio aligned with the wet path.
+        juce::AudioBuffer<SampleType>* blockBuffer { nullptr }; // Read by lane tasks on the pool.
+        juce::AudioBuffer<SampleType> sliceView; // Refers into host blocks larger than the prepared size.
+    };
+
+    struct LaneLayout
+    {
+        int numLanes { 1 };
+        int channelsPerLane { 0 };
+    };
+
+    static LaneLayout getLaneLayout(int numChannels) noexcept;
+    static int getNumLaneWorkers(int numLanes) noexcept;
+    template <typename SampleType>
+    static size_t getArenaBytes(double sampleRate, int samplesPerBlock, int numChannels) noexcept;
+
+    template <typename SampleType>
+    PrecisionState<SampleType>& getPrecisionState() noexcept;
+
+    template <typename SampleType>
+    void processTimedBlock(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void processInSlices(juce::AudioBuffer<SampleType>& buffer, int maxSliceSamples);
+    template <typename SampleType>
+    void processBlockWithPrecision(juce::AudioBuffer<SampleType>& buffer);
+
+    void timerCallback() override;
+    int getWetPathLatency() const noexcept;
+    void updateCpuGovernor(juce::int64 elapsedTicks, int numSamples) noexcept;
+
+    void updateParameters(int numSamples);
+    void traceParameterChanges(const params::ParameterValues& values) noexcept;
+    void applyPresetMorph(params::ParameterValues& values, int numSamples) noexcept;
+    void applyParameterSnapshot(const params::ParameterValues& values) noexcept;
+    void advanceProgramTransition(int numSamples) noexcept;
+    template <typename SampleType>
+    void prepareLanes(double sampleRate, int samplesPerBlock, int numChannels);
+    template <typename SampleType>
+    void reserveLanes(int count);
+    template <typename SampleType>
+    static void runLaneTask(void* context, int laneIndex) noexcept;
+    template <typename SampleType>
+    void processLane(int laneIndex) noexcept;
+    std::unique_ptr<dsp::RoutingPlan> compileRoutingPlan() const;
+    void publishRoutingPlan(std::unique_ptr<dsp::RoutingPlan> plan);
+    void collectRetiredRoutingPlan();
+    template <typename SampleType>
+    void applyBypassRamp(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& dry, int numSamples);
+    template <typename SampleType>
+    void applyProgramCrossfade(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& dry, int numSamples);
+    params::ParameterValues captureParameterValues() const noexcept;
+    void applyParameterValues(const params::ParameterValues& values);
+    template <typename SampleType>
+    void publishMeterReadings(const juce::AudioBuffer<SampleType>& buffer,
                               std::array<MeterReadings, meterChannelCount>& storage,
                               int numChannels,
                               int numSamples);
 
+    // One immutable table per process, reference-counted across instances. Declared before the
+    // APVTS because the morph source parameters list the preset names.
+    juce::SharedResourcePointer<presets::FactoryPresetTable> factoryPresets;
+
     juce::AudioProcessorValueTreeState valueTreeState;
 
-    dsp::TapeModule tapeModule;
-    dsp::NoiseModule noiseModule;
-    dsp::DirtModule dirtModule;
-    dsp::PumpModule pumpModule;
-    dsp::ParameterSmoother wetMixSmoother;
-    dsp::ParameterSmoother outputGainSmoother;
+    // User presets follow the factory presets in the host program list. The mapped library is
+    // shared by every instance in the process and only touched from the message thread.
+    juce::SharedResourcePointer<presets::UserPresetLibrary> userPresets;
+    uint32_t notifiedPresetGeneration { userPresets->getGeneration() };
+    int presetPollTicks { 0 };
 
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> bypassSmoother;
+    // Backs the dry buffer and every lane's module buffers; carved in prepareToPlay.
+    dsp::DspArena arena;
+    PrecisionState<float> floatState;
+    PrecisionState<double> doubleState;
+    int numLanes { 1 };
+    int channelsPerLane { 0 };
+    int laneBlockOffset { 0 };
+    int laneBlockSamples { 0 };
+    dsp::LaneWorkerPool lanePool;
+    dsp::StageProfiler stageProfiler;
+
+    // Shared by every instance in the process; each instance is its own process track in the trace.
+    // tracedParameterValues is audio-thread only and only kept up to date while recording.
+    juce::SharedResourcePointer<TraceRecorder> traceRecorder;
+    const int traceInstance { traceRecorder->registerInstance() };
+    params::ParameterValues tracedParameterValues {};
+    int tracedParameterChanges { -1 };
 
-    juce::AudioBuffer<float> dryBuffer;
+    SessionCapture sessionCapture;
+
+    // Limits from reserveCapacity(); zero when nothing is reserved.
+    LaneLayout reservedLayout { 0, 0 };
+    int reservedBlockSize { 0 };
+    int reservedWorkers { 0 };
+
+    // Gains are control values shared by both precisions.
+    dsp::ParameterSmoother<float> wetMixSmoother;
+    dsp::ParameterSmoother<float> outputGainSmoother;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> bypassSmoother;
 
     HostTempo hostTempo;
 
+    // Latency follows the Dirt oversampling setting. The audio thread notices a change at a block
+    // boundary and the message thread reports it to the host.
+    std::atomic<int> wetPathLatency { 0 };
+
     double currentSampleRate { 44100.0 };
     int currentBlockSize { 0 };
 
-    std::vector<presets::FactoryPreset> factoryPresets;
+    // Offline renders run the high tier. Written on the audio thread at block boundaries and in
+    // prepareToPlay; preparedQualityTier only changes in prepareToPlay.
+    std::atomic<dsp::QualityTier> qualityTier { dsp::QualityTier::standard };
+    dsp::QualityTier preparedQualityTier { dsp::QualityTier::standard };
+
+    // Realtime blocks are timed against their deadline. The governor's tier is requested at a block
+    // boundary; changes that rebuild Dirt's filters wait for the program-change dip to swap in.
+    dsp::CpuGovernor cpuGovernor;
+    dsp::QualityTier governedTier { dsp::QualityTier::standard };
+    dsp::QualityTier requestedGovernedTier { dsp::QualityTier::standard };
+    std::atomic<float> cpuLoad { 0.0f };
+
     int currentProgramIndex { 0 };
 
+    std::array<juce::RangedAudioParameter*, params::numParameters> parametersByIndex {};
+    std::array<std::atomic<float>*, params::numParameters> rawParameterValues {};
+
     std::array<MeterReadings, meterChannelCount> inputMeterValues {};
     std::array<MeterReadings, meterChannelCount> outputMeterValues {};
 
     struct CachedParameters
     {
-        dsp::TapeModule::Parameters tapeParams;
-        dsp::DirtModule::Parameters dirtParams;
-        dsp::PumpModule::Parameters pumpParams;
-        dsp::NoiseModule::Parameters noiseParams;
-        int noiseRoutingIndex { 1 };
+        dsp::TapeParameters tapeParams;
+        dsp::DirtParameters dirtParams;
+        dsp::DirtParameters requestedDirtParams; // dirtParams before the governor's caps.
+        dsp::PumpParameters pumpParams;
+        dsp::NoiseParameters noiseParams;
+        dsp::NoisePlacement noisePlacement { dsp::NoisePlacement::postTape };
+        dsp::ModuleOrder moduleOrder { dsp::ModuleOrder::tapeDirtPump };
         float wetMix { 0.5f };
         float outputGain { 1.0f };
         bool hardBypass { false };
+        float cpuBudget { 0.0f };
     } cachedParameters;
 
     bool bypassTransitionActive { false };
+
+    // Morphing overrides the preset-stored values per block without touching the APVTS; the
+    // position is ramped at block rate so automation steps do not jump whole presets.
+    presets::PresetMorphEngine morphEngine;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> morphPositionSmoother;
+
+    // Program changes: the message thread bumps programChangeRequests, pushes the new values to
+    // the APVTS, then publishes the snapshot. The audio thread freezes its cached parameters,
+    // dips to dry, swaps in the snapshot at a block boundary, and fades the wet path back in.
+    dsp::TripleBuffer<ProgramSnapshot> programSnapshots;
+    std::atomic<uint32_t> programChangeRequests { 0 };
+    uint32_t handledProgramChange { 0 };
+    ProgramTransition programTransition { ProgramTransition::idle };
+    int programDryHoldSamples { 0 }; // Fully dry samples still owed after a swap before fading in.
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> programChangeFade;
+
+    // Routing changes reuse the program-change dip: the message thread compiles a plan and hands
+    // it over through incomingRoutingPlan; the audio thread swaps it in while fully dry and hands
+    // the previous plan back through retiredRoutingPlan, which the message thread deletes later.
+    dsp::RoutingGraph routingGraph;
+    std::unique_ptr<dsp::RoutingPlan> activeRoutingPlan;
+    std::atomic<dsp::RoutingPlan*> incomingRoutingPlan { nullptr };
+    std::atomic<dsp::RoutingPlan*> retiredRoutingPlan { nullptr };
 };
 } // namespace dustbox
 
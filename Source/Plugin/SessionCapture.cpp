@@ -0,0 +1,582 @@
+/*
+  ==============================================================================
+  File: SessionCapture.cpp
+  Responsibility: Implement the capture ring, its background writer and the
+                  capture file reader.
+  Assumptions: The ring is single-producer/single-consumer over monotonically
+               increasing byte positions. A record becomes visible to the
+               writer only once it is complete, so the file never holds half a
+               record. stop() waits for a producer that saw capturing just
+               before it was cleared, so nothing writes into the ring after the
+               file is closed.
+  ==============================================================================
+*/
+
+#include "SessionCapture.h"
+
+#include <cstring>
+#include <thread>
+
+namespace dustbox
+{
+namespace
+{
+constexpr int flushIntervalMs = 50;
+constexpr size_t recordHeaderBytes = sizeof(uint8_t) + sizeof(uint32_t);
+constexpr size_t prepareBytes = sizeof(double) + 2 * sizeof(int32_t) + 2 * sizeof(uint8_t) + sizeof(uint32_t);
+constexpr size_t playHeadBytes = sizeof(uint8_t) + 2 * sizeof(double) + sizeof(int64_t) + 2 * sizeof(int32_t);
+
+template <typename Value>
+void writeValue(juce::OutputStream& stream, Value value)
+{
+    stream.write(&value, sizeof(Value));
+}
+
+size_t getPreparePayloadBytes(const capture::PrepareInfo& info) noexcept
+{
+    return prepareBytes + info.routing.getNumBytesAsUTF8();
+}
+
+/** Reads native-endian values out of one record's payload. */
+class PayloadReader
+{
+public:
+    PayloadReader(const juce::MemoryBlock& payloadToRead) : payload(payloadToRead) {}
+
+    template <typename Value>
+    bool read(Value& value)
+    {
+        if (offset + sizeof(Value) > payload.getSize())
+            return false;
+
+        std::memcpy(&value, static_cast<const uint8_t*>(payload.getData()) + offset, sizeof(Value));
+        offset += sizeof(Value);
+        return true;
+    }
+
+    bool readString(juce::String& value)
+    {
+        uint32_t numBytes = 0;
+        if (! read(numBytes) || offset + numBytes > payload.getSize())
+            return false;
+
+        value = juce::String::fromUTF8(static_cast<const char*>(payload.getData()) + offset, static_cast<int>(numBytes));
+        offset += numBytes;
+        return true;
+    }
+
+    bool readFloats(float* destination, size_t count)
+    {
+        if (offset + count * sizeof(float) > payload.getSize())
+            return false;
+
+        std::memcpy(destination, static_cast<const uint8_t*>(payload.getData()) + offset, count * sizeof(float));
+        offset += count * sizeof(float);
+        return true;
+    }
+
+private:
+    const juce::MemoryBlock& payload;
+    size_t offset { 0 };
+};
+} // namespace
+
+namespace capture
+{
+PlayHeadState PlayHeadState::fromPlayHead(juce::AudioPlayHead* playHead) noexcept
+{
+    PlayHeadState state;
+    if (playHead == nullptr)
+        return state;
+
+    const auto position = playHead->getPosition();
+    if (! position)
+        return state;
+
+    state.flags |= hasPosition;
+    if (position->getIsPlaying())
+        state.flags |= isPlaying;
+
+    if (const auto bpm = position->getBpm())
+    {
+        state.flags |= hasBpm;
+        state.bpm = *bpm;
+    }
+
+    if (const auto ppq = position->getPpqPosition())
+    {
+        state.flags |= hasPpq;
+        state.ppqPosition = *ppq;
+    }
+
+    if (const auto samples = position->getTimeInSamples())
+    {
+        state.flags |= hasTimeInSamples;
+        state.timeInSamples = *samples;
+    }
+
+    if (const auto signature = position->getTimeSignature())
+    {
+        state.flags |= hasTimeSignature;
+        state.timeSignatureNumerator = signature->numerator;
+        state.timeSignatureDenominator = signature->denominator;
+    }
+
+    return state;
+}
+
+juce::Optional<juce::AudioPlayHead::PositionInfo> PlayHeadState::toPositionInfo() const
+{
+    if ((flags & hasPosition) == 0)
+        return {};
+
+    juce::AudioPlayHead::PositionInfo info;
+    info.setIsPlaying((flags & isPlaying) != 0);
+
+    if ((flags & hasBpm) != 0)
+        info.setBpm(bpm);
+    if ((flags & hasPpq) != 0)
+        info.setPpqPosition(ppqPosition);
+    if ((flags & hasTimeInSamples) != 0)
+        info.setTimeInSamples(timeInSamples);
+    if ((flags & hasTimeSignature) != 0)
+        info.setTimeSignature(juce::AudioPlayHead::TimeSignature { timeSignatureNumerator, timeSignatureDenominator });
+
+    return info;
+}
+} // namespace capture
+
+/** Copies bytes into the ring at a running position, wrapping at the end. */
+class SessionCapture::RecordWriter
+{
+public:
+    RecordWriter(uint8_t* ringToWrite, uint64_t startPosition) noexcept
+        : ring(ringToWrite), position(startPosition)
+    {
+    }
+
+    template <typename Value>
+    void put(Value value) noexcept
+    {
+        putBytes(&value, sizeof(Value));
+    }
+
+    void putBytes(const void* data, size_t numBytes) noexcept
+    {
+        const auto offset = static_cast<size_t>(position & (ringCapacity - 1));
+        const auto firstPart = juce::jmin(numBytes, ringCapacity - offset);
+        std::memcpy(ring + offset, data, firstPart);
+        std::memcpy(ring, static_cast<const uint8_t*>(data) + firstPart, numBytes - firstPart);
+        position += numBytes;
+    }
+
+    uint64_t getPosition() const noexcept { return position; }
+
+private:
+    uint8_t* ring;
+    uint64_t position;
+};
+
+class SessionCapture::Writer : public juce::Thread
+{
+public:
+    Writer(SessionCapture& ownerCapture, std::unique_ptr<juce::FileOutputStream> streamToUse)
+        : juce::Thread("Dustbox session capture"), owner(ownerCapture), stream(std::move(streamToUse))
+    {
+    }
+
+    ~Writer() override { stopThread(1000); }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait(flushIntervalMs);
+        }
+    }
+
+    /** Stops the thread and writes what is left, then notes blocks dropped after the last record
+        that fitted, which no later record will carry. */
+    void finish(uint32_t trailingDroppedBlocks)
+    {
+        stopThread(1000);
+        drain();
+
+        if (trailingDroppedBlocks > 0)
+        {
+            writeValue(*stream, static_cast<uint8_t>(capture::RecordType::dropped));
+            writeValue(*stream, static_cast<uint32_t>(sizeof(uint32_t)));
+            writeValue(*stream, trailingDroppedBlocks);
+            stream->flush();
+        }
+    }
+
+private:
+    void drain()
+    {
+        const auto start = owner.readPosition.load(std::memory_order_relaxed);
+        const auto end = owner.writePosition.load(std::memory_order_acquire);
+        if (start == end)
+            return;
+
+        const auto offset = static_cast<size_t>(start & (ringCapacity - 1));
+        const auto numBytes = static_cast<size_t>(end - start);
+        const auto firstPart = juce::jmin(numBytes, ringCapacity - offset);
+        stream->write(owner.ring.get() + offset, firstPart);
+        stream->write(owner.ring.get(), numBytes - firstPart);
+        stream->flush();
+
+        owner.readPosition.store(end, std::memory_order_release);
+    }
+
+    SessionCapture& owner;
+    std::unique_ptr<juce::FileOutputStream> stream;
+};
+
+SessionCapture::SessionCapture() = default;
+
+SessionCapture::~SessionCapture()
+{
+    stop();
+}
+
+juce::File SessionCapture::getDefaultCaptureFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Dustbox")
+        .getChildFile("Captures")
+        .getNonexistentChildFile("Session-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S"), ".dbxcap");
+}
+
+bool SessionCapture::start(const juce::File& file, bool includeAudio, const capture::PrepareInfo* current)
+{
+    stop();
+
+    file.getParentDirectory().createDirectory();
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (! stream->openedOk())
+        return false;
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    if (ring == nullptr)
+        ring = std::make_unique<uint8_t[]>(ringCapacity);
+
+    // No producer can be inside the ring here: stop() waited for them.
+    writePosition.store(0, std::memory_order_relaxed);
+    readPosition.store(0, std::memory_order_relaxed);
+    droppedBlocks.store(0, std::memory_order_relaxed);
+    captureAudio = includeAudio;
+    sendAllValues = true;
+    pendingDroppedBlocks = 0;
+
+    stream->write(capture::fileMagic, sizeof(capture::fileMagic));
+    writeValue(*stream, capture::formatVersion);
+    writeValue(*stream, static_cast<uint32_t>(params::numParameters));
+    for (const auto* id : params::parameterIdsByIndex)
+    {
+        const auto length = static_cast<uint8_t>(std::strlen(id));
+        writeValue(*stream, length);
+        stream->write(id, length);
+    }
+    writeValue(*stream, static_cast<uint8_t>(includeAudio ? 1 : 0));
+
+    if (current != nullptr)
+    {
+        writeValue(*stream, static_cast<uint8_t>(capture::RecordType::prepare));
+        writeValue(*stream, static_cast<uint32_t>(getPreparePayloadBytes(*current)));
+        writeValue(*stream, current->sampleRate);
+        writeValue(*stream, current->maxBlockSize);
+        writeValue(*stream, current->numChannels);
+        writeValue(*stream, static_cast<uint8_t>(current->nonRealtime ? 1 : 0));
+        writeValue(*stream, static_cast<uint8_t>(current->doublePrecision ? 1 : 0));
+        writeValue(*stream, static_cast<uint32_t>(current->routing.getNumBytesAsUTF8()));
+        stream->write(current->routing.toRawUTF8(), current->routing.getNumBytesAsUTF8());
+    }
+
+    writer = std::make_unique<Writer>(*this, std::move(stream));
+    writer->startThread(juce::Thread::Priority::low);
+    capturing.store(true, std::memory_order_release);
+    return true;
+}
+
+void SessionCapture::stop()
+{
+    if (writer == nullptr)
+        return;
+
+    capturing.store(false, std::memory_order_seq_cst);
+    while (activeProducers.load(std::memory_order_seq_cst) != 0)
+        std::this_thread::yield();
+
+    writer->finish(pendingDroppedBlocks);
+    writer.reset();
+    pendingDroppedBlocks = 0;
+}
+
+bool SessionCapture::enterProducer() noexcept
+{
+    if (! capturing.load(std::memory_order_acquire))
+        return false;
+
+    // Re-checked after announcing ourselves, so stop() either sees us or we see it.
+    activeProducers.fetch_add(1, std::memory_order_seq_cst);
+    if (capturing.load(std::memory_order_seq_cst))
+        return true;
+
+    leaveProducer();
+    return false;
+}
+
+size_t SessionCapture::getFreeBytes() const noexcept
+{
+    const auto used = writePosition.load(std::memory_order_relaxed) - readPosition.load(std::memory_order_acquire);
+    return ringCapacity - static_cast<size_t>(used);
+}
+
+template <typename Fill>
+bool SessionCapture::writeRecord(capture::RecordType type, size_t payloadBytes, Fill&& fill) noexcept
+{
+    const auto droppedRecordBytes = pendingDroppedBlocks > 0 ? recordHeaderBytes + sizeof(uint32_t) : 0;
+    if (getFreeBytes() < droppedRecordBytes + recordHeaderBytes + payloadBytes)
+        return false;
+
+    RecordWriter out { ring.get(), writePosition.load(std::memory_order_relaxed) };
+
+    if (pendingDroppedBlocks > 0)
+    {
+        out.put(static_cast<uint8_t>(capture::RecordType::dropped));
+        out.put(static_cast<uint32_t>(sizeof(uint32_t)));
+        out.put(pendingDroppedBlocks);
+        pendingDroppedBlocks = 0;
+    }
+
+    out.put(static_cast<uint8_t>(type));
+    out.put(static_cast<uint32_t>(payloadBytes));
+    fill(out);
+
+    writePosition.store(out.getPosition(), std::memory_order_release);
+    return true;
+}
+
+void SessionCapture::recordPrepare(const capture::PrepareInfo& info) noexcept
+{
+    if (! enterProducer())
+        return;
+
+    writeRecord(capture::RecordType::prepare, getPreparePayloadBytes(info), [&info](RecordWriter& out)
+    {
+        out.put(info.sampleRate);
+        out.put(info.maxBlockSize);
+        out.put(info.numChannels);
+        out.put(static_cast<uint8_t>(info.nonRealtime ? 1 : 0));
+        out.put(static_cast<uint8_t>(info.doublePrecision ? 1 : 0));
+        out.put(static_cast<uint32_t>(info.routing.getNumBytesAsUTF8()));
+        out.putBytes(info.routing.toRawUTF8(), info.routing.getNumBytesAsUTF8());
+    });
+
+    // Replays start every prepare from a full parameter set.
+    sendAllValues = true;
+    leaveProducer();
+}
+
+void SessionCapture::recordRelease() noexcept
+{
+    if (! enterProducer())
+        return;
+
+    writeRecord(capture::RecordType::release, 0, [](RecordWriter&) {});
+    leaveProducer();
+}
+
+template <typename SampleType>
+void SessionCapture::recordBlock(const params::ParameterValues& values,
+                                 juce::AudioPlayHead* playHead,
+                                 const juce::AudioBuffer<SampleType>& input,
+                                 int numInputChannels) noexcept
+{
+    if (! enterProducer())
+        return;
+
+    size_t numChanged = 0;
+    for (size_t index = 0; index < params::numParameters; ++index)
+        if (sendAllValues || ! juce::exactlyEqual(values[index], lastValues[index]))
+            changedIndices[numChanged++] = static_cast<uint16_t>(index);
+
+    const auto playHeadState = capture::PlayHeadState::fromPlayHead(playHead);
+    const auto numSamples = input.getNumSamples();
+    const auto numAudioChannels = captureAudio ? juce::jmin(numInputChannels, input.getNumChannels()) : 0;
+
+    auto payloadBytes = sizeof(int32_t) + sizeof(uint16_t) + numChanged * (sizeof(uint16_t) + sizeof(float)) + playHeadBytes;
+    if (captureAudio)
+        payloadBytes += sizeof(uint16_t) + static_cast<size_t>(numAudioChannels) * static_cast<size_t>(numSamples) * sizeof(float);
+
+    const auto written = writeRecord(capture::RecordType::block, payloadBytes, [&](RecordWriter& out)
+    {
+        out.put(static_cast<int32_t>(numSamples));
+        out.put(static_cast<uint16_t>(numChanged));
+        for (size_t changed = 0; changed < numChanged; ++changed)
+        {
+            out.put(changedIndices[changed]);
+            out.put(values[changedIndices[changed]]);
+        }
+
+        out.put(playHeadState.flags);
+        out.put(playHeadState.bpm);
+        out.put(playHeadState.ppqPosition);
+        out.put(playHeadState.timeInSamples);
+        out.put(playHeadState.timeSignatureNumerator);
+        out.put(playHeadState.timeSignatureDenominator);
+
+        if (! captureAudio)
+            return;
+
+        out.put(static_cast<uint16_t>(numAudioChannels));
+        for (int channel = 0; channel < numAudioChannels; ++channel)
+        {
+            const auto* samples = input.getReadPointer(channel);
+            if constexpr (std::is_same_v<SampleType, float>)
+                out.putBytes(samples, static_cast<size_t>(numSamples) * sizeof(float));
+            else
+                for (int sample = 0; sample < numSamples; ++sample)
+                    out.put(static_cast<float>(samples[sample]));
+        }
+    });
+
+    if (written)
+    {
+        lastValues = values;
+        sendAllValues = false;
+    }
+    else
+    {
+        // The diff chain is broken; the next block that fits starts from a full set again.
+        ++pendingDroppedBlocks;
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        sendAllValues = true;
+    }
+
+    leaveProducer();
+}
+
+template void SessionCapture::recordBlock<float>(const params::ParameterValues&, juce::AudioPlayHead*, const juce::AudioBuffer<float>&, int) noexcept;
+template void SessionCapture::recordBlock<double>(const params::ParameterValues&, juce::AudioPlayHead*, const juce::AudioBuffer<double>&, int) noexcept;
+
+bool SessionCaptureReader::open(const juce::File& file)
+{
+    auto fileStream = std::make_unique<juce::FileInputStream>(file);
+    if (! fileStream->openedOk())
+        return false;
+
+    stream = std::make_unique<juce::BufferedInputStream>(fileStream.release(), 1 << 16, true);
+    parameterIds.clear();
+
+    char magic[sizeof(capture::fileMagic)] {};
+    uint32_t numParameters = 0;
+    if (stream->read(magic, sizeof(magic)) != static_cast<int>(sizeof(magic))
+        || std::memcmp(magic, capture::fileMagic, sizeof(magic)) != 0
+        || stream->read(&version, sizeof(version)) != static_cast<int>(sizeof(version))
+        || version < 1 || version > capture::formatVersion
+        || stream->read(&numParameters, sizeof(numParameters)) != static_cast<int>(sizeof(numParameters)))
+        return false;
+
+    for (uint32_t index = 0; index < numParameters; ++index)
+    {
+        uint8_t length = 0;
+        char id[256] {};
+        if (stream->read(&length, 1) != 1 || stream->read(id, length) != length)
+            return false;
+
+        parameterIds.add(juce::String::fromUTF8(id, length));
+    }
+
+    uint8_t audio = 0;
+    if (stream->read(&audio, 1) != 1)
+        return false;
+
+    audioIncluded = audio != 0;
+    return true;
+}
+
+bool SessionCaptureReader::readNext(Record& record)
+{
+    if (stream == nullptr)
+        return false;
+
+    uint8_t type = 0;
+    uint32_t payloadBytes = 0;
+    if (stream->read(&type, 1) != 1 || stream->read(&payloadBytes, sizeof(payloadBytes)) != static_cast<int>(sizeof(payloadBytes)))
+        return false;
+
+    juce::MemoryBlock payload;
+    if (payloadBytes > 0 && stream->readIntoMemoryBlock(payload, static_cast<juce::ssize_t>(payloadBytes)) != payloadBytes)
+        return false;
+
+    PayloadReader reader { payload };
+    record.type = static_cast<capture::RecordType>(type);
+
+    switch (record.type)
+    {
+        case capture::RecordType::prepare:
+        {
+            uint8_t nonRealtime = 0;
+            uint8_t doublePrecision = 0;
+            if (! (reader.read(record.prepare.sampleRate) && reader.read(record.prepare.maxBlockSize)
+                   && reader.read(record.prepare.numChannels) && reader.read(nonRealtime) && reader.read(doublePrecision)))
+                return false;
+
+            record.prepare.nonRealtime = nonRealtime != 0;
+            record.prepare.doublePrecision = doublePrecision != 0;
+            record.prepare.routing = {};
+            return version < 2 || reader.readString(record.prepare.routing);
+        }
+
+        case capture::RecordType::block:
+        {
+            auto& block = record.block;
+            int32_t numSamples = 0;
+            uint16_t numChanged = 0;
+            if (! (reader.read(numSamples) && reader.read(numChanged)) || numSamples < 0)
+                return false;
+
+            block.numSamples = numSamples;
+            block.changedValues.resize(numChanged);
+            for (auto& [index, value] : block.changedValues)
+                if (! (reader.read(index) && reader.read(value)))
+                    return false;
+
+            auto& playHead = block.playHead;
+            if (! (reader.read(playHead.flags) && reader.read(playHead.bpm) && reader.read(playHead.ppqPosition)
+                   && reader.read(playHead.timeInSamples) && reader.read(playHead.timeSignatureNumerator)
+                   && reader.read(playHead.timeSignatureDenominator)))
+                return false;
+
+            block.numAudioChannels = 0;
+            block.audio.clear();
+            if (audioIncluded)
+            {
+                uint16_t numChannels = 0;
+                if (! reader.read(numChannels))
+                    return false;
+
+                block.numAudioChannels = numChannels;
+                block.audio.resize(static_cast<size_t>(numChannels) * static_cast<size_t>(numSamples));
+                if (! reader.readFloats(block.audio.data(), block.audio.size()))
+                    return false;
+            }
+
+            return true;
+        }
+
+        case capture::RecordType::release:
+            return true;
+
+        case capture::RecordType::dropped:
+            return reader.read(record.droppedBlocks);
+    }
+
+    return false;
+}
+} // namespace dustbox
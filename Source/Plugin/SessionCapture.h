@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+  File: SessionCapture.h
+  Responsibility: Record what a host asked of the processor (prepare/release
+                  calls, block sizes, parameter values, playhead, custom
+                  routing and, optionally, the input audio) into a compact
+                  binary file, and read such files back for replay.
+  Assumptions: start()/stop() run on the message thread. recordBlock() runs on
+               the audio thread; recordPrepare()/recordRelease() run where the
+               host calls prepareToPlay()/releaseResources(), which hosts never
+               overlap with processBlock(), so there is one producer at a
+               time. Recording is realtime-safe: records go into a ring
+               allocated by start() and a full ring drops the block.
+  Notes: A file is a header (magic, version, parameter IDs, audio flag)
+         followed by records of [type u8][payload size u32][payload]. Blocks
+         carry only the parameters that changed since the previous block; the
+         first block after a prepare or a drop carries all of them. Values are
+         the plain (denormalised) values the audio thread reads. Each prepare
+         carries the routing text ("default" for the parameter order); a
+         routing changed while playing reaches the capture at the next
+         prepare. Numbers are stored in the writing machine's byte order.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Parameters/ParameterIndex.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dustbox
+{
+namespace capture
+{
+inline constexpr char fileMagic[8] { 'D', 'B', 'X', 'C', 'A', 'P', 'T', 'R' };
+inline constexpr uint32_t formatVersion = 2; // Version 1 prepares carry no routing.
+
+enum class RecordType : uint8_t
+{
+    prepare = 1,
+    block = 2,
+    release = 3,
+    dropped = 4 // Blocks lost because the writer fell behind.
+};
+
+struct PrepareInfo
+{
+    double sampleRate { 0.0 };
+    int32_t maxBlockSize { 0 };
+    int32_t numChannels { 0 };
+    bool nonRealtime { false };
+    bool doublePrecision { false };
+    juce::String routing; // DustboxProcessor::getRouting(); empty in version 1 files.
+};
+
+/** The parts of AudioPlayHead::PositionInfo the processor reads. */
+struct PlayHeadState
+{
+    enum Flags : uint8_t
+    {
+        hasPosition = 1 << 0,
+        isPlaying = 1 << 1,
+        hasBpm = 1 << 2,
+        hasPpq = 1 << 3,
+        hasTimeInSamples = 1 << 4,
+        hasTimeSignature = 1 << 5
+    };
+
+    uint8_t flags { 0 };
+    double bpm { 0.0 };
+    double ppqPosition { 0.0 };
+    int64_t timeInSamples { 0 };
+    int32_t timeSignatureNumerator { 4 };
+    int32_t timeSignatureDenominator { 4 };
+
+    static PlayHeadState fromPlayHead(juce::AudioPlayHead* playHead) noexcept;
+    juce::Optional<juce::AudioPlayHead::PositionInfo> toPositionInfo() const;
+};
+} // namespace capture
+
+class SessionCapture
+{
+public:
+    static constexpr size_t ringCapacity = size_t { 8 } << 20; // Bytes; a power of two.
+
+    SessionCapture();
+    ~SessionCapture();
+
+    /** A new timestamped file in the user's Dustbox data folder. */
+    static juce::File getDefaultCaptureFile();
+
+    /** Opens the file and starts capturing. current describes the running prepare, if any, and
+        is written first so the capture replays from where it began. */
+    bool start(const juce::File& file, bool includeAudio, const capture::PrepareInfo* current);
+    /** Stops capturing, writes what is still queued and closes the file. */
+    void stop();
+
+    bool isCapturing() const noexcept { return capturing.load(std::memory_order_acquire); }
+    uint64_t getDroppedBlockCount() const noexcept { return droppedBlocks.load(std::memory_order_relaxed); }
+
+    void recordPrepare(const capture::PrepareInfo& info) noexcept;
+    void recordRelease() noexcept;
+
+    template <typename SampleType>
+    void recordBlock(const params::ParameterValues& values,
+                     juce::AudioPlayHead* playHead,
+                     const juce::AudioBuffer<SampleType>& input,
+                     int numInputChannels) noexcept;
+
+private:
+    class Writer;
+    class RecordWriter;
+
+    bool enterProducer() noexcept;
+    void leaveProducer() noexcept { activeProducers.fetch_sub(1, std::memory_order_seq_cst); }
+    /** Writes one record (after a pending dropped record, if any) and publishes it; false if the
+        ring cannot take both. */
+    template <typename Fill>
+    bool writeRecord(capture::RecordType type, size_t payloadBytes, Fill&& fill) noexcept;
+    size_t getFreeBytes() const noexcept;
+
+    std::unique_ptr<uint8_t[]> ring;
+    std::atomic<uint64_t> writePosition { 0 };
+    std::atomic<uint64_t> readPosition { 0 };
+    std::atomic<bool> capturing { false };
+    std::atomic<int> activeProducers { 0 };
+    std::atomic<uint64_t> droppedBlocks { 0 };
+    std::unique_ptr<Writer> writer;
+
+    // Producer side only.
+    bool captureAudio { false };
+    bool sendAllValues { true };
+    uint32_t pendingDroppedBlocks { 0 };
+    params::ParameterValues lastValues {};
+    std::array<uint16_t, params::numParameters> changedIndices {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionCapture)
+};
+
+/** Reads a capture file record by record. Not realtime-safe; replay tools only. */
+class SessionCaptureReader
+{
+public:
+    struct BlockRecord
+    {
+        int numSamples { 0 };
+        std::vector<std::pair<uint16_t, float>> changedValues;
+        capture::PlayHeadState playHead;
+        int numAudioChannels { 0 };
+        std::vector<float> audio; // numAudioChannels runs of numSamples.
+    };
+
+    struct Record
+    {
+        capture::RecordType type { capture::RecordType::block };
+        capture::PrepareInfo prepare;
+        BlockRecord block;
+        uint32_t droppedBlocks { 0 };
+    };
+
+    /** Reads the header; false if the file is missing or not a capture of a known version. */
+    bool open(const juce::File& file);
+
+    const juce::StringArray& getParameterIds() const noexcept { return parameterIds; }
+    bool includesAudio() const noexcept { return audioIncluded; }
+
+    /** False at the end of the file or at a truncated record. */
+    bool readNext(Record& record);
+
+private:
+    std::unique_ptr<juce::InputStream> stream;
+    juce::StringArray parameterIds;
+    uint32_t version { 0 };
+    bool audioIncluded { false };
+};
+} // namespace dustbox
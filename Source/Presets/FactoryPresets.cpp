@@ -1,163 +1,240 @@
 /*
   ==============================================================================
   File: FactoryPresets.cpp
-  Responsibility: Define Dustbox's host-visible factory presets as deterministic
-                  AudioProcessorValueTreeState snapshots.
-  Assumptions: Parameter IDs originate from ParameterIDs.h and remain stable.
-  Notes: Every preset populates all parameter properties to ensure preset
-         recalls match project state serialisation byte-for-byte.
+  Responsibility: Define Dustbox's host-visible factory presets as compact,
+                  deterministic parameter value arrays shared by all instances.
+  Assumptions: Parameter indices originate from ParameterIndex.h and remain
+               stable.
+  Notes: Every preset populates all parameters so recalls match project state
+         serialisation exactly and hashes are reproducible.
   ==============================================================================
 */
 
 #include "FactoryPresets.h"
 
-#include "../Parameters/ParameterIDs.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
 
 namespace dustbox::presets
 {
 namespace
 {
-ParameterSetting makeSetting(const char* paramID, float value)
+using P = params::ParameterIndex;
+using ParameterSetting = std::pair<params::ParameterIndex, float>;
+
+// Values are compared at 1e-4 resolution; that absorbs the rounding introduced by the
+// normalised round trip through the host while still telling real preset values apart.
+constexpr double matchResolution = 1.0e-4;
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t fnvPrime = 1099511628211ull;
+
+int64_t quantise(float value) noexcept
 {
-    return { juce::Identifier { paramID }, juce::var { value } };
+    return static_cast<int64_t>(std::llround(static_cast<double>(value) / matchResolution));
 }
 
-ParameterSetting makeSetting(const char* paramID, double value)
+FactoryPreset makePreset(const char* name, std::initializer_list<ParameterSetting> settings)
 {
-    return { juce::Identifier { paramID }, juce::var { value } };
+    FactoryPreset preset;
+    preset.name = name;
+
+    std::array<bool, params::numParameters> assigned {};
+    for (const auto& [index, value] : settings)
+    {
+        preset.values[params::toIndex(index)] = value;
+        assigned[params::toIndex(index)] = true;
+    }
+
+    for (size_t index = 0; index < params::numParameters; ++index)
+        jassert(assigned[index] == params::isStoredInPresets(static_cast<params::ParameterIndex>(index)));
+
+    juce::ignoreUnused(assigned);
+
+    preset.hash = hashParameterValues(preset.values);
+    return preset;
 }
+} // namespace
 
-ParameterSetting makeSetting(const char* paramID, int value)
+uint64_t hashParameterValues(const params::ParameterValues& values) noexcept
 {
-    return { juce::Identifier { paramID }, juce::var { value } };
+    auto hash = fnvOffsetBasis;
+
+    for (size_t index = 0; index < values.size(); ++index)
+    {
+        if (! params::isStoredInPresets(static_cast<params::ParameterIndex>(index)))
+            continue;
+
+        auto bits = static_cast<uint64_t>(quantise(values[index]));
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            hash ^= bits & 0xffu;
+            hash *= fnvPrime;
+            bits >>= 8;
+        }
+    }
+
+    return hash;
 }
 
-ParameterSetting makeSetting(const char* paramID, bool value)
+bool parameterValuesMatch(const params::ParameterValues& a, const params::ParameterValues& b) noexcept
 {
-    return { juce::Identifier { paramID }, juce::var { value } };
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (params::isStoredInPresets(static_cast<params::ParameterIndex>(i)) && quantise(a[i]) != quantise(b[i]))
+            return false;
+    }
+
+    return true;
 }
+
+FactoryPresetTable::FactoryPresetTable()
+{
+    presets.reserve(5);
+
+    presets.push_back(makePreset("Subtle Glue",
+                                 {
+                                     { P::tapeWowDepth, 0.10f },
+                                     { P::tapeWowRateHz, 0.55f },
+                                     { P::tapeFlutterDepth, 0.04f },
+                                     { P::tapeToneLowpassHz, 16000.0f },
+                                     { P::tapeNoiseLevelDb, -58.0f },
+                                     { P::noiseRouting, 1 },
+                                     { P::dirtSaturationAmt, 0.12f },
+                                     { P::dirtBitDepthBits, 24 },
+                                     { P::dirtSampleRateDiv, 1 },
+                                     { P::pumpAmount, 0.08f },
+                                     { P::pumpSyncNote, 1 },
+                                     { P::pumpPhase, 0.0f },
+                                     { P::mixWet, 0.35f },
+                                     { P::outputGainDb, 0.0f },
+                                     { P::hardBypass, 0 },
+                                     { P::chainOrder, 0 },
+                                     { P::dirtTargetRate, 0 },
+                                 }));
+
+    presets.push_back(makePreset("Lo-Fi Hiss",
+                                 {
+                                     { P::tapeWowDepth, 0.22f },
+                                     { P::tapeWowRateHz, 0.65f },
+                                     { P::tapeFlutterDepth, 0.12f },
+                                     { P::tapeToneLowpassHz, 7800.0f },
+                                     { P::tapeNoiseLevelDb, -32.0f },
+                                     { P::noiseRouting, 1 },
+                                     { P::dirtSaturationAmt, 0.28f },
+                                     { P::dirtBitDepthBits, 14 },
+                                     { P::dirtSampleRateDiv, 3 },
+                                     { P::pumpAmount, 0.15f },
+                                     { P::pumpSyncNote, 1 },
+                                     { P::pumpPhase, 0.0f },
+                                     { P::mixWet, 0.58f },
+                                     { P::outputGainDb, -0.5f },
+                                     { P::hardBypass, 0 },
+                                     { P::chainOrder, 0 },
+                                     { P::dirtTargetRate, 0 },
+                                 }));
+
+    presets.push_back(makePreset("Chorus Pump",
+                                 {
+                                     { P::tapeWowDepth, 0.35f },
+                                     { P::tapeWowRateHz, 1.50f },
+                                     { P::tapeFlutterDepth, 0.24f },
+                                     { P::tapeToneLowpassHz, 12500.0f },
+                                     { P::tapeNoiseLevelDb, -46.0f },
+                                     { P::noiseRouting, 2 },
+                                     { P::dirtSaturationAmt, 0.10f },
+                                     { P::dirtBitDepthBits, 24 },
+                                     { P::dirtSampleRateDiv, 1 },
+                                     { P::pumpAmount, 0.65f },
+                                     { P::pumpSyncNote, 0 },
+                                     { P::pumpPhase, 0.0f },
+                                     { P::mixWet, 0.65f },
+                                     { P::outputGainDb, -0.5f },
+                                     { P::hardBypass, 0 },
+                                     { P::chainOrder, 0 },
+                                     { P::dirtTargetRate, 0 },
+                                 }));
+
+    presets.push_back(makePreset("Warm Crunch",
+                                 {
+                                     { P::tapeWowDepth, 0.24f },
+                                     { P::tapeWowRateHz, 0.75f },
+                                     { P::tapeFlutterDepth, 0.14f },
+                                     { P::tapeToneLowpassHz, 9000.0f },
+                                     { P::tapeNoiseLevelDb, -60.0f },
+                                     { P::noiseRouting, 0 },
+                                     { P::dirtSaturationAmt, 0.52f },
+                                     { P::dirtBitDepthBits, 12 },
+                                     { P::dirtSampleRateDiv, 2 },
+                                     { P::pumpAmount, 0.18f },
+                                     { P::pumpSyncNote, 1 },
+                                     { P::pumpPhase, 0.0f },
+                                     { P::mixWet, 0.62f },
+                                     { P::outputGainDb, -1.0f },
+                                     { P::hardBypass, 0 },
+                                     { P::chainOrder, 0 },
+                                     { P::dirtTargetRate, 0 },
+                                 }));
+
+    presets.push_back(makePreset("Noisy Parallel",
+                                 {
+                                     { P::tapeWowDepth, 0.16f },
+                                     { P::tapeWowRateHz, 0.60f },
+                                     { P::tapeFlutterDepth, 0.08f },
+                                     { P::tapeToneLowpassHz, 11500.0f },
+                                     { P::tapeNoiseLevelDb, -30.0f },
+                                     { P::noiseRouting, 2 },
+                                     { P::dirtSaturationAmt, 0.20f },
+                                     { P::dirtBitDepthBits, 18 },
+                                     { P::dirtSampleRateDiv, 2 },
+                                     { P::pumpAmount, 0.22f },
+                                     { P::pumpSyncNote, 1 },
+                                     { P::pumpPhase, 0.25f },
+                                     { P::mixWet, 0.45f },
+                                     { P::outputGainDb, -0.5f },
+                                     { P::hardBypass, 0 },
+                                     { P::chainOrder, 0 },
+                                     { P::dirtTargetRate, 0 },
+                                 }));
+
+    presetsByHash.reserve(presets.size());
+    for (size_t i = 0; i < presets.size(); ++i)
+        presetsByHash.emplace_back(presets[i].hash, static_cast<int>(i));
+
+    std::sort(presetsByHash.begin(), presetsByHash.end());
 }
 
-juce::ValueTree makeStateFromMap(const juce::AudioProcessorValueTreeState& apvts,
-                                 std::initializer_list<ParameterSetting> settings)
+juce::StringArray FactoryPresetTable::getPresetNames() const
 {
-    auto state = apvts.state.createCopy();
+    juce::StringArray names;
+    for (const auto& preset : presets)
+        names.add(preset.name);
 
-    for (const auto& [id, value] : settings)
-        state.setProperty(id, value, nullptr);
+    return names;
+}
 
-    return state;
+void FactoryPresetTable::mergePresetValues(int index, params::ParameterValues& target) const noexcept
+{
+    const auto& values = getPreset(index).values;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (params::isStoredInPresets(static_cast<params::ParameterIndex>(i)))
+            target[i] = values[i];
+    }
 }
 
-std::vector<FactoryPreset> createFactoryPresets(const juce::AudioProcessorValueTreeState& apvts)
+int FactoryPresetTable::findMatchingPreset(const params::ParameterValues& values) const noexcept
 {
-    using namespace params::ids;
+    const auto hash = hashParameterValues(values);
+    auto it = std::lower_bound(presetsByHash.begin(), presetsByHash.end(), std::make_pair(hash, 0));
 
-    std::vector<FactoryPreset> presets;
-    presets.reserve(5);
+    for (; it != presetsByHash.end() && it->first == hash; ++it)
+    {
+        if (parameterValuesMatch(values, presets[static_cast<size_t>(it->second)].values))
+            return it->second;
+    }
 
-    presets.push_back({ "Subtle Glue",
-                        makeStateFromMap(apvts,
-                                         {
-                                             makeSetting(tapeWowDepth, 0.10f),
-                                             makeSetting(tapeWowRateHz, 0.55f),
-                                             makeSetting(tapeFlutterDepth, 0.04f),
-                                             makeSetting(tapeToneLowpassHz, 16000.0f),
-                                             makeSetting(tapeNoiseLevelDb, -58.0f),
-                                             makeSetting(noiseRouting, 1),
-                                             makeSetting(dirtSaturationAmt, 0.12f),
-                                             makeSetting(dirtBitDepthBits, 24),
-                                             makeSetting(dirtSampleRateDiv, 1),
-                                             makeSetting(pumpAmount, 0.08f),
-                                             makeSetting(pumpSyncNote, 1),
-                                             makeSetting(pumpPhase, 0.0f),
-                                             makeSetting(mixWet, 0.35f),
-                                             makeSetting(outputGainDb, 0.0f),
-                                             makeSetting(hardBypass, false),
-                                         }) });
-
-    presets.push_back({ "Lo-Fi Hiss",
-                        makeStateFromMap(apvts,
-                                         {
-                                             makeSetting(tapeWowDepth, 0.22f),
-                                             makeSetting(tapeWowRateHz, 0.65f),
-                                             makeSetting(tapeFlutterDepth, 0.12f),
-                                             makeSetting(tapeToneLowpassHz, 7800.0f),
-                                             makeSetting(tapeNoiseLevelDb, -32.0f),
-                                             makeSetting(noiseRouting, 1),
-                                             makeSetting(dirtSaturationAmt, 0.28f),
-                                             makeSetting(dirtBitDepthBits, 14),
-                                             makeSetting(dirtSampleRateDiv, 3),
-                                             makeSetting(pumpAmount, 0.15f),
-                                             makeSetting(pumpSyncNote, 1),
-                                             makeSetting(pumpPhase, 0.0f),
-                                             makeSetting(mixWet, 0.58f),
-                                             makeSetting(outputGainDb, -0.5f),
-                                             makeSetting(hardBypass, false),
-                                         }) });
-
-    presets.push_back({ "Chorus Pump",
-                        makeStateFromMap(apvts,
-                                         {
-                                             makeSetting(tapeWowDepth, 0.35f),
-                                             makeSetting(tapeWowRateHz, 1.50f),
-                                             makeSetting(tapeFlutterDepth, 0.24f),
-                                             makeSetting(tapeToneLowpassHz, 12500.0f),
-                                             makeSetting(tapeNoiseLevelDb, -46.0f),
-                                             makeSetting(noiseRouting, 2),
-                                             makeSetting(dirtSaturationAmt, 0.10f),
-                                             makeSetting(dirtBitDepthBits, 24),
-                                             makeSetting(dirtSampleRateDiv, 1),
-                                             makeSetting(pumpAmount, 0.65f),
-                                             makeSetting(pumpSyncNote, 0),
-                                             makeSetting(pumpPhase, 0.0f),
-                                             makeSetting(mixWet, 0.65f),
-                                             makeSetting(outputGainDb, -0.5f),
-                                             makeSetting(hardBypass, false),
-                                         }) });
-
-    presets.push_back({ "Warm Crunch",
-                        makeStateFromMap(apvts,
-                                         {
-                                             makeSetting(tapeWowDepth, 0.24f),
-                                             makeSetting(tapeWowRateHz, 0.75f),
-                                             makeSetting(tapeFlutterDepth, 0.14f),
-                                             makeSetting(tapeToneLowpassHz, 9000.0f),
-                                             makeSetting(tapeNoiseLevelDb, -60.0f),
-                                             makeSetting(noiseRouting, 0),
-                                             makeSetting(dirtSaturationAmt, 0.52f),
-                                             makeSetting(dirtBitDepthBits, 12),
-                                             makeSetting(dirtSampleRateDiv, 2),
-                                             makeSetting(pumpAmount, 0.18f),
-                                             makeSetting(pumpSyncNote, 1),
-                                             makeSetting(pumpPhase, 0.0f),
-                                             makeSetting(mixWet, 0.62f),
-                                             makeSetting(outputGainDb, -1.0f),
-                                             makeSetting(hardBypass, false),
-                                         }) });
-
-    presets.push_back({ "Noisy Parallel",
-                        makeStateFromMap(apvts,
-                                         {
-                                             makeSetting(tapeWowDepth, 0.16f),
-                                             makeSetting(tapeWowRateHz, 0.60f),
-                                             makeSetting(tapeFlutterDepth, 0.08f),
-                                             makeSetting(tapeToneLowpassHz, 11500.0f),
-                                             makeSetting(tapeNoiseLevelDb, -30.0f),
-                                             makeSetting(noiseRouting, 2),
-                                             makeSetting(dirtSaturationAmt, 0.20f),
-                                             makeSetting(dirtBitDepthBits, 18),
-                                             makeSetting(dirtSampleRateDiv, 2),
-                                             makeSetting(pumpAmount, 0.22f),
-                                             makeSetting(pumpSyncNote, 1),
-                                             makeSetting(pumpPhase, 0.25f),
-                                             makeSetting(mixWet, 0.45f),
-                                             makeSetting(outputGainDb, -0.5f),
-                                             makeSetting(hardBypass, false),
-                                         }) });
-
-    return presets;
+    return -1;
 }
 
 } // namespace dustbox::presets
-
@@ -1,20 +1,23 @@
 /*
   ==============================================================================
   File: FactoryPresets.h
-  Responsibility: Declare built-in Dustbox factory presets and helpers for
-                  constructing APVTS snapshot states.
-  Assumptions: AudioProcessorValueTreeState owns all parameter IDs listed in
-               ParameterIDs.h with stable identifiers.
-  Notes: Preset states must be deterministic to guarantee host-visible program
-         changes serialise identically to manual parameter edits.
+  Responsibility: Declare the process-wide, immutable table of Dustbox factory
+                  presets stored as compact per-parameter value arrays.
+  Assumptions: Values are plain parameter values in params::ParameterIndex
+               order; every preset sets every preset-stored parameter
+               explicitly and leaves morph controls at zero.
+  Notes: Acquire the table through juce::SharedResourcePointer so all plugin
+         instances in a process share a single reference-counted copy.
   ==============================================================================
 */
 
 #pragma once
 
-#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
 
-#include <initializer_list>
+#include "../Parameters/ParameterIndex.h"
+
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -23,15 +26,36 @@ namespace dustbox::presets
 struct FactoryPreset
 {
     juce::String name;
-    juce::ValueTree state;
+    params::ParameterValues values {};
+    uint64_t hash { 0 };
 };
 
-using ParameterSetting = std::pair<juce::Identifier, juce::var>;
+/** Hash of the preset-stored values quantised to the precision presets are matched at. */
+uint64_t hashParameterValues(const params::ParameterValues& values) noexcept;
 
-juce::ValueTree makeStateFromMap(const juce::AudioProcessorValueTreeState& apvts,
-                                 std::initializer_list<ParameterSetting> settings);
+/** True when the preset-stored values are equal within the matching tolerance. */
+bool parameterValuesMatch(const params::ParameterValues& a, const params::ParameterValues& b) noexcept;
 
-std::vector<FactoryPreset> createFactoryPresets(const juce::AudioProcessorValueTreeState& apvts);
+class FactoryPresetTable
+{
+public:
+    FactoryPresetTable();
 
-} // namespace dustbox::presets
+    int size() const noexcept { return static_cast<int>(presets.size()); }
+    const FactoryPreset& getPreset(int index) const noexcept { return presets[static_cast<size_t>(index)]; }
+    juce::StringArray getPresetNames() const;
+
+    /** Overwrites the preset-stored entries of target, leaving morph controls untouched. */
+    void mergePresetValues(int index, params::ParameterValues& target) const noexcept;
+
+    /** Returns the index of the preset matching the values, or -1 when none matches. */
+    int findMatchingPreset(const params::ParameterValues& values) const noexcept;
 
+private:
+    std::vector<FactoryPreset> presets;
+    std::vector<std::pair<uint64_t, int>> presetsByHash;
+
+    JUCE_DECLARE_NON_COPYABLE(FactoryPresetTable)
+};
+
+} // namespace dustbox::presets
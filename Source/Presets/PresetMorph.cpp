@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+  File: PresetMorph.cpp
+  Responsibility: Implement the preset morph engine's source compilation and
+                  per-block evaluation.
+  Assumptions: The factory preset table is immutable for the process lifetime.
+  ==============================================================================
+*/
+
+#include "PresetMorph.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <cmath>
+
+namespace dustbox::presets
+{
+namespace
+{
+constexpr auto makeBehaviourTable() noexcept
+{
+    std::array<params::MorphBehaviour, params::numParameters> table {};
+    for (size_t index = 0; index < params::numParameters; ++index)
+        table[index] = params::getMorphBehaviour(static_cast<params::ParameterIndex>(index));
+
+    return table;
+}
+
+constexpr auto morphBehaviours = makeBehaviourTable();
+constexpr auto vectorSize = static_cast<int>(params::numParameters);
+} // namespace
+
+void PresetMorphEngine::setSources(const FactoryPresetTable& table, const SourceIndices& indices, int newNumSources) noexcept
+{
+    numSources = juce::jlimit(0, juce::jmin(maxSources, table.size()), newNumSources);
+    sourceIndices = indices;
+
+    for (int source = 0; source < numSources; ++source)
+    {
+        const auto clamped = juce::jlimit(0, table.size() - 1, indices[static_cast<size_t>(source)]);
+        sources[static_cast<size_t>(source)] = table.getPreset(clamped).values;
+    }
+
+    for (int segment = 0; segment + 1 < numSources; ++segment)
+    {
+        const auto index = static_cast<size_t>(segment);
+        juce::FloatVectorOperations::subtract(deltas[index].data(), sources[index + 1].data(), sources[index].data(), vectorSize);
+    }
+}
+
+void PresetMorphEngine::evaluate(float position, params::ParameterValues& values) const noexcept
+{
+    if (numSources == 0)
+        return;
+
+    const auto numSegments = juce::jmax(1, numSources - 1);
+    const auto scaled = juce::jlimit(0.0f, 1.0f, position) * static_cast<float>(numSegments);
+    const auto segment = juce::jmin(static_cast<int>(scaled), numSegments - 1);
+    const auto amount = numSources > 1 ? scaled - static_cast<float>(segment) : 0.0f;
+
+    const auto& from = sources[static_cast<size_t>(segment)];
+    const auto& to = sources[static_cast<size_t>(juce::jmin(segment + 1, numSources - 1))];
+
+    params::ParameterValues blended;
+    juce::FloatVectorOperations::copy(blended.data(), from.data(), vectorSize);
+    if (numSources > 1)
+        juce::FloatVectorOperations::addWithMultiply(blended.data(), deltas[static_cast<size_t>(segment)].data(), amount, vectorSize);
+
+    for (size_t index = 0; index < params::numParameters; ++index)
+    {
+        switch (morphBehaviours[index])
+        {
+            case params::MorphBehaviour::interpolate:
+                values[index] = blended[index];
+                break;
+            case params::MorphBehaviour::roundToStep:
+                values[index] = std::round(blended[index]);
+                break;
+            case params::MorphBehaviour::switchAtMidpoint:
+                values[index] = amount < 0.5f ? from[index] : to[index];
+                break;
+            case params::MorphBehaviour::none:
+                break;
+        }
+    }
+}
+} // namespace dustbox::presets
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+  File: PresetMorph.h
+  Responsibility: Declare the realtime preset morph engine that blends two or
+                  four factory presets into a dense parameter vector.
+  Assumptions: Sources come from the shared FactoryPresetTable; evaluate() runs
+               on the audio thread once per block.
+  Notes: Sources are compiled into flat value arrays plus per-segment deltas so
+         a morph step is one vectorised multiply-add over the parameter vector.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Parameters/ParameterIndex.h"
+#include "FactoryPresets.h"
+
+#include <array>
+
+namespace dustbox::presets
+{
+class PresetMorphEngine
+{
+public:
+    static constexpr int maxSources = 4;
+    using SourceIndices = std::array<int, maxSources>;
+
+    /** Copies the first numSources presets named by indices into the engine. Does not
+        allocate, so the audio thread may recompile when the morph slots change. */
+    void setSources(const FactoryPresetTable& table, const SourceIndices& indices, int numSources) noexcept;
+
+    int getNumSources() const noexcept { return numSources; }
+    const SourceIndices& getSourceIndices() const noexcept { return sourceIndices; }
+
+    /** Writes the blend at position (0..1 across all sources, in order) into the preset-stored
+        entries of values. Parameters without a morph behaviour keep their incoming value. */
+    void evaluate(float position, params::ParameterValues& values) const noexcept;
+
+private:
+    std::array<params::ParameterValues, maxSources> sources {};
+    std::array<params::ParameterValues, maxSources - 1> deltas {};
+    SourceIndices sourceIndices { -1, -1, -1, -1 };
+    int numSources { 0 };
+};
+} // namespace dustbox::presets
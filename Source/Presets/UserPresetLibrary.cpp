@@ -0,0 +1,480 @@
+/*
+  ==============================================================================
+  File: UserPresetLibrary.cpp
+  Responsibility: Implement the memory-mapped user preset library: record
+                  appends, index (re)building, listing, recall, and search.
+  Assumptions: Only one process appends to a given library at a time.
+  Notes: Listing and searching read the mapped index only; record pages are
+         touched when a preset's values are recalled. A torn record at the end
+         of the library (interrupted append) is ignored and overwritten by the
+         next append.
+  ==============================================================================
+*/
+
+#include "UserPresetLibrary.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace dustbox::presets
+{
+namespace
+{
+constexpr size_t libraryHeaderSize = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+constexpr size_t recordHeaderSize = sizeof(uint32_t) + 4 * sizeof(uint16_t);
+constexpr size_t indexHeaderSize = 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+constexpr size_t indexEntrySize = 4 * sizeof(uint32_t);
+constexpr size_t maxStringBytes = 0xffff;
+
+constexpr size_t libraryBytesOffset = 8;
+constexpr size_t indexedBytesOffset = 16;
+constexpr size_t libraryModifiedOffset = 24;
+constexpr size_t entryCountOffset = 32;
+constexpr size_t checksumOffset = 36;
+
+constexpr uint32_t fnvOffsetBasis = 2166136261u;
+constexpr uint32_t fnvPrime = 16777619u;
+
+struct RecordView
+{
+    const uint8_t* values { nullptr };
+    size_t valueCount { 0 };
+    const char* name { nullptr };
+    size_t nameBytes { 0 };
+    const char* tags { nullptr };
+    size_t tagBytes { 0 };
+    size_t recordBytes { 0 };
+};
+
+uint64_t readUInt64(const uint8_t* source) noexcept
+{
+    return juce::ByteOrder::littleEndianInt64(source);
+}
+
+/** Continues an FNV-1a hash over more bytes. */
+uint32_t updateChecksum(uint32_t hash, const uint8_t* bytes, size_t numBytes) noexcept
+{
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= fnvPrime;
+    }
+
+    return hash;
+}
+
+size_t paddedRecordSize(size_t unpadded) noexcept
+{
+    return (unpadded + 3u) & ~static_cast<size_t>(3u);
+}
+
+/** Validates the record at offset; returns false for a torn or corrupt record. */
+bool readRecord(const uint8_t* library, size_t libraryBytes, size_t offset, RecordView& view) noexcept
+{
+    if (offset + recordHeaderSize > libraryBytes)
+        return false;
+
+    const auto* record = library + offset;
+    view.recordBytes = juce::ByteOrder::littleEndianInt(record);
+    view.valueCount = juce::ByteOrder::littleEndianShort(record + 4);
+    view.nameBytes = juce::ByteOrder::littleEndianShort(record + 6);
+    view.tagBytes = juce::ByteOrder::littleEndianShort(record + 8);
+
+    const auto payloadBytes = recordHeaderSize + view.valueCount * sizeof(float) + view.nameBytes + view.tagBytes;
+    if (view.recordBytes < payloadBytes || view.recordBytes != paddedRecordSize(view.recordBytes)
+        || offset + view.recordBytes > libraryBytes)
+        return false;
+
+    view.values = record + recordHeaderSize;
+    view.name = reinterpret_cast<const char*>(view.values + view.valueCount * sizeof(float));
+    view.tags = view.name + view.nameBytes;
+    return true;
+}
+
+void writeRecord(juce::OutputStream& out, const UserPreset& preset)
+{
+    static constexpr char padding[4] {};
+
+    const auto tags = preset.tags.joinIntoString(",");
+    const auto nameBytes = juce::jmin(preset.name.getNumBytesAsUTF8(), maxStringBytes);
+    const auto tagBytes = juce::jmin(tags.getNumBytesAsUTF8(), maxStringBytes);
+    jassert(nameBytes == preset.name.getNumBytesAsUTF8() && tagBytes == tags.getNumBytesAsUTF8());
+
+    const auto unpadded = recordHeaderSize + params::numParameters * sizeof(float) + nameBytes + tagBytes;
+    const auto recordBytes = paddedRecordSize(unpadded);
+
+    out.writeInt(static_cast<int>(recordBytes));
+    out.writeShort(static_cast<short>(params::numParameters));
+    out.writeShort(static_cast<short>(nameBytes));
+    out.writeShort(static_cast<short>(tagBytes));
+    out.writeShort(0);
+
+    for (const auto value : preset.values)
+        out.writeFloat(value);
+
+    out.write(preset.name.toRawUTF8(), nameBytes);
+    out.write(tags.toRawUTF8(), tagBytes);
+    out.write(padding, recordBytes - unpadded);
+}
+
+bool containsAllTerms(std::string_view key, const std::vector<std::string>& terms) noexcept
+{
+    for (const auto& term : terms)
+    {
+        if (key.find(term) == std::string_view::npos)
+            return false;
+    }
+
+    return true;
+}
+} // namespace
+
+UserPresetLibrary::UserPresetLibrary()
+    : UserPresetLibrary(getDefaultLibraryFile())
+{
+}
+
+UserPresetLibrary::UserPresetLibrary(const juce::File& file)
+    : libraryFile(file), indexFile(getIndexFileFor(file))
+{
+    reopen();
+}
+
+UserPresetLibrary::~UserPresetLibrary() = default;
+
+juce::File UserPresetLibrary::getDefaultLibraryFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Dustbox")
+        .getChildFile("UserPresets.dbxlib");
+}
+
+juce::File UserPresetLibrary::getIndexFileFor(const juce::File& file)
+{
+    return file.withFileExtension(".dbxidx");
+}
+
+juce::String UserPresetLibrary::getName(int index) const
+{
+    const auto* entry = getEntry(index);
+    if (entry == nullptr)
+        return {};
+
+    const auto poolOffset = juce::ByteOrder::littleEndianInt(entry + 4);
+    const auto nameBytes = juce::ByteOrder::littleEndianInt(entry + 8);
+    return juce::String::fromUTF8(reinterpret_cast<const char*>(indexPool + poolOffset), static_cast<int>(nameBytes));
+}
+
+juce::StringArray UserPresetLibrary::getTags(int index) const
+{
+    const auto* entry = getEntry(index);
+    RecordView record;
+    if (entry == nullptr || ! readRecord(libraryData, libraryBytes, juce::ByteOrder::littleEndianInt(entry), record))
+        return {};
+
+    return juce::StringArray::fromTokens(juce::String::fromUTF8(record.tags, static_cast<int>(record.tagBytes)), ",", {});
+}
+
+bool UserPresetLibrary::readValues(int index, params::ParameterValues& values) const noexcept
+{
+    const auto* entry = getEntry(index);
+    RecordView record;
+    if (entry == nullptr || ! readRecord(libraryData, libraryBytes, juce::ByteOrder::littleEndianInt(entry), record))
+        return false;
+
+    // Records written by newer builds may carry parameters this build does not know.
+    const auto count = juce::jmin(record.valueCount, params::numParameters);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (! params::isStoredInPresets(static_cast<params::ParameterIndex>(i)))
+            continue;
+
+        const auto bits = juce::ByteOrder::littleEndianInt(record.values + i * sizeof(float));
+        std::memcpy(&values[i], &bits, sizeof(float));
+    }
+
+    return true;
+}
+
+void UserPresetLibrary::search(const juce::String& query, std::vector<int>& results, int maxResults) const
+{
+    std::vector<std::string> terms;
+    for (const auto& token : juce::StringArray::fromTokens(query.toLowerCase(), true))
+    {
+        if (token.isNotEmpty())
+            terms.emplace_back(token.toRawUTF8());
+    }
+
+    for (int index = 0; index < numEntries; ++index)
+    {
+        const auto* entry = indexEntries + static_cast<size_t>(index) * indexEntrySize;
+        const auto poolOffset = juce::ByteOrder::littleEndianInt(entry + 4);
+        const auto nameBytes = juce::ByteOrder::littleEndianInt(entry + 8);
+        const auto keyBytes = juce::ByteOrder::littleEndianInt(entry + 12);
+        const std::string_view key { reinterpret_cast<const char*>(indexPool + poolOffset + nameBytes), keyBytes };
+
+        if (containsAllTerms(key, terms))
+        {
+            results.push_back(index);
+            if (maxResults > 0 && static_cast<int>(results.size()) >= maxResults)
+                return;
+        }
+    }
+}
+
+bool UserPresetLibrary::append(const UserPreset& preset)
+{
+    return append(std::vector<UserPreset> { preset });
+}
+
+bool UserPresetLibrary::append(const std::vector<UserPreset>& presets)
+{
+    // End of the last intact record; anything after it is a torn append and gets overwritten.
+    auto validBytes = static_cast<int64_t>(libraryHeaderSize);
+    if (numEntries > 0)
+    {
+        RecordView last;
+        const auto lastOffset = juce::ByteOrder::littleEndianInt(getEntry(numEntries - 1));
+        if (readRecord(libraryData, libraryBytes, lastOffset, last))
+            validBytes = static_cast<int64_t>(lastOffset + last.recordBytes);
+    }
+
+    // Never append to a file that exists but is not a library we can read.
+    if (libraryData == nullptr && libraryFile.getSize() >= static_cast<int64_t>(libraryHeaderSize))
+        return false;
+
+    // Mapped files cannot be resized on every platform, so release the mappings first.
+    unmap();
+
+    const auto isNewLibrary = libraryFile.getSize() < static_cast<int64_t>(libraryHeaderSize);
+    if (! libraryFile.getParentDirectory().createDirectory())
+        return false;
+
+    {
+        juce::FileOutputStream out(libraryFile);
+        if (out.failedToOpen())
+        {
+            reopen();
+            return false;
+        }
+
+        if (isNewLibrary)
+        {
+            out.setPosition(0);
+            out.truncate();
+            out.writeInt(static_cast<int>(userLibraryMagic));
+            out.writeShort(static_cast<short>(userLibraryVersion));
+            out.writeShort(0);
+        }
+        else if (out.getPosition() != validBytes)
+        {
+            out.setPosition(validBytes);
+            out.truncate();
+        }
+
+        for (const auto& preset : presets)
+            writeRecord(out, preset);
+
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            reopen();
+            return false;
+        }
+    }
+
+    return reopen();
+}
+
+bool UserPresetLibrary::refreshIfChanged()
+{
+    if (libraryFile.getSize() == openedFileBytes
+        && libraryFile.getLastModificationTime().toMilliseconds() == openedFileModified)
+        return false;
+
+    reopen();
+    return true;
+}
+
+bool UserPresetLibrary::reopen()
+{
+    unmap();
+
+    ++generation;
+    openedFileBytes = libraryFile.getSize();
+    openedFileModified = libraryFile.getLastModificationTime().toMilliseconds();
+
+    if (! libraryFile.existsAsFile())
+        return true;
+
+    libraryMap = std::make_unique<juce::MemoryMappedFile>(libraryFile, juce::MemoryMappedFile::readOnly);
+    libraryData = static_cast<const uint8_t*>(libraryMap->getData());
+    libraryBytes = libraryMap->getSize();
+
+    if (libraryData == nullptr || libraryBytes < libraryHeaderSize
+        || juce::ByteOrder::littleEndianInt(libraryData) != userLibraryMagic
+        || juce::ByteOrder::littleEndianShort(libraryData + 4) != userLibraryVersion)
+    {
+        unmap();
+        return false;
+    }
+
+    const auto libraryModified = libraryFile.getLastModificationTime().toMilliseconds();
+
+    auto mapIndex = [this, libraryModified]
+    {
+        indexMap = std::make_unique<juce::MemoryMappedFile>(indexFile, juce::MemoryMappedFile::readOnly);
+        const auto* data = static_cast<const uint8_t*>(indexMap->getData());
+        const auto bytes = indexMap->getSize();
+
+        if (data == nullptr || bytes < indexHeaderSize || juce::ByteOrder::littleEndianInt(data) != userIndexMagic
+            || juce::ByteOrder::littleEndianShort(data + 4) != userIndexVersion
+            || readUInt64(data + libraryBytesOffset) != libraryBytes
+            || static_cast<juce::int64>(readUInt64(data + libraryModifiedOffset)) != libraryModified)
+            return false;
+
+        const auto count = static_cast<size_t>(juce::ByteOrder::littleEndianInt(data + entryCountOffset));
+        if (indexHeaderSize + count * indexEntrySize > bytes)
+            return false;
+
+        const auto* entries = data + indexHeaderSize;
+        const auto poolBytes = bytes - indexHeaderSize - count * indexEntrySize;
+
+        // One pass over fixed-size entries so later lookups can trust the offsets.
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto* entry = entries + i * indexEntrySize;
+            const uint64_t poolEnd = uint64_t { juce::ByteOrder::littleEndianInt(entry + 4) }
+                                     + juce::ByteOrder::littleEndianInt(entry + 8)
+                                     + juce::ByteOrder::littleEndianInt(entry + 12);
+
+            if (juce::ByteOrder::littleEndianInt(entry) >= libraryBytes || poolEnd > poolBytes)
+                return false;
+        }
+
+        indexEntries = entries;
+        indexPool = entries + count * indexEntrySize;
+        numEntries = static_cast<int>(count);
+        return true;
+    };
+
+    if (mapIndex())
+        return true;
+
+    indexMap.reset();
+    if (rebuildIndex(libraryBytes, libraryModified) && mapIndex())
+        return true;
+
+    unmap();
+    return false;
+}
+
+void UserPresetLibrary::unmap() noexcept
+{
+    indexMap.reset();
+    libraryMap.reset();
+    libraryData = nullptr;
+    libraryBytes = 0;
+    indexEntries = nullptr;
+    indexPool = nullptr;
+    numEntries = 0;
+}
+
+bool UserPresetLibrary::rebuildIndex(uint64_t currentLibraryBytes, juce::int64 libraryModified)
+{
+    std::vector<uint32_t> entries;
+    juce::MemoryOutputStream pool;
+    auto walkFrom = static_cast<size_t>(libraryHeaderSize);
+    auto checksum = updateChecksum(fnvOffsetBasis, libraryData, libraryHeaderSize);
+
+    // After an append the previous index still describes a prefix of the library; keep it
+    // and only walk the new records. A library replaced by another file fails the prefix
+    // hash and is indexed from scratch.
+    {
+        const juce::MemoryMappedFile previous(indexFile, juce::MemoryMappedFile::readOnly);
+        const auto* data = static_cast<const uint8_t*>(previous.getData());
+        const auto bytes = previous.getSize();
+
+        if (data != nullptr && bytes >= indexHeaderSize && juce::ByteOrder::littleEndianInt(data) == userIndexMagic
+            && juce::ByteOrder::littleEndianShort(data + 4) == userIndexVersion)
+        {
+            const auto indexedBytes = readUInt64(data + indexedBytesOffset);
+            const auto count = static_cast<size_t>(juce::ByteOrder::littleEndianInt(data + entryCountOffset));
+            const auto entryBytes = count * indexEntrySize;
+            const auto prefixChecksum = juce::ByteOrder::littleEndianInt(data + checksumOffset);
+
+            if (indexedBytes >= libraryHeaderSize && indexedBytes <= currentLibraryBytes
+                && indexHeaderSize + entryBytes <= bytes
+                && updateChecksum(fnvOffsetBasis, libraryData, static_cast<size_t>(indexedBytes)) == prefixChecksum)
+            {
+                entries.resize(count * 4);
+                for (size_t i = 0; i < entries.size(); ++i)
+                    entries[i] = juce::ByteOrder::littleEndianInt(data + indexHeaderSize + i * sizeof(uint32_t));
+
+                pool.write(data + indexHeaderSize + entryBytes, bytes - indexHeaderSize - entryBytes);
+                walkFrom = static_cast<size_t>(indexedBytes);
+                checksum = prefixChecksum;
+            }
+        }
+    }
+
+    RecordView record;
+    while (readRecord(libraryData, libraryBytes, walkFrom, record))
+    {
+        jassert(walkFrom <= std::numeric_limits<uint32_t>::max());
+
+        const auto name = juce::String::fromUTF8(record.name, static_cast<int>(record.nameBytes));
+        const auto tags = juce::String::fromUTF8(record.tags, static_cast<int>(record.tagBytes));
+        const auto key = (name + "\n" + tags).toLowerCase();
+
+        entries.push_back(static_cast<uint32_t>(walkFrom));
+        entries.push_back(static_cast<uint32_t>(pool.getDataSize()));
+        entries.push_back(static_cast<uint32_t>(record.nameBytes));
+        entries.push_back(static_cast<uint32_t>(key.getNumBytesAsUTF8()));
+
+        pool.write(record.name, record.nameBytes);
+        pool.write(key.toRawUTF8(), key.getNumBytesAsUTF8());
+
+        checksum = updateChecksum(checksum, libraryData + walkFrom, record.recordBytes);
+        walkFrom += record.recordBytes;
+    }
+
+    // Written to a temporary file and swapped in so readers never see a half-written index.
+    juce::TemporaryFile temporary(indexFile);
+    {
+        juce::FileOutputStream out(temporary.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        out.writeInt(static_cast<int>(userIndexMagic));
+        out.writeShort(static_cast<short>(userIndexVersion));
+        out.writeShort(0);
+        out.writeInt64(static_cast<juce::int64>(currentLibraryBytes));
+        out.writeInt64(static_cast<juce::int64>(walkFrom));
+        out.writeInt64(libraryModified);
+        out.writeInt(static_cast<int>(entries.size() / 4));
+        out.writeInt(static_cast<int>(checksum));
+
+        for (const auto value : entries)
+            out.writeInt(static_cast<int>(value));
+
+        out.write(pool.getData(), pool.getDataSize());
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temporary.overwriteTargetFileWithTemporary();
+}
+
+const uint8_t* UserPresetLibrary::getEntry(int index) const noexcept
+{
+    if (index < 0 || index >= numEntries)
+        return nullptr;
+
+    return indexEntries + static_cast<size_t>(index) * indexEntrySize;
+}
+} // namespace dustbox::presets
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+  File: UserPresetLibrary.h
+  Responsibility: Declare the on-disk user preset store: an append-only packed
+                  record file plus a name/tag search index, both memory-mapped.
+  Assumptions: Opened, appended to, and queried on the message thread only.
+               Values are plain parameter values in params::ParameterIndex
+               order; only preset-stored parameters are recalled. Instances
+               in one process share a library, so they see each other's
+               appends at once; appends from other processes are seen after
+               refreshIfChanged().
+  Notes: Library layout (little-endian): magic "DBXL" u32, version u16,
+         reserved u16, then records of
+           record bytes u32 | value count u16 | name bytes u16 | tag bytes u16 |
+           reserved u16 | count x f32 | UTF-8 name | UTF-8 tags (comma
+           separated) | zero padding to a 4-byte boundary.
+         Index layout: magic "DBXI" u32, version u16, reserved u16, library
+         bytes u64, indexed library bytes u64, library modification time i64
+         (ms since the epoch), entry count u32, FNV-1a u32 over the indexed
+         library bytes, then per entry
+           record offset u32 | pool offset u32 | name bytes u32 | key bytes u32,
+         then a string pool holding each name followed by its lower-case
+         "name\ntags" search key. The index is derived data: it is rebuilt
+         whenever the library's size or modification time differs from the
+         header, incrementally when the indexed bytes still hash the same.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "../Parameters/ParameterIndex.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dustbox::presets
+{
+inline constexpr uint32_t userLibraryMagic = 0x4C584244u; // "DBXL"
+inline constexpr uint32_t userIndexMagic = 0x49584244u;   // "DBXI"
+inline constexpr uint16_t userLibraryVersion = 1;
+inline constexpr uint16_t userIndexVersion = 2;
+
+struct UserPreset
+{
+    juce::String name;
+    juce::StringArray tags;
+    params::ParameterValues values {};
+};
+
+class UserPresetLibrary
+{
+public:
+    /** Opens the library in the per-user application data folder. */
+    UserPresetLibrary();
+    explicit UserPresetLibrary(const juce::File& libraryFile);
+    ~UserPresetLibrary();
+
+    static juce::File getDefaultLibraryFile();
+    static juce::File getIndexFileFor(const juce::File& libraryFile);
+
+    const juce::File& getLibraryFile() const noexcept { return libraryFile; }
+
+    int size() const noexcept { return numEntries; }
+    juce::String getName(int index) const;
+    juce::StringArray getTags(int index) const;
+
+    /** Overwrites the preset-stored entries of values with the record's values. Entries the
+        record does not carry keep their current values. Returns false for a bad index. */
+    bool readValues(int index, params::ParameterValues& values) const noexcept;
+
+    /** Appends the indices of presets whose name or tags contain every whitespace-separated
+        term of the query, case-insensitively. Stops after maxResults when it is positive. */
+    void search(const juce::String& query, std::vector<int>& results, int maxResults = 0) const;
+
+    /** Appends the presets as new records, then extends and remaps the index. */
+    bool append(const std::vector<UserPreset>& presets);
+    bool append(const UserPreset& preset);
+
+    /** Remaps the library if its file's size or modification time moved since it was last
+        mapped, e.g. after another process appended to it. Returns true if it remapped. */
+    bool refreshIfChanged();
+
+    /** Bumped on every remap, so a cached list of names knows when to reload. */
+    uint32_t getGeneration() const noexcept { return generation; }
+
+private:
+    bool reopen();
+    void unmap() noexcept;
+    bool rebuildIndex(uint64_t libraryBytes, juce::int64 libraryModified);
+    const uint8_t* getEntry(int index) const noexcept;
+
+    juce::File libraryFile;
+    juce::File indexFile;
+
+    std::unique_ptr<juce::MemoryMappedFile> libraryMap;
+    std::unique_ptr<juce::MemoryMappedFile> indexMap;
+    const uint8_t* libraryData { nullptr };
+    size_t libraryBytes { 0 };
+    const uint8_t* indexEntries { nullptr };
+    const uint8_t* indexPool { nullptr };
+    int numEntries { 0 };
+
+    // The file as reopen() last saw it, whether or not it could be mapped.
+    juce::int64 openedFileBytes { 0 };
+    juce::int64 openedFileModified { 0 };
+    uint32_t generation { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(UserPresetLibrary)
+};
+} // namespace dustbox::presets
@@ -15,6 +15,44 @@ namespace
 {
 constexpr int groupMargin = 12;
 constexpr int groupHeaderOffset = 24;
+constexpr float clipStripHeight = 4.0f;
+constexpr float barCornerSize = 3.0f;
+
+/** Renders a static layer at the given display scale so paint() only has to blit it. */
+template <typename Painter>
+juce::Image renderCachedLayer(juce::Rectangle<int> bounds, float scale, Painter&& painter)
+{
+    if (bounds.isEmpty())
+        return {};
+
+    juce::Image image(juce::Image::ARGB,
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getWidth()) * scale)),
+                      juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getHeight()) * scale)),
+                      true);
+
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    painter(g, bounds.withZeroOrigin().toFloat());
+    return image;
+}
+
+/** Vertical strip of a meter between two level proportions, used as a repaint region. */
+juce::Rectangle<float> levelSpan(juce::Rectangle<float> meterArea, float from, float to) noexcept
+{
+    if (juce::approximatelyEqual(from, to))
+        return {};
+
+    const auto top = meterArea.getBottom() - meterArea.getHeight() * juce::jmax(from, to);
+    const auto bottom = meterArea.getBottom() - meterArea.getHeight() * juce::jmin(from, to);
+    return meterArea.withTop(top).withBottom(bottom);
+}
+
+juce::String formatTempoHeader(double bpm, const juce::String& division, double phase)
+{
+    juce::String text;
+    text << juce::String(bpm, 1) << " BPM • " << division << " • Phase " << juce::String(phase, 2);
+    return text;
+}
 }
 
 GroupContainer::GroupContainer(juce::String title)
@@ -104,79 +142,225 @@ void LabeledToggleButton::resized()
 
 void LevelMeter::setLevels(float peakProportion, float rmsProportion, bool clipFlag) noexcept
 {
-    peak = juce::jlimit(0.0f, 1.0f, peakProportion);
-    rms = juce::jlimit(0.0f, 1.0f, rmsProportion);
+    const auto newPeak = juce::jlimit(0.0f, 1.0f, peakProportion);
+    const auto newRms = juce::jlimit(0.0f, 1.0f, rmsProportion);
+
+    const auto meterArea = getMeterArea();
+    auto dirty = levelSpan(meterArea, peak, newPeak).getUnion(levelSpan(meterArea, rms, newRms));
+    if (clipFlag != clip)
+        dirty = dirty.getUnion(meterArea.withHeight(clipStripHeight));
+
+    peak = newPeak;
+    rms = newRms;
     clip = clipFlag;
-    repaint();
+
+    if (! dirty.isEmpty())
+        repaint(dirty.getSmallestIntegerContainer().expanded(1));
+}
+
+void LevelMeter::resized()
+{
+    background = {};
+}
+
+juce::Rectangle<float> LevelMeter::getMeterArea() const noexcept
+{
+    return getLocalBounds().toFloat().reduced(4.0f);
+}
+
+void LevelMeter::renderBackground(float scale)
+{
+    background = renderCachedLayer(getLocalBounds(), scale, [](juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.7f));
+        g.fillRoundedRectangle(bounds, 3.0f);
+
+        g.setColour(juce::Colours::white.withAlpha(0.5f));
+        g.drawRoundedRectangle(bounds, 3.0f, 1.0f);
+    });
+    backgroundScale = scale;
 }
 
 void LevelMeter::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds().toFloat();
-    g.setColour(juce::Colours::black.withAlpha(0.7f));
-    g.fillRoundedRectangle(bounds, 3.0f);
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || ! juce::approximatelyEqual(scale, backgroundScale))
+        renderBackground(scale);
+
+    if (background.isNull())
+        return;
+
+    g.drawImage(background, getLocalBounds().toFloat());
 
-    auto meterArea = bounds.reduced(4.0f);
+    const auto meterArea = getMeterArea();
 
     if (clip)
     {
-        juce::Rectangle<float> clipRect(meterArea.getX(), meterArea.getY(), meterArea.getWidth(), 4.0f);
         g.setColour(juce::Colours::red.withAlpha(0.8f));
-        g.fillRect(clipRect);
+        g.fillRect(meterArea.withHeight(clipStripHeight));
     }
 
-    auto peakHeight = meterArea.getHeight() * peak;
-    juce::Rectangle<float> peakRect = meterArea;
-    peakRect.removeFromTop(meterArea.getHeight() - peakHeight);
+    auto peakRect = meterArea;
+    peakRect.removeFromTop(meterArea.getHeight() * (1.0f - peak));
 
     g.setColour(juce::Colours::lightgreen);
     g.fillRect(peakRect);
 
-    auto rmsHeight = meterArea.getHeight() * rms;
-    juce::Rectangle<float> rmsRect = meterArea;
-    rmsRect.removeFromTop(meterArea.getHeight() - rmsHeight);
+    auto rmsRect = meterArea;
+    rmsRect.removeFromTop(meterArea.getHeight() * (1.0f - rms));
     rmsRect.reduce(meterArea.getWidth() * 0.35f, 0.0f);
 
     g.setColour(juce::Colours::yellow.withAlpha(0.8f));
     g.fillRect(rmsRect);
+}
 
-    g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.drawRoundedRectangle(bounds, 3.0f, 1.0f);
+HostTempoDisplay::HostTempoDisplay()
+    : headerText(formatTempoHeader(bpm, division, phase))
+{
 }
 
 void HostTempoDisplay::setTempo(double bpmValue, juce::String divisionLabel, double phaseValue) noexcept
 {
+    const auto newPhase = juce::jlimit(0.0, 1.0, phaseValue);
+    auto newHeader = formatTempoHeader(bpmValue, divisionLabel, newPhase);
+
+    juce::Rectangle<float> dirty;
+    if (newHeader != headerText)
+        dirty = getHeaderArea();
+
+    if (! juce::approximatelyEqual(newPhase, phase))
+    {
+        const auto barArea = getBarArea();
+        const auto oldEdge = barArea.getX() + barArea.getWidth() * static_cast<float>(phase);
+        const auto newEdge = barArea.getX() + barArea.getWidth() * static_cast<float>(newPhase);
+        const auto span = barArea.withLeft(juce::jmin(oldEdge, newEdge)).withRight(juce::jmax(oldEdge, newEdge));
+        dirty = dirty.getUnion(span.expanded(barCornerSize, 0.0f));
+    }
+
     bpm = bpmValue;
     division = std::move(divisionLabel);
-    phase = juce::jlimit(0.0, 1.0, phaseValue);
-    repaint();
+    phase = newPhase;
+    headerText = std::move(newHeader);
+
+    if (! dirty.isEmpty())
+        repaint(dirty.getSmallestIntegerContainer().expanded(1));
+}
+
+void HostTempoDisplay::resized()
+{
+    background = {};
+}
+
+juce::Rectangle<float> HostTempoDisplay::getHeaderArea() const noexcept
+{
+    return getLocalBounds().toFloat().reduced(6.0f).removeFromTop(20.0f);
+}
+
+juce::Rectangle<float> HostTempoDisplay::getBarArea() const noexcept
+{
+    auto textArea = getLocalBounds().toFloat().reduced(6.0f);
+    textArea.removeFromTop(20.0f);
+    return textArea.reduced(2.0f);
+}
+
+void HostTempoDisplay::renderBackground(float scale)
+{
+    const auto barArea = getBarArea();
+    background = renderCachedLayer(getLocalBounds(), scale, [barArea](juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.7f));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        g.setColour(juce::Colours::darkgrey);
+        g.fillRoundedRectangle(barArea, barCornerSize);
+    });
+    backgroundScale = scale;
 }
 
 void HostTempoDisplay::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds().toFloat();
-    g.setColour(juce::Colours::black.withAlpha(0.7f));
-    g.fillRoundedRectangle(bounds, 4.0f);
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || ! juce::approximatelyEqual(scale, backgroundScale))
+        renderBackground(scale);
 
-    g.setColour(juce::Colours::white);
-    auto textArea = bounds.reduced(6.0f);
-    auto headerArea = textArea.removeFromTop(20.0f);
+    if (background.isNull())
+        return;
 
-    juce::String text;
-    text << juce::String(bpm, 1) << " BPM • " << division << " • Phase " << juce::String(phase, 2);
-    g.drawFittedText(text, headerArea.toNearestInt(), juce::Justification::centred, 1);
+    g.drawImage(background, getLocalBounds().toFloat());
+
+    const auto clipBounds = g.getClipBounds().toFloat();
+
+    const auto headerArea = getHeaderArea();
+    if (clipBounds.intersects(headerArea))
+    {
+        g.setColour(juce::Colours::white);
+        g.drawFittedText(headerText, headerArea.toNearestInt(), juce::Justification::centred, 1);
+    }
+
+    const auto barArea = getBarArea();
+    if (clipBounds.intersects(barArea))
+    {
+        g.setColour(juce::Colours::orange);
+        g.fillRoundedRectangle(barArea.withWidth(barArea.getWidth() * static_cast<float>(phase)), barCornerSize);
 
-    auto barArea = textArea.reduced(2.0f);
-    g.setColour(juce::Colours::darkgrey);
-    g.fillRoundedRectangle(barArea, 3.0f);
+        g.setColour(juce::Colours::white.withAlpha(0.4f));
+        g.drawRoundedRectangle(barArea, barCornerSize, 1.0f);
+    }
+}
 
-    auto fillWidth = barArea.getWidth() * static_cast<float>(phase);
-    juce::Rectangle<float> fillRect = barArea.withWidth(fillWidth);
-    g.setColour(juce::Colours::orange);
-    g.fillRoundedRectangle(fillRect, 3.0f);
+ProfilerOverlay::ProfilerOverlay()
+{
+    // Purely informational; clicks go through to the controls underneath.
+    setInterceptsMouseClicks(false, false);
+}
 
-    g.setColour(juce::Colours::white.withAlpha(0.4f));
-    g.drawRoundedRectangle(barArea, 3.0f, 1.0f);
+void ProfilerOverlay::setSnapshot(const dsp::StageProfiler::Snapshot& newSnapshot)
+{
+    snapshot = newSnapshot;
+    repaint();
 }
-} // namespace dustbox::ui
 
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.8f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+    constexpr int rowHeight = 18;
+    auto area = getLocalBounds().reduced(10, 8);
+    g.setFont(juce::Font(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain)));
+
+    auto drawRow = [&](const juce::String& stage, const juce::String& mean, const juce::String& p99,
+                       const juce::String& worst, const juce::String& share)
+    {
+        auto row = area.removeFromTop(rowHeight);
+        const auto columnWidth = row.getWidth() / 6;
+        g.drawText(stage, row.removeFromLeft(2 * columnWidth), juce::Justification::centredLeft);
+        for (const auto* text : { &mean, &p99, &worst, &share })
+            g.drawText(*text, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+    };
+
+    g.setColour(juce::Colours::white.withAlpha(0.6f));
+    drawRow("stage (us/block)", "mean", "p99", "worst", "% budget");
+
+    const auto deadline = snapshot.deadlineMicros;
+    for (size_t stage = 0; stage < dsp::numProfiledStages; ++stage)
+    {
+        const auto& statistics = snapshot.stages[stage];
+        const auto share = deadline > 0.0f ? 100.0f * statistics.meanMicros / deadline : 0.0f;
+
+        // The whole-block row stands apart from the stages that make it up.
+        const auto isBlock = stage == static_cast<size_t>(dsp::ProfiledStage::block);
+        g.setColour(isBlock ? juce::Colours::orange : juce::Colours::white);
+        drawRow(dsp::profiledStageNames[stage],
+                juce::String(statistics.meanMicros, 1),
+                juce::String(statistics.p99Micros, 1),
+                juce::String(statistics.worstMicros, 1),
+                juce::String(share, 2));
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.6f));
+    g.drawText(juce::String(snapshot.numBlocks) + " blocks, deadline " + juce::String(deadline, 0) + " us",
+               area.removeFromTop(rowHeight),
+               juce::Justification::centredLeft);
+}
+} // namespace dustbox::ui
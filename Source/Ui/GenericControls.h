@@ -12,6 +12,8 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 
+#include "../Dsp/utils/StageProfiler.h"
+
 #include <array>
 
 namespace dustbox::ui
@@ -84,30 +86,66 @@ private:
     juce::ToggleButton button;
 };
 
-/** Simple peak/RMS meter with optional clip indication. */
+/** Simple peak/RMS meter with optional clip indication.
+    The frame and backdrop are cached in an image that is re-rendered on resize or
+    display scale changes; level updates only invalidate the span the bars moved across. */
 class LevelMeter : public juce::Component
 {
 public:
     void setLevels(float peakProportion, float rmsProportion, bool clipFlag) noexcept;
     void paint(juce::Graphics& g) override;
+    void resized() override;
 
 private:
+    juce::Rectangle<float> getMeterArea() const noexcept;
+    void renderBackground(float scale);
+
     float peak { 0.0f };
     float rms { 0.0f };
     bool clip { false };
+
+    juce::Image background;
+    float backgroundScale { 0.0f };
 };
 
-/** Displays BPM, sync division, and phase with a tiny progress indicator. */
+/** Displays BPM, sync division, and phase with a tiny progress indicator.
+    The panel and progress trough are cached; repaints are limited to the header text
+    when it changes and to the slice of the bar the phase moved across. */
 class HostTempoDisplay : public juce::Component
 {
 public:
+    HostTempoDisplay();
+
     void setTempo(double bpmValue, juce::String divisionLabel, double phaseValue) noexcept;
     void paint(juce::Graphics& g) override;
+    void resized() override;
 
 private:
+    juce::Rectangle<float> getHeaderArea() const noexcept;
+    juce::Rectangle<float> getBarArea() const noexcept;
+    void renderBackground(float scale);
+
     double bpm { 120.0 };
     juce::String division { "1/4" };
     double phase { 0.0 };
+    juce::String headerText;
+
+    juce::Image background;
+    float backgroundScale { 0.0f };
+};
+
+/** Table of per-stage processBlock timings (mean, p99 and worst microseconds per block, and the
+    mean as a share of the block's deadline), drawn over the editor while profiling is on. */
+class ProfilerOverlay : public juce::Component
+{
+public:
+    ProfilerOverlay();
+
+    void setSnapshot(const dsp::StageProfiler::Snapshot& newSnapshot);
+    void paint(juce::Graphics& g) override;
+
+private:
+    dsp::StageProfiler::Snapshot snapshot;
 };
 } // namespace dustbox::ui
 